@@ -0,0 +1,145 @@
+#pragma once
+
+#include "AicColours.h"
+#include "LevelMeter.h"
+
+#include <juce_graphics/juce_graphics.h>
+#include <juce_gui_basics/juce_gui_basics.h>
+
+namespace aic::ui
+{
+
+/**
+ * @brief Input and output level bars with the amount of level the enhancement removes.
+ *
+ * Bars show the RMS level with a tick at the peak level, on a scale from -60 dBFS to 0 dBFS.
+ * Only the bars or the text that changed are repainted, and the texts are prepared outside of
+ * paint().
+ */
+class AicLevelMeter : public juce::Component
+{
+  public:
+    AicLevelMeter() = default;
+
+    /**
+     * @brief Sets the levels to display, repaints only if the display changes.
+     */
+    void setLevels(const aic::dsp::LevelMeter::Levels& input,
+                   const aic::dsp::LevelMeter::Levels& output)
+    {
+        Display display{toDecibels(input.peak), toDecibels(input.rms), toDecibels(output.peak),
+                        toDecibels(output.rms)};
+
+        if (display.isCloseTo(m_display))
+            return;
+
+        m_display = display;
+        repaint(getBarsArea());
+
+        // Equal levels while nothing is processed, only a difference is worth showing
+        auto reduction = m_display.inputRms - m_display.outputRms;
+        auto text      = m_display.inputRms <= minDecibels
+                             ? juce::String("-")
+                             : juce::String(reduction, 1) + " dB reduction";
+
+        if (text != m_reductionText)
+        {
+            m_reductionText = text;
+            repaint(getHeaderArea());
+        }
+    }
+
+    void paint(juce::Graphics& g) override
+    {
+        auto bounds = getLocalBounds().toFloat();
+
+        auto header = bounds.removeFromTop(headerHeight);
+        g.setColour(aic::ui::BLACK_70);
+        g.setFont(16.f);
+        g.drawText(m_title, header, juce::Justification::centredLeft);
+
+        g.setFont(14.f);
+        g.drawText(m_reductionText, header, juce::Justification::centredRight);
+
+        bounds.removeFromTop(spacing);
+        drawBar(g, bounds.removeFromTop(barHeight), m_inputLabel, m_display.inputRms,
+                m_display.inputPeak, aic::ui::BLACK_40);
+
+        bounds.removeFromTop(spacing);
+        drawBar(g, bounds.removeFromTop(barHeight), m_outputLabel, m_display.outputRms,
+                m_display.outputPeak, aic::ui::BLUE_50);
+    }
+
+  private:
+    static constexpr float minDecibels  = -60.0f;
+    static constexpr float headerHeight = 20.0f;
+    static constexpr float barHeight    = 10.0f;
+    static constexpr float spacing      = 8.0f;
+
+    struct Display
+    {
+        float inputPeak{minDecibels};
+        float inputRms{minDecibels};
+        float outputPeak{minDecibels};
+        float outputRms{minDecibels};
+
+        bool isCloseTo(const Display& other) const
+        {
+            // Finer steps are not visible on the bars nor in the text
+            constexpr float tolerance = 0.05f;
+            return std::abs(inputPeak - other.inputPeak) < tolerance &&
+                   std::abs(inputRms - other.inputRms) < tolerance &&
+                   std::abs(outputPeak - other.outputPeak) < tolerance &&
+                   std::abs(outputRms - other.outputRms) < tolerance;
+        }
+    };
+
+    static float toDecibels(float gain)
+    {
+        return juce::Decibels::gainToDecibels(gain, minDecibels);
+    }
+
+    juce::Rectangle<int> getHeaderArea() const
+    {
+        return getLocalBounds().withHeight(static_cast<int>(headerHeight));
+    }
+
+    juce::Rectangle<int> getBarsArea() const
+    {
+        return getLocalBounds().withTrimmedTop(static_cast<int>(headerHeight));
+    }
+
+    static void drawBar(juce::Graphics& g, juce::Rectangle<float> area, const juce::String& label,
+                        float rmsDecibels, float peakDecibels, juce::Colour colour)
+    {
+        g.setColour(aic::ui::BLACK_70);
+        g.setFont(14.f);
+        g.drawText(label, area.removeFromLeft(36.f), juce::Justification::centredLeft);
+
+        g.setColour(aic::ui::BLACK_15);
+        g.fillRoundedRectangle(area, 3.f);
+
+        auto toWidth = [&area](float decibels)
+        { return juce::jmap(decibels, minDecibels, 0.0f, 0.0f, area.getWidth()); };
+
+        g.setColour(colour);
+        g.fillRoundedRectangle(area.withWidth(toWidth(rmsDecibels)), 3.f);
+
+        if (peakDecibels > minDecibels)
+        {
+            g.setColour(aic::ui::BLACK_70);
+            g.fillRect(area.withX(area.getX() + toWidth(peakDecibels) - 1.f).withWidth(2.f));
+        }
+    }
+
+    Display m_display;
+
+    const juce::String m_title{"Levels"};
+    const juce::String m_inputLabel{"In"};
+    const juce::String m_outputLabel{"Out"};
+    juce::String       m_reductionText{"-"};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AicLevelMeter)
+};
+
+} // namespace aic::ui
@@ -2,6 +2,7 @@
 
 #include "AicColours.h"
 
+#include <array>
 #include <juce_graphics/juce_graphics.h>
 #include <juce_gui_basics/juce_gui_basics.h>
 
@@ -23,6 +24,8 @@ struct ModelInfo
     std::string modelDelay;
     std::string optimalNumFrames;
     std::string outputDelay;
+    std::string memoryUsage;
+    std::string endToEndLatency; // Only known in the standalone app
     ModelState  modelState;
 
     // Constructor for easy initialization
@@ -30,28 +33,93 @@ struct ModelInfo
 
     ModelInfo(const ModelState state) : modelState(state) {}
 
-    ModelInfo(const int sr, const int w, const int md, const int nf, const int od)
+    ModelInfo(const int sr, const int w, const int md, const int nf, const int od,
+              const std::int64_t memoryBytes)
         : optimalSampleRate(std::to_string(sr) + " Hz"), windowLength(std::to_string(w) + " ms"),
           modelDelay(std::to_string(md) + " ms"), optimalNumFrames(std::to_string(nf)),
-          outputDelay(std::to_string(od) + " ms")
+          outputDelay(std::to_string(od) + " ms"), memoryUsage(formatMegabytes(memoryBytes))
     {
         modelState = ModelState::Initilized;
     }
+
+    static std::string formatMegabytes(const std::int64_t bytes)
+    {
+        if (bytes < 0)
+            return "n/a";
+
+        return juce::String(static_cast<double>(bytes) / (1024.0 * 1024.0), 1).toStdString() +
+               " MB";
+    }
+
+    static std::string formatMilliseconds(const double ms)
+    {
+        if (ms < 0.0)
+            return "n/a";
+
+        return juce::String(ms, 1).toStdString() + " ms";
+    }
 };
 
+/**
+ * @brief Shows the properties of the loaded model, or why there is none.
+ *
+ * The texts are prepared when the info changes and the box is buffered to an image, so painting
+ * allocates nothing and the box is only drawn again when the info changes.
+ */
 class AicModelInfoBox : public juce::Component
 
 {
   public:
-    AicModelInfoBox() {}
+    AicModelInfoBox()
+    {
+        setBufferedToImage(true);
+    }
 
     // Method to update model information
     void setModelInfo(const ModelInfo& info)
     {
         modelInfo = info;
+
+        m_lines[0].value = modelInfo.optimalSampleRate;
+        m_lines[1].value = modelInfo.optimalNumFrames;
+        m_lines[2].value = modelInfo.windowLength;
+        m_lines[3].value = modelInfo.modelDelay;
+        m_lines[4].value = modelInfo.outputDelay;
+        m_lines[5].value = modelInfo.memoryUsage;
+        m_lines[6].value = modelInfo.endToEndLatency;
+
+        switch (modelInfo.modelState)
+        {
+        case Initilized:
+            m_message = {};
+            m_detail  = {};
+            break;
+        case WrongAudioSettings:
+            m_message = "Unsupported audio settings...";
+            m_detail  = {};
+            break;
+        case LicenseInactive:
+            m_message = "No license found, open the dialog at the top right...";
+            m_detail  = {};
+            break;
+        case ProcessingNotAllowed:
+            m_message = "Processing not allowed.";
+            m_detail  = "Check your license and internet connection.";
+            break;
+        }
+
         repaint(); // Trigger a repaint to show updated info
     }
 
+    /**
+     * @brief Adds the latency from the microphone to the speakers as the last line.
+     */
+    void setShowsEndToEndLatency(bool shows)
+    {
+        m_numLines = shows ? m_lines.size() : m_lines.size() - 1;
+        repaint();
+    }
+
     // Getter for current model info
     const ModelInfo& getModelInfo() const
     {
@@ -68,61 +136,51 @@ class AicModelInfoBox : public juce::Component
 
         g.setColour(aic::ui::BLACK_100);
 
-        switch (modelInfo.modelState)
-        {
-        case Initilized:
-        {
-            // Create a vector of label-value pairs for easy iteration
-            std::vector<std::pair<std::string, std::string>> infoLines = {
-                {"Optimal Sample Rate", modelInfo.optimalSampleRate},
-                {"Optimal Num Frames", modelInfo.optimalNumFrames},
-                {"Window Length", modelInfo.windowLength},
-                {"Model Delay", modelInfo.modelDelay},
-                {"Total Output Delay", modelInfo.outputDelay}};
-
-            // Draw each line
-            for (size_t i = 0; i < infoLines.size(); ++i)
-            {
-                auto line = bounds.removeFromTop(24);
-                g.setFont(14.f);
-                g.drawText(infoLines[i].first, line, juce::Justification::centredLeft);
-                g.setFont(16.f);
-                g.drawText(infoLines[i].second, line, juce::Justification::centredRight);
-
-                // Add spacing between lines (except after the last line)
-                if (i < infoLines.size() - 1)
-                    bounds.removeFromTop(6);
-            }
-            break;
-        }
-        case WrongAudioSettings:
+        if (modelInfo.modelState != Initilized)
         {
             g.setFont(16.f);
-            g.drawText("Unsupported audio settings...", bounds, juce::Justification::centred);
-        }
-        break;
-        case LicenseInactive:
-        {
-            g.setFont(16.f);
-            g.drawText("No license found, open the dialog at the top right...", bounds,
-                       juce::Justification::centred);
+            g.drawText(m_message, bounds, juce::Justification::centred);
+            bounds.removeFromTop(30);
+            g.drawText(m_detail, bounds, juce::Justification::centred);
+            return;
         }
-        break;
-        case ProcessingNotAllowed:
+
+        // Draw each line
+        for (size_t i = 0; i < m_numLines; ++i)
         {
+            auto line = bounds.removeFromTop(24);
+            g.setFont(14.f);
+            g.drawText(m_lines[i].label, line, juce::Justification::centredLeft);
             g.setFont(16.f);
-            g.drawText("Processing not allowed.", bounds, juce::Justification::centred);
-            bounds.removeFromTop(30);
-            g.drawText("Check your license and internet connection.", bounds,
-                       juce::Justification::centred);
-        }
+            g.drawText(m_lines[i].value, line, juce::Justification::centredRight);
+
+            // Add spacing between lines (except after the last line)
+            if (i < m_numLines - 1)
+                bounds.removeFromTop(6);
         }
     }
 
     void setLicenseInvalid();
 
   private:
+    struct Line
+    {
+        juce::String label;
+        juce::String value;
+    };
+
     ModelInfo modelInfo;
     bool      licenseInvalid;
+
+    std::array<Line, 7> m_lines{{{"Optimal Sample Rate", {}},
+                                 {"Optimal Num Frames", {}},
+                                 {"Window Length", {}},
+                                 {"Model Delay", {}},
+                                 {"Total Output Delay", {}},
+                                 {"Memory Usage", {}},
+                                 {"End-to-End Latency", {}}}};
+    size_t              m_numLines{m_lines.size() - 1};
+    juce::String        m_message;
+    juce::String        m_detail;
 };
 } // namespace aic::ui
@@ -21,7 +21,7 @@ class ModelSelectorLnF : public juce::LookAndFeel_V4
         g.setColour(aic::ui::BLACK_20);
         g.drawRoundedRectangle(boxBounds.toFloat().reduced(0.5f, 0.5f), cornerSize, 1.0f);
 
-        juce::Rectangle<int> arrowZone(width - 28, 18, 8, 4);
+        juce::Rectangle<int> arrowZone(width - 28, (height - 4) / 2, 8, 4);
         juce::Path           path;
         path.startNewSubPath((float) arrowZone.getX(), (float) arrowZone.getY());
         path.lineTo((float) arrowZone.getCentreX(), (float) arrowZone.getBottom());
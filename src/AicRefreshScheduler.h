@@ -0,0 +1,175 @@
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <juce_gui_basics/juce_gui_basics.h>
+#include <memory>
+#include <vector>
+
+namespace aic::ui
+{
+
+/**
+ * @brief Refreshes all open editors of the process in one pass, aligned to the display refresh.
+ *
+ * A single vertical blank callback, attached to one of the showing editors, drives every editor
+ * instead of one timer per editor. Editors that are not showing are skipped. A slow timer takes
+ * over if the driving editor stops receiving vertical blanks, for example while its window is
+ * minimised.
+ */
+class AicRefreshScheduler : private juce::AsyncUpdater, private juce::Timer
+{
+  public:
+    /**
+     * @brief Refreshes a component while it exists, shared scheduler for all instances.
+     */
+    class Registration
+    {
+      public:
+        /**
+         * @param callback Polls the telemetry and repaints what changed. Only called while the
+         * component is showing.
+         */
+        Registration(juce::Component& component, std::function<void()> callback)
+            : m_component(component), m_callback(std::move(callback))
+        {
+            m_scheduler->add(this);
+        }
+
+        ~Registration()
+        {
+            m_scheduler->remove(this);
+        }
+
+      private:
+        friend class AicRefreshScheduler;
+
+        juce::SharedResourcePointer<AicRefreshScheduler> m_scheduler;
+        juce::Component&                                 m_component;
+        std::function<void()>                            m_callback;
+
+        JUCE_DECLARE_NON_COPYABLE(Registration)
+    };
+
+    AicRefreshScheduler() = default;
+
+    ~AicRefreshScheduler() override
+    {
+        cancelPendingUpdate();
+    }
+
+  private:
+    static constexpr double refreshRateHz      = 30.0;
+    static constexpr int    fallbackIntervalMs = 250;
+
+    void add(Registration* registration)
+    {
+        m_registrations.push_back(registration);
+        updateDriver();
+
+        if (!isTimerRunning())
+            startTimer(fallbackIntervalMs);
+    }
+
+    void remove(Registration* registration)
+    {
+        m_registrations.erase(
+            std::remove(m_registrations.begin(), m_registrations.end(), registration),
+            m_registrations.end());
+
+        if (m_driver == &registration->m_component)
+            updateDriver();
+
+        if (m_registrations.empty())
+            stopTimer();
+    }
+
+    /**
+     * @brief Attaches the vertical blank callback to a showing component, if there is one.
+     */
+    void updateDriver()
+    {
+        juce::Component* driver = nullptr;
+
+        for (auto* registration : m_registrations)
+        {
+            if (registration->m_component.isShowing())
+            {
+                driver = &registration->m_component;
+                break;
+            }
+        }
+
+        if (driver == nullptr && !m_registrations.empty())
+            driver = &m_registrations.front()->m_component;
+
+        if (driver == m_driver)
+            return;
+
+        m_vBlank.reset();
+        m_driver = driver;
+
+        if (m_driver != nullptr)
+            m_vBlank = std::make_unique<juce::VBlankAttachment>(
+                m_driver, [this](double timestampSec) { onVBlank(timestampSec); });
+    }
+
+    void onVBlank(double timestampSec)
+    {
+        m_lastVBlankMs = juce::Time::getMillisecondCounterHiRes();
+
+        // Displays refresh at 60 Hz and faster, the telemetry does not need more than this. A
+        // new driver on another display may count from a different origin.
+        auto elapsed = timestampSec - m_lastRefreshSec;
+        if (elapsed >= 0.0 && elapsed < 0.9 / refreshRateHz)
+            return;
+
+        m_lastRefreshSec = timestampSec;
+        refreshAll();
+
+        // Cannot be replaced from within its own callback
+        if (m_driver != nullptr && !m_driver->isShowing())
+            triggerAsyncUpdate();
+    }
+
+    void refreshAll()
+    {
+        // A callback may open or close an editor, iterate over a copy
+        m_refreshing = m_registrations;
+
+        for (auto* registration : m_refreshing)
+        {
+            auto isRegistered = std::find(m_registrations.begin(), m_registrations.end(),
+                                          registration) != m_registrations.end();
+
+            if (isRegistered && registration->m_component.isShowing())
+                registration->m_callback();
+        }
+    }
+
+    void handleAsyncUpdate() override
+    {
+        updateDriver();
+    }
+
+    void timerCallback() override
+    {
+        if (juce::Time::getMillisecondCounterHiRes() - m_lastVBlankMs < fallbackIntervalMs)
+            return;
+
+        // No vertical blanks, keep the editors going at a low rate and look for a new driver
+        refreshAll();
+        updateDriver();
+    }
+
+    std::vector<Registration*>              m_registrations;
+    std::vector<Registration*>              m_refreshing;
+    juce::Component*                        m_driver{nullptr};
+    std::unique_ptr<juce::VBlankAttachment> m_vBlank;
+    double                                  m_lastRefreshSec{0.0};
+    double                                  m_lastVBlankMs{0.0};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AicRefreshScheduler)
+};
+
+} // namespace aic::ui
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "AicColours.h"
+#include "SpectrumAnalyzer.h"
+
+#include <juce_graphics/juce_graphics.h>
+#include <juce_gui_basics/juce_gui_basics.h>
+
+namespace aic::ui
+{
+
+/**
+ * @brief Shows the spectrum image rendered by the analyzer of the processor.
+ *
+ * The analysis runs while the view exists, closing the editor stops it.
+ */
+class AicSpectrumView : public juce::Component
+{
+  public:
+    explicit AicSpectrumView(aic::SpectrumAnalyzer& analyzer) : m_analyzer(analyzer)
+    {
+        m_analyzer.setActive(true);
+    }
+
+    ~AicSpectrumView() override
+    {
+        m_analyzer.setActive(false);
+    }
+
+    /**
+     * @brief Repaints if the analyzer rendered a new image, called at display rate.
+     */
+    void refresh()
+    {
+        if (m_analyzer.hasNewImage())
+            repaint();
+    }
+
+    void paint(juce::Graphics& g) override
+    {
+        auto bounds = getLocalBounds().toFloat();
+
+        g.setColour(aic::ui::BLACK_15);
+        g.drawRoundedRectangle(bounds.reduced(0.5f), 8.f, 1.f);
+
+        m_analyzer.drawImage(g, bounds.reduced(4.f));
+    }
+
+    void resized() override
+    {
+        // Rendered in physical pixels, so the image is not scaled up on high density displays
+        auto scale  = juce::Component::getApproximateScaleFactorForComponent(this);
+        auto bounds = getLocalBounds().reduced(4);
+        m_analyzer.setImageSize(juce::roundToInt(static_cast<float>(bounds.getWidth()) * scale),
+                                juce::roundToInt(static_cast<float>(bounds.getHeight()) * scale));
+    }
+
+  private:
+    aic::SpectrumAnalyzer& m_analyzer;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AicSpectrumView)
+};
+
+} // namespace aic::ui
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "AicColours.h"
+#include "VadEvents.h"
+
+#include <deque>
+#include <juce_graphics/juce_graphics.h>
+#include <juce_gui_basics/juce_gui_basics.h>
+#include <vector>
+
+namespace aic::ui
+{
+
+/**
+ * @brief Scrolling strip of the recent VAD results, with the current result as an indicator on
+ * the right.
+ *
+ * Fed with the events of the audio thread, so short speech bursts between two UI updates are
+ * still shown. Only this component is repainted when the timeline moves.
+ */
+class AicVadTimeline : public juce::Component
+{
+  public:
+    AicVadTimeline() = default;
+
+    /**
+     * @brief Adds the new events and scrolls the timeline to the given stream position.
+     */
+    void update(const std::vector<aic::vad::Event>& events, std::int64_t position,
+                double sampleRate)
+    {
+        // The processor was prepared or reset, positions start over
+        if (position < m_position)
+            m_events.clear();
+
+        if (events.empty() && position == m_position && sampleRate == m_sampleRate)
+            return;
+
+        m_events.insert(m_events.end(), events.begin(), events.end());
+        m_position   = position;
+        m_sampleRate = sampleRate;
+
+        // Keep the last event left of the window, it holds the state at the left edge
+        auto windowStart = m_position - getWindowSamples();
+        while (m_events.size() > 1 && m_events[1].samplePosition <= windowStart)
+            m_events.pop_front();
+
+        repaint();
+    }
+
+    bool isSpeechDetected() const
+    {
+        return !m_events.empty() && m_events.back().speech;
+    }
+
+    void paint(juce::Graphics& g) override
+    {
+        auto bounds = getLocalBounds().toFloat();
+
+        // Indicator of the current result, on the right
+        auto indicator = bounds.removeFromRight(bounds.getHeight());
+        bounds.removeFromRight(8.f);
+
+        g.setColour(isSpeechDetected() ? aic::ui::ROSA_SHADE : aic::ui::BLACK_20);
+        g.fillEllipse(indicator);
+        g.setColour(isSpeechDetected() ? aic::ui::ROSA_TINT : aic::ui::BLACK_0);
+        g.fillEllipse(indicator.reduced(3.f));
+
+        // Timeline, the newest audio on the right
+        auto strip = bounds.withSizeKeepingCentre(bounds.getWidth(), 8.f);
+        g.setColour(aic::ui::BLACK_15);
+        g.fillRoundedRectangle(strip, 4.f);
+
+        const auto windowSamples = static_cast<double>(getWindowSamples());
+        auto       toX           = [&](std::int64_t samplePosition)
+        {
+            auto age = static_cast<double>(m_position - samplePosition);
+            return strip.getRight() - static_cast<float>(age / windowSamples) * strip.getWidth();
+        };
+
+        g.setColour(aic::ui::ROSA_SHADE);
+        for (size_t i = 0; i < m_events.size(); ++i)
+        {
+            if (!m_events[i].speech)
+                continue;
+
+            auto end   = i + 1 < m_events.size() ? m_events[i + 1].samplePosition : m_position;
+            auto left  = juce::jmax(strip.getX(), toX(m_events[i].samplePosition));
+            auto right = juce::jmin(strip.getRight(), toX(end));
+
+            // Scrolled out of the window
+            if (right < left)
+                continue;
+
+            // At least a pixel, bursts shorter than a pixel column stay visible
+            g.fillRect(strip.withLeft(left).withRight(juce::jmax(right, left + 1.f)));
+        }
+    }
+
+  private:
+    std::int64_t getWindowSamples() const
+    {
+        return juce::jmax(static_cast<std::int64_t>(1),
+                          static_cast<std::int64_t>(m_sampleRate * historySeconds));
+    }
+
+    static constexpr double historySeconds = 5.0;
+
+    std::deque<aic::vad::Event> m_events;
+    std::int64_t                m_position{0};
+    double                      m_sampleRate{48000.0};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AicVadTimeline)
+};
+
+} // namespace aic::ui
@@ -0,0 +1,219 @@
+#include "AnticipativeRenderer.h"
+
+namespace aic::dsp
+{
+
+AnticipativeRenderer::AnticipativeRenderer(RenderCallback callback)
+    : juce::Thread("aic anticipative renderer"), m_render(std::move(callback))
+{
+}
+
+AnticipativeRenderer::~AnticipativeRenderer()
+{
+    release();
+}
+
+void AnticipativeRenderer::prepare(int numChannels, int maxBlockSize, int lookaheadSamples)
+{
+    release();
+
+    m_numChannels  = numChannels;
+    m_maxBlockSize = juce::jmax(1, maxBlockSize);
+    m_lookahead    = juce::jmax(0, lookaheadSamples);
+
+    // The worker may fall behind by the lookahead plus a block before it resynchronises,
+    // the remaining blocks keep the audio thread from overwriting input it is still reading.
+    m_ringSize = m_lookahead + 4 * m_maxBlockSize;
+
+    m_dryRing.setSize(numChannels, m_ringSize);
+    m_wetRing.setSize(numChannels, m_ringSize);
+    m_workerBuffer.setSize(numChannels, m_maxBlockSize);
+    m_workerBuffer.clear();
+
+    m_mode = Mode::Live;
+    reset();
+    m_underruns.store(0);
+
+    startThread(juce::Thread::Priority::high);
+}
+
+void AnticipativeRenderer::release()
+{
+    stopThread(1000);
+    m_mode = Mode::Live;
+    m_workerBusy.store(false);
+    m_workerPolling.store(false);
+}
+
+void AnticipativeRenderer::reset()
+{
+    jassert(isIdle());
+
+    // Also touches the pages of freshly allocated rings before the audio thread uses them
+    m_dryRing.clear();
+    m_wetRing.clear();
+
+    // Everything before the first block reads as silence from the cleared dry ring
+    m_position = m_lookahead;
+    m_inputEnd.store(m_position);
+    m_wetStart.store(m_position);
+    m_wetEnd.store(m_position);
+}
+
+void AnticipativeRenderer::process(float* const* channels, int numChannels, int numSamples,
+                                   bool anticipate)
+{
+    std::array<float*, 2> chunk{};
+    jassert(numChannels <= static_cast<int>(chunk.size()));
+
+    // Hosts may exceed the block size announced in prepareToPlay
+    for (int start = 0; start < numSamples; start += m_maxBlockSize)
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+            chunk[static_cast<size_t>(ch)] = channels[ch] + start;
+
+        processChunk(chunk.data(), numChannels, juce::jmin(m_maxBlockSize, numSamples - start),
+                     anticipate);
+    }
+}
+
+void AnticipativeRenderer::processChunk(float* const* channels, int numChannels, int numSamples,
+                                        bool anticipate)
+{
+    const auto position = m_position;
+
+    if (m_mode == Mode::Handover && isWorkerIdle())
+    {
+        m_mode = Mode::Live;
+        m_workerPolling.store(false);
+    }
+
+    if (m_mode == Mode::Live && anticipate)
+    {
+        // Samples that were not processed before the switch stay unprocessed
+        if (m_wetEnd.load() != position)
+        {
+            m_wetStart.store(position);
+            m_wetEnd.store(position);
+        }
+        m_inputEnd.store(position);
+        m_mode = Mode::Anticipating;
+
+        // Only signalled on transport start, the worker polls while anticipating
+        m_workerPolling.store(true);
+        notify();
+    }
+    else if (m_mode == Mode::Anticipating && !anticipate)
+    {
+        m_mode = Mode::Handover;
+    }
+
+    copyToRing(m_dryRing, position, channels, numChannels, numSamples);
+
+    if (m_mode == Mode::Live)
+    {
+        m_render(channels, numChannels, numSamples);
+        copyToRing(m_wetRing, position, channels, numChannels, numSamples);
+
+        if (m_wetEnd.load() != position)
+            m_wetStart.store(position);
+        m_wetEnd.store(position + numSamples);
+    }
+    else if (m_mode == Mode::Anticipating)
+    {
+        m_inputEnd.store(position + numSamples);
+    }
+
+    // Read the delayed output, the processed range only grows while we read it
+    const auto readStart = position - m_lookahead;
+    const auto readEnd   = readStart + numSamples;
+    const auto wetFrom   = juce::jlimit(readStart, readEnd, m_wetStart.load());
+    const auto wetTo     = juce::jlimit(wetFrom, readEnd, m_wetEnd.load());
+
+    const auto numDryHead = static_cast<int>(wetFrom - readStart);
+    const auto numWet     = static_cast<int>(wetTo - wetFrom);
+    const auto numDryTail = static_cast<int>(readEnd - wetTo);
+
+    copyFromRing(m_dryRing, readStart, channels, 0, numChannels, numDryHead);
+    copyFromRing(m_wetRing, wetFrom, channels, numDryHead, numChannels, numWet);
+    copyFromRing(m_dryRing, wetTo, channels, numDryHead + numWet, numChannels, numDryTail);
+
+    if (m_mode == Mode::Anticipating && numDryTail > 0)
+        m_underruns.fetch_add(1);
+
+    m_position = position + numSamples;
+}
+
+bool AnticipativeRenderer::isWorkerIdle() const
+{
+    return !m_workerBusy.load() && m_wetEnd.load() >= m_inputEnd.load();
+}
+
+void AnticipativeRenderer::run()
+{
+    while (!threadShouldExit())
+    {
+        m_workerBusy.store(true);
+
+        const auto inputEnd = m_inputEnd.load();
+        auto       start    = m_wetEnd.load();
+
+        if (start >= inputEnd)
+        {
+            m_workerBusy.store(false);
+            wait(m_workerPolling.load() ? 1 : -1);
+            continue;
+        }
+
+        // Too late for the audio thread, skip ahead to a position it has not read yet
+        if (inputEnd - start > m_lookahead + m_maxBlockSize)
+            start = inputEnd - m_lookahead - m_maxBlockSize;
+
+        const auto numSamples = static_cast<int>(
+            juce::jmin(static_cast<juce::int64>(m_maxBlockSize), inputEnd - start));
+
+        auto channels = m_workerBuffer.getArrayOfWritePointers();
+        copyFromRing(m_dryRing, start, channels, 0, m_numChannels, numSamples);
+        m_render(channels, m_numChannels, numSamples);
+        copyToRing(m_wetRing, start, channels, m_numChannels, numSamples);
+
+        m_wetEnd.store(start + numSamples);
+        m_workerBusy.store(false);
+    }
+}
+
+void AnticipativeRenderer::copyToRing(juce::AudioBuffer<float>& ring, juce::int64 position,
+                                      const float* const* src, int numChannels, int numSamples)
+{
+    const auto offset = static_cast<int>(position % m_ringSize);
+    const auto first  = juce::jmin(numSamples, m_ringSize - offset);
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        ring.copyFrom(ch, offset, src[ch], first);
+        if (first < numSamples)
+            ring.copyFrom(ch, 0, src[ch] + first, numSamples - first);
+    }
+}
+
+void AnticipativeRenderer::copyFromRing(const juce::AudioBuffer<float>& ring, juce::int64 position,
+                                        float* const* dst, int dstOffset, int numChannels,
+                                        int numSamples) const
+{
+    if (numSamples <= 0)
+        return;
+
+    const auto offset = static_cast<int>(position % m_ringSize);
+    const auto first  = juce::jmin(numSamples, m_ringSize - offset);
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        juce::FloatVectorOperations::copy(dst[ch] + dstOffset, ring.getReadPointer(ch, offset),
+                                          first);
+        if (first < numSamples)
+            juce::FloatVectorOperations::copy(dst[ch] + dstOffset + first, ring.getReadPointer(ch),
+                                              numSamples - first);
+    }
+}
+
+} // namespace aic::dsp
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_core/juce_core.h>
+
+namespace aic::dsp
+{
+
+/**
+ * @brief Moves model processing off the audio thread during timeline playback.
+ *
+ * The renderer delays the output by a fixed lookahead. While the host is playing back the
+ * timeline, the audio thread only copies the input into a ring and the enhanced audio out of
+ * another ring, the model runs on a background thread and has the whole lookahead as deadline.
+ * For live input the model runs inline on the audio thread and the lookahead is a plain delay,
+ * so the latency reported to the host never changes.
+ *
+ * When anticipation stops (seek, loop, stop, recording), the background thread finishes the
+ * input it already received and hands the model back to the audio thread. Samples that were
+ * never processed are output unprocessed. Only one thread uses the render callback at a time.
+ */
+class AnticipativeRenderer : private juce::Thread
+{
+  public:
+    using RenderCallback =
+        std::function<void(float* const* channels, int numChannels, int numSamples)>;
+
+    explicit AnticipativeRenderer(RenderCallback callback);
+    ~AnticipativeRenderer() override;
+
+    /**
+     * @brief Allocates the rings and starts the background thread. Not real-time safe.
+     *
+     * @param numChannels Number of channels to process
+     * @param maxBlockSize Maximum number of samples passed to the render callback at once
+     * @param lookaheadSamples Fixed delay of the output, this is the background deadline
+     */
+    void prepare(int numChannels, int maxBlockSize, int lookaheadSamples);
+
+    /**
+     * @brief Stops the background thread. Not real-time safe.
+     */
+    void release();
+
+    /**
+     * @brief Clears the rings. Must only be called while isIdle() returns true.
+     */
+    void reset();
+
+    /**
+     * @brief Processes a block on the audio thread.
+     *
+     * @param anticipate Whether the background thread may render ahead for this block
+     */
+    void process(float* const* channels, int numChannels, int numSamples, bool anticipate);
+
+    /**
+     * @brief Whether the audio thread currently owns the render callback.
+     *
+     * State the render callback depends on must only be changed while this returns true.
+     */
+    bool isIdle() const
+    {
+        return m_mode == Mode::Live;
+    }
+
+    bool isAnticipating() const
+    {
+        return m_mode == Mode::Anticipating;
+    }
+
+    int getLatencySamples() const
+    {
+        return m_lookahead;
+    }
+
+    /**
+     * @brief Number of blocks in which the background thread missed its deadline.
+     */
+    int getNumUnderruns() const
+    {
+        return m_underruns.load();
+    }
+
+  private:
+    enum class Mode
+    {
+        Live,
+        Anticipating,
+        Handover
+    };
+
+    void run() override;
+
+    void processChunk(float* const* channels, int numChannels, int numSamples, bool anticipate);
+
+    bool isWorkerIdle() const;
+
+    void copyToRing(juce::AudioBuffer<float>& ring, juce::int64 position, const float* const* src,
+                    int numChannels, int numSamples);
+    void copyFromRing(const juce::AudioBuffer<float>& ring, juce::int64 position, float* const* dst,
+                      int dstOffset, int numChannels, int numSamples) const;
+
+    RenderCallback m_render;
+
+    juce::AudioBuffer<float> m_dryRing;
+    juce::AudioBuffer<float> m_wetRing;
+    juce::AudioBuffer<float> m_workerBuffer;
+
+    int m_numChannels{0};
+    int m_maxBlockSize{0};
+    int m_lookahead{0};
+    int m_ringSize{0};
+
+    // audio thread state
+    Mode        m_mode{Mode::Live};
+    juce::int64 m_position{0};
+
+    // [m_wetStart, m_wetEnd) holds processed samples, positions are absolute sample counts.
+    // m_wetStart is only written by the audio thread while the worker is idle.
+    std::atomic<juce::int64> m_wetStart{0};
+    std::atomic<juce::int64> m_wetEnd{0};
+    std::atomic<juce::int64> m_inputEnd{0};
+    std::atomic<bool>        m_workerBusy{false};
+    std::atomic<bool>        m_workerPolling{false};
+    std::atomic<int>         m_underruns{0};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AnticipativeRenderer)
+};
+
+} // namespace aic::dsp
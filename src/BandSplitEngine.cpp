@@ -0,0 +1,243 @@
+#include "BandSplitEngine.h"
+
+#include <cmath>
+
+namespace aic::dsp
+{
+
+bool BandSplitEngine::canSplit(double hostSampleRate, double modelSampleRate)
+{
+    if (modelSampleRate <= 0.0 || hostSampleRate <= modelSampleRate)
+        return false;
+
+    auto factor = hostSampleRate / modelSampleRate;
+    return std::abs(factor - std::round(factor)) < 1.0e-6;
+}
+
+void BandSplitEngine::prepare(double hostSampleRate, double modelSampleRate, int numChannels,
+                              int maxBlockSize)
+{
+    m_hostSampleRate  = hostSampleRate;
+    m_modelSampleRate = modelSampleRate;
+    m_factor          = juce::jmax(1, juce::roundToInt(hostSampleRate / modelSampleRate));
+    m_numChannels     = numChannels;
+    m_maxBlockSize    = maxBlockSize;
+    m_maxModelFrames  = (maxBlockSize + m_factor - 1) / m_factor;
+
+    juce::dsp::ProcessSpec spec{hostSampleRate, static_cast<juce::uint32>(maxBlockSize),
+                                static_cast<juce::uint32>(numChannels)};
+
+    m_crossover.setType(juce::dsp::LinkwitzRileyFilterType::lowpass);
+    m_crossover.setCutoffFrequency(static_cast<float>(crossoverRatio * modelSampleRate));
+    m_crossover.prepare(spec);
+
+    // The same Butterworth cascade is used before decimation and after zero-stuffing
+    m_resamplingCoefficients =
+        juce::dsp::FilterDesign<float>::designIIRLowpassHighOrderButterworthMethod(
+            static_cast<float>(antiAliasRatio * modelSampleRate), hostSampleRate, antiAliasOrder);
+
+    m_allPassCoefficients.clear();
+    for (auto* coefficients : m_resamplingCoefficients)
+        m_allPassCoefficients.add(makeMatchingAllPass(*coefficients));
+
+    m_antiAlias.assign(static_cast<size_t>(numChannels), {});
+    m_antiImage.assign(static_cast<size_t>(numChannels), {});
+    m_referenceImage.assign(static_cast<size_t>(numChannels), {});
+    m_allPass.assign(static_cast<size_t>(numChannels), {});
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        for (auto* coefficients : m_resamplingCoefficients)
+        {
+            m_antiAlias[static_cast<size_t>(ch)].emplace_back(coefficients);
+            m_antiImage[static_cast<size_t>(ch)].emplace_back(coefficients);
+            m_referenceImage[static_cast<size_t>(ch)].emplace_back(coefficients);
+        }
+
+        for (auto* coefficients : m_allPassCoefficients)
+            m_allPass[static_cast<size_t>(ch)].emplace_back(coefficients);
+    }
+
+    m_modelBuffer.setSize(numChannels, m_maxModelFrames);
+    m_highBand.setSize(numChannels, maxBlockSize);
+
+    // Touch the pages now so the first block does not fault them in on the audio thread
+    m_modelBuffer.clear();
+    m_highBand.clear();
+    m_gainRamp.assign(static_cast<size_t>(maxBlockSize), 1.0f);
+
+    m_highBandGain.reset(hostSampleRate, 0.05);
+    m_highBandGain.setCurrentAndTargetValue(1.0f);
+
+    setModelOutputDelay(0);
+}
+
+void BandSplitEngine::setModelOutputDelay(size_t modelDelaySamples)
+{
+    // The high band has the phase of the resampling filters already, only the model is left
+    m_highBandDelay  = static_cast<int>(modelDelaySamples) * m_factor;
+    m_latencySamples = m_highBandDelay + juce::roundToInt(estimateResamplingDelay());
+
+    m_highBandDelayLine.setMaximumDelayInSamples(juce::jmax(1, m_highBandDelay));
+    m_highBandDelayLine.prepare({m_hostSampleRate, static_cast<juce::uint32>(m_maxBlockSize),
+                                 static_cast<juce::uint32>(m_numChannels)});
+    m_highBandDelayLine.setDelay(static_cast<float>(m_highBandDelay));
+
+    reset();
+}
+
+void BandSplitEngine::reset()
+{
+    m_crossover.reset();
+    m_highBandDelayLine.reset();
+
+    for (auto& cascade : m_antiAlias)
+        for (auto& stage : cascade)
+            stage.reset();
+
+    for (auto& cascade : m_antiImage)
+        for (auto& stage : cascade)
+            stage.reset();
+
+    for (auto& cascade : m_referenceImage)
+        for (auto& stage : cascade)
+            stage.reset();
+
+    for (auto& cascade : m_allPass)
+        for (auto& stage : cascade)
+            stage.reset();
+
+    m_highBandGain.setCurrentAndTargetValue(m_highBandGain.getTargetValue());
+    m_phase = 0;
+}
+
+int BandSplitEngine::splitAndDecimate(const float* const* input, int numChannels, int numSamples)
+{
+    jassert(numSamples <= m_maxBlockSize);
+    jassert(numChannels <= m_numChannels);
+
+    int numModelFrames = 0;
+
+    const auto interpolationGain = static_cast<float>(m_factor);
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        auto* high      = m_highBand.getWritePointer(ch);
+        auto* low       = m_modelBuffer.getWritePointer(ch);
+        auto& antiAlias = m_antiAlias[static_cast<size_t>(ch)];
+        auto& reference = m_referenceImage[static_cast<size_t>(ch)];
+        auto& allPass   = m_allPass[static_cast<size_t>(ch)];
+
+        int phase = m_phase;
+        int frame = 0;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            float lowSample  = 0.0f;
+            float highSample = 0.0f;
+            m_crossover.processSample(ch, input[ch][i], lowSample, highSample);
+
+            // Filter every sample to keep the IIR state continuous, keep every m_factor-th
+            auto filtered  = processCascade(antiAlias, lowSample);
+            auto upsampled = 0.0f;
+            if (phase == 0)
+            {
+                low[frame++] = filtered;
+                upsampled    = filtered * interpolationGain;
+            }
+
+            // Everything the low band path does not carry, including the droop of its filters
+            auto resampled = processCascade(reference, upsampled);
+            high[i]        = processCascade(allPass, lowSample + highSample) - resampled;
+
+            if (++phase == m_factor)
+                phase = 0;
+        }
+
+        numModelFrames = frame;
+    }
+
+    m_crossover.snapToZero();
+
+    return numModelFrames;
+}
+
+void BandSplitEngine::interpolateAndSum(float* const* output, int numChannels, int numSamples)
+{
+    jassert(numSamples <= m_maxBlockSize);
+
+    for (int i = 0; i < numSamples; ++i)
+        m_gainRamp[static_cast<size_t>(i)] = m_highBandGain.getNextValue();
+
+    const auto interpolationGain = static_cast<float>(m_factor);
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        const auto* high      = m_highBand.getReadPointer(ch);
+        const auto* low       = m_modelBuffer.getReadPointer(ch);
+        auto&       antiImage = m_antiImage[static_cast<size_t>(ch)];
+        auto*       out       = output[ch];
+
+        int phase = m_phase;
+        int frame = 0;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            // Zero-stuffing, the gain compensates the energy lost by the inserted zeros
+            auto upsampled = phase == 0 ? low[frame++] * interpolationGain : 0.0f;
+            auto lowSample = processCascade(antiImage, upsampled);
+
+            m_highBandDelayLine.pushSample(ch, high[i]);
+            auto highSample = m_highBandDelayLine.popSample(ch);
+
+            out[i] = lowSample + highSample * m_gainRamp[static_cast<size_t>(i)];
+
+            if (++phase == m_factor)
+                phase = 0;
+        }
+    }
+
+    m_phase = (m_phase + numSamples) % m_factor;
+}
+
+juce::dsp::IIR::Coefficients<float>::Ptr
+BandSplitEngine::makeMatchingAllPass(const juce::dsp::IIR::Coefficients<float>& section)
+{
+    // The numerator of a Butterworth section has all its zeros at Nyquist, so its phase is linear
+    // and twice the section has the phase of the all-pass with the same poles
+    const auto* c = section.getRawCoefficients();
+
+    if (section.getFilterOrder() == 1)
+        return new juce::dsp::IIR::Coefficients<float>(c[2], 1.0f, 1.0f, c[2]);
+
+    return new juce::dsp::IIR::Coefficients<float>(c[4], c[3], 1.0f, 1.0f, c[3], c[4]);
+}
+
+double BandSplitEngine::estimateResamplingDelay() const
+{
+    // Group delay of the anti-alias and anti-image cascades around the crossover frequency,
+    // where both bands overlap and a mismatch would be audible as comb filtering.
+    const auto frequency = crossoverRatio * m_modelSampleRate;
+    const auto delta     = frequency * 0.01;
+
+    double phaseDifference = 0.0;
+    for (auto* coefficients : m_resamplingCoefficients)
+    {
+        auto difference = coefficients->getPhaseForFrequency(frequency + delta, m_hostSampleRate) -
+                          coefficients->getPhaseForFrequency(frequency - delta, m_hostSampleRate);
+
+        // unwrap
+        while (difference > juce::MathConstants<double>::pi)
+            difference -= juce::MathConstants<double>::twoPi;
+        while (difference < -juce::MathConstants<double>::pi)
+            difference += juce::MathConstants<double>::twoPi;
+
+        phaseDifference += difference;
+    }
+
+    auto groupDelaySeconds = -phaseDifference / (juce::MathConstants<double>::twoPi * 2.0 * delta);
+
+    // both cascades contribute the same delay
+    return juce::jmax(0.0, 2.0 * groupDelaySeconds * m_hostSampleRate);
+}
+
+} // namespace aic::dsp
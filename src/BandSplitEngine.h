@@ -0,0 +1,156 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
+#include <vector>
+
+namespace aic::dsp
+{
+
+/**
+ * @brief Runs a narrowband model on the low band of a fullband signal.
+ *
+ * The input is split with a Linkwitz-Riley crossover just below the model's Nyquist frequency.
+ * The low band is decimated by an integer factor so the model can run at its native sample rate,
+ * and interpolated to the host rate again after the model. The high band is the complement of that
+ * path: the input passed through all-passes with the phase of the resampling filters, minus the
+ * resampled low band without the model. It is delayed by the model and scaled by a VAD-driven gain.
+ * With a model that only delays, both bands sum to an all-pass of the input, the magnitude stays
+ * flat across the crossover and the droop of the resampling filters.
+ *
+ * Usage per block (all calls happen on the audio thread):
+ * 1. splitAndDecimate() fills the model buffer and returns the number of model frames
+ * 2. the model processes getModelChannels() in place
+ * 3. interpolateAndSum() writes the recombined signal back into the host buffer
+ */
+class BandSplitEngine
+{
+  public:
+    BandSplitEngine() = default;
+
+    /**
+     * @brief Checks whether the host rate is an integer multiple of the model rate.
+     *
+     * @return true if band-splitting can be used for this combination of rates
+     */
+    static bool canSplit(double hostSampleRate, double modelSampleRate);
+
+    /**
+     * @brief Allocates all buffers and designs the filters. Not real-time safe.
+     *
+     * @param hostSampleRate Sample rate of the host buffer
+     * @param modelSampleRate Native sample rate of the narrowband model
+     * @param numChannels Number of channels to process
+     * @param maxBlockSize Maximum number of host samples passed to a single call
+     */
+    void prepare(double hostSampleRate, double modelSampleRate, int numChannels, int maxBlockSize);
+
+    /**
+     * @brief Sets the output delay of the model in model samples. Not real-time safe.
+     *
+     * Must be called after prepare(), the high band delay line is resized accordingly.
+     */
+    void setModelOutputDelay(size_t modelDelaySamples);
+
+    void reset();
+
+    /**
+     * @brief Sets the gain the high band should ramp to, usually derived from the VAD.
+     */
+    void setHighBandGain(float gain)
+    {
+        m_highBandGain.setTargetValue(gain);
+    }
+
+    int getDecimationFactor() const
+    {
+        return m_factor;
+    }
+
+    int getMaxBlockSize() const
+    {
+        return m_maxBlockSize;
+    }
+
+    /**
+     * @brief Maximum number of model frames produced by a single splitAndDecimate() call.
+     */
+    size_t getMaxModelFrames() const
+    {
+        return static_cast<size_t>(m_maxModelFrames);
+    }
+
+    /**
+     * @brief Total latency of the recombined signal in host samples.
+     *
+     * The model delay plus the group delay of the resampling filters at the crossover.
+     */
+    int getLatencySamples() const
+    {
+        return m_latencySamples;
+    }
+
+    float* const* getModelChannels()
+    {
+        return m_modelBuffer.getArrayOfWritePointers();
+    }
+
+    int splitAndDecimate(const float* const* input, int numChannels, int numSamples);
+
+    void interpolateAndSum(float* const* output, int numChannels, int numSamples);
+
+  private:
+    using Filter = juce::dsp::IIR::Filter<float>;
+
+    static constexpr double crossoverRatio = 0.4;  // crossover relative to model sample rate
+    static constexpr double antiAliasRatio = 0.45; // resampling filter relative to model rate
+    static constexpr int    antiAliasOrder = 8;
+
+    static float processCascade(std::vector<Filter>& cascade, float sample)
+    {
+        for (auto& stage : cascade)
+            sample = stage.processSample(sample);
+        return sample;
+    }
+
+    /**
+     * @brief An all-pass with the poles of the section, with the phase of the section applied
+     * twice.
+     */
+    static juce::dsp::IIR::Coefficients<float>::Ptr
+    makeMatchingAllPass(const juce::dsp::IIR::Coefficients<float>& section);
+
+    double estimateResamplingDelay() const;
+
+    juce::dsp::LinkwitzRileyFilter<float> m_crossover;
+
+    juce::ReferenceCountedArray<juce::dsp::IIR::Coefficients<float>> m_resamplingCoefficients;
+    std::vector<std::vector<Filter>>                                 m_antiAlias;
+    std::vector<std::vector<Filter>>                                 m_antiImage;
+
+    // The resampled low band without the model and the phase match of the high band
+    juce::ReferenceCountedArray<juce::dsp::IIR::Coefficients<float>> m_allPassCoefficients;
+    std::vector<std::vector<Filter>>                                 m_referenceImage;
+    std::vector<std::vector<Filter>>                                 m_allPass;
+
+    juce::dsp::DelayLine<float, juce::dsp::DelayLineInterpolationTypes::None> m_highBandDelayLine;
+
+    juce::AudioBuffer<float>   m_modelBuffer;
+    juce::AudioBuffer<float>   m_highBand;
+    std::vector<float>         m_gainRamp;
+    juce::SmoothedValue<float> m_highBandGain{1.0f};
+
+    double m_hostSampleRate{48000.0};
+    double m_modelSampleRate{16000.0};
+    int    m_factor{1};
+    int    m_phase{0};
+    int    m_numChannels{0};
+    int    m_maxBlockSize{0};
+    int    m_maxModelFrames{0};
+    int    m_highBandDelay{0};
+    int    m_latencySamples{0};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BandSplitEngine)
+};
+
+} // namespace aic::dsp
@@ -0,0 +1,130 @@
+#include "DeviceConfigurator.h"
+
+#include "Logging.h"
+
+#if JucePlugin_Build_Standalone
+#include <juce_audio_plugin_client/Standalone/juce_StandaloneFilterWindow.h>
+#endif
+
+namespace aic
+{
+
+juce::StringArray DeviceConfigurator::getProfileNames()
+{
+    return {"Device: Manual", "Device: Model Optimum", "Device: Lowest Latency"};
+}
+
+std::unique_ptr<DeviceConfigurator>
+DeviceConfigurator::create(std::function<void()> onDeviceChanged)
+{
+#if JucePlugin_Build_Standalone
+    if (auto* holder = juce::StandalonePluginHolder::getInstance())
+        return std::make_unique<DeviceConfigurator>(holder->deviceManager,
+                                                    std::move(onDeviceChanged));
+#else
+    juce::ignoreUnused(onDeviceChanged);
+#endif
+
+    return nullptr;
+}
+
+DeviceConfigurator::DeviceConfigurator(juce::AudioDeviceManager& deviceManager,
+                                       std::function<void()>     onDeviceChanged)
+    : m_deviceManager(deviceManager), m_onDeviceChanged(std::move(onDeviceChanged))
+{
+    m_deviceManager.addChangeListener(this);
+}
+
+DeviceConfigurator::~DeviceConfigurator()
+{
+    m_deviceManager.removeChangeListener(this);
+}
+
+void DeviceConfigurator::apply(Profile profile, int optimalSampleRate, int optimalNumFrames)
+{
+    auto* device = m_deviceManager.getCurrentAudioDevice();
+    if (profile == Profile::Off || device == nullptr || optimalSampleRate <= 0 ||
+        optimalNumFrames <= 0)
+        return;
+
+    auto currentRate = device->getCurrentSampleRate();
+    auto sampleRate  = chooseSampleRate(device->getAvailableSampleRates(), optimalSampleRate);
+
+    // The frames were reported for the current rate, the model reports them again after the switch
+    auto numFrames = optimalNumFrames;
+    if (currentRate > 0.0 && !juce::approximatelyEqual(sampleRate, currentRate))
+        numFrames = juce::roundToInt(optimalNumFrames * sampleRate / currentRate);
+
+    auto bufferSize = chooseBufferSize(device->getAvailableBufferSizes(), numFrames, profile);
+
+    auto setup = m_deviceManager.getAudioDeviceSetup();
+    if (juce::approximatelyEqual(setup.sampleRate, sampleRate) && setup.bufferSize == bufferSize)
+        return;
+
+    setup.sampleRate = sampleRate;
+    setup.bufferSize = bufferSize;
+
+    auto error = m_deviceManager.setAudioDeviceSetup(setup, true);
+    if (error.isNotEmpty())
+        aic::log::write(aic::log::Level::Warning, aic::log::Code::DeviceSetupFailed, error);
+}
+
+double DeviceConfigurator::getEndToEndLatencyMs(int pluginLatencySamples) const
+{
+    auto* device = m_deviceManager.getCurrentAudioDevice();
+    if (device == nullptr || device->getCurrentSampleRate() <= 0.0)
+        return -1.0;
+
+    auto samples = device->getInputLatencyInSamples() + device->getOutputLatencyInSamples() +
+                   pluginLatencySamples;
+    return samples * 1000.0 / device->getCurrentSampleRate();
+}
+
+double DeviceConfigurator::chooseSampleRate(const juce::Array<double>& available,
+                                            int                        optimalSampleRate)
+{
+    if (available.isEmpty())
+        return optimalSampleRate;
+
+    // Sorted by JUCE, but not guaranteed by every device type
+    auto sorted = available;
+    sorted.sort();
+
+    for (auto rate : sorted)
+        if (rate >= optimalSampleRate - 0.5)
+            return rate;
+
+    return sorted.getLast();
+}
+
+int DeviceConfigurator::chooseBufferSize(const juce::Array<int>& available, int optimalNumFrames,
+                                         Profile profile)
+{
+    if (available.isEmpty())
+        return optimalNumFrames;
+
+    auto sorted = available;
+    sorted.sort();
+
+    // Every callback then delivers a whole part of a model block, nothing waits for the next one.
+    // Not below the bound, the callback completing a block has to process it within its period.
+    if (profile == Profile::LowestLatency)
+        for (auto size : sorted)
+            if (size > 0 && size * maxCallbacksPerWindow >= optimalNumFrames &&
+                optimalNumFrames % size == 0)
+                return size;
+
+    for (auto size : sorted)
+        if (size >= optimalNumFrames)
+            return size;
+
+    return sorted.getLast();
+}
+
+void DeviceConfigurator::changeListenerCallback(juce::ChangeBroadcaster*)
+{
+    if (m_onDeviceChanged)
+        m_onDeviceChanged();
+}
+
+} // namespace aic
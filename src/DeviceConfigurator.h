@@ -0,0 +1,94 @@
+#pragma once
+
+#include <functional>
+#include <juce_audio_devices/juce_audio_devices.h>
+#include <memory>
+
+namespace aic
+{
+
+/**
+ * @brief Sets the audio device of the standalone app to the optimum of the active model.
+ *
+ * Plugins leave the device to the host, so the configurator only exists in the standalone app.
+ * Whenever the model changes, the device is switched to the optimal sample rate of the model and
+ * a buffer size chosen by the profile. Changing the device rebuilds the model for the new setup,
+ * which is applied again and then matches, so the two settle after at most two rounds.
+ */
+class DeviceConfigurator : private juce::ChangeListener
+{
+  public:
+    enum class Profile
+    {
+        Off,           // The device is left as the user set it up
+        ModelOptimum,  // The optimal number of frames of the model per callback
+        LowestLatency, // The smallest such buffer size of at least half the optimal frames
+    };
+
+    /**
+     * @brief How many callbacks the Lowest Latency profile splits a model window into at most.
+     *
+     * Smaller buffers lower the latency, but the callback that completes a window has to process
+     * all of it within its own period. With the window split in two, the model may take up to
+     * half of the window duration, smaller buffers leave too little time and cause dropouts.
+     */
+    static constexpr int maxCallbacksPerWindow = 2;
+
+    /**
+     * @brief The names of the profiles in the order of the enum, for the selector.
+     */
+    static juce::StringArray getProfileNames();
+
+    /**
+     * @brief Creates the configurator of the device of the standalone app, nullptr in plugins.
+     *
+     * @param onDeviceChanged Called on the message thread whenever the device or its setup changed
+     */
+    static std::unique_ptr<DeviceConfigurator> create(std::function<void()> onDeviceChanged);
+
+    DeviceConfigurator(juce::AudioDeviceManager& deviceManager,
+                       std::function<void()>     onDeviceChanged);
+    ~DeviceConfigurator() override;
+
+    /**
+     * @brief Switches the device to the rate and buffer size of the profile for the model.
+     *
+     * Nothing happens with the Off profile, without a device or when the device already runs with
+     * them. Rates and buffer sizes the device does not offer are replaced by the nearest ones.
+     *
+     * @param optimalSampleRate The optimal sample rate of the model, 0 without model
+     * @param optimalNumFrames The optimal number of frames at the current rate, 0 without model
+     */
+    void apply(Profile profile, int optimalSampleRate, int optimalNumFrames);
+
+    /**
+     * @brief The input and output latency of the device plus the latency of the plugin.
+     *
+     * @return The latency from the microphone to the speakers in ms, -1 without device
+     */
+    double getEndToEndLatencyMs(int pluginLatencySamples) const;
+
+    /**
+     * @brief The optimal rate if offered, else the next higher one, else the highest one.
+     */
+    static double chooseSampleRate(const juce::Array<double>& available, int optimalSampleRate);
+
+    /**
+     * @brief The buffer size of the profile, the optimal number of frames if none is offered.
+     *
+     * Lowest Latency takes the smallest offered size the optimal number of frames is a multiple
+     * of, bounded by maxCallbacksPerWindow, and falls back to the Model Optimum size.
+     */
+    static int chooseBufferSize(const juce::Array<int>& available, int optimalNumFrames,
+                                Profile profile);
+
+  private:
+    void changeListenerCallback(juce::ChangeBroadcaster* source) override;
+
+    juce::AudioDeviceManager& m_deviceManager;
+    std::function<void()>     m_onDeviceChanged;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DeviceConfigurator)
+};
+
+} // namespace aic
@@ -0,0 +1,280 @@
+#include "DiskRecorder.h"
+
+#include "Logging.h"
+
+namespace aic
+{
+
+DiskRecorder::DiskRecorder() : juce::Thread("aic disk recorder") {}
+
+DiskRecorder::~DiskRecorder()
+{
+    stop();
+}
+
+juce::File DiskRecorder::getDefaultDirectory()
+{
+    return juce::File::getSpecialLocation(juce::File::userMusicDirectory)
+        .getChildFile("ai-coustics Recordings");
+}
+
+void DiskRecorder::prepare(double sampleRate, int numChannels)
+{
+    if (juce::approximatelyEqual(sampleRate, m_sampleRate) && numChannels == m_numChannels)
+        return;
+
+    auto wasRecording = isRecording();
+    stop();
+
+    m_sampleRate  = sampleRate;
+    m_numChannels = juce::jmax(1, numChannels);
+
+    // Files have a fixed format, the recording goes on in new ones
+    if (wasRecording)
+        start(m_directory, m_format);
+}
+
+bool DiskRecorder::start(const juce::File& directory, Format format)
+{
+    stop();
+
+    m_directory = directory;
+    m_format    = format;
+    m_frameSize = 2 * m_numChannels + 1;
+
+    auto capacity = juce::roundToInt(m_sampleRate * ringSeconds);
+    m_ring.assign(static_cast<size_t>(capacity) * static_cast<size_t>(m_frameSize), 0.0f);
+    m_fifo.setTotalSize(capacity);
+    m_fifo.reset();
+
+    auto prefix = juce::Time::getCurrentTime().formatted("%Y-%m-%d_%H-%M-%S");
+    auto opened = directory.createDirectory().wasOk() &&
+                  openTrack(m_tracks[0], directory, prefix + "_input", 0, m_numChannels, 32) &&
+                  openTrack(m_tracks[1], directory, prefix + "_output", m_numChannels,
+                            m_numChannels, 32) &&
+                  openTrack(m_tracks[2], directory, prefix + "_vad", 2 * m_numChannels, 1,
+                            vadBitsPerSample);
+    if (!opened)
+    {
+        closeTracks();
+        return false;
+    }
+
+    m_numRecorded.store(0);
+    m_numDropped.store(0);
+
+    startThread(juce::Thread::Priority::low);
+    m_recording.store(true);
+    return true;
+}
+
+void DiskRecorder::stop()
+{
+    if (!m_recording.exchange(false))
+        return;
+
+    // The audio thread may still be in a block it began before, the ring stays until it left
+    while (m_inBlock.load())
+        juce::Thread::yield();
+
+    // Writes what is left in the ring before the thread exits
+    stopThread(stopTimeoutMs);
+    closeTracks();
+}
+
+bool DiskRecorder::openTrack(Track& track, const juce::File& directory, const juce::String& name,
+                             int firstChannel, int numChannels, int bitsPerSample)
+{
+    track.firstChannel = firstChannel;
+    track.numChannels  = numChannels;
+    track.buffer.setSize(numChannels, chunkFrames);
+    track.interleaved.resize(static_cast<size_t>(chunkFrames * numChannels));
+
+    auto file = directory.getChildFile(name + ".wav");
+    if (m_format == Format::RawFloat)
+        file = directory.getChildFile(name + "_" + juce::String(juce::roundToInt(m_sampleRate)) +
+                                      "Hz_" + juce::String(numChannels) + "ch_f32.raw");
+
+    auto stream = std::make_unique<juce::FileOutputStream>(file, streamBytes);
+    if (!stream->openedOk())
+    {
+        aic::log::write(aic::log::Level::Error, aic::log::Code::RecordingFailed,
+                        file.getFullPathName());
+        return false;
+    }
+
+    if (m_format == Format::RawFloat)
+    {
+        track.rawStream = std::move(stream);
+        return true;
+    }
+
+    // The writer owns the stream once it was created
+    track.writer.reset(juce::WavAudioFormat().createWriterFor(
+        stream.get(), m_sampleRate, static_cast<unsigned int>(numChannels), bitsPerSample, {}, 0));
+    if (track.writer == nullptr)
+    {
+        aic::log::write(aic::log::Level::Error, aic::log::Code::RecordingFailed,
+                        file.getFullPathName());
+        return false;
+    }
+
+    stream.release();
+    return true;
+}
+
+void DiskRecorder::closeTracks()
+{
+    // Closing the writers completes the WAV headers
+    for (auto& track : m_tracks)
+    {
+        track.writer.reset();
+        track.rawStream.reset();
+    }
+}
+
+template <typename Copy>
+void DiskRecorder::forEachFrame(Copy&& copy) noexcept
+{
+    auto* ring   = m_ring.data();
+    int   sample = 0;
+
+    for (int frame = m_blockStart1; frame < m_blockStart1 + m_blockSize1; ++frame)
+        copy(ring + static_cast<size_t>(frame) * static_cast<size_t>(m_frameSize), sample++);
+
+    for (int frame = m_blockStart2; frame < m_blockStart2 + m_blockSize2; ++frame)
+        copy(ring + static_cast<size_t>(frame) * static_cast<size_t>(m_frameSize), sample++);
+}
+
+void DiskRecorder::beginBlock(const float* const* channels, int numChannels,
+                              int numSamples) noexcept
+{
+    m_blockSize1 = 0;
+    m_blockSize2 = 0;
+
+    if (!m_recording.load(std::memory_order_relaxed) || numSamples <= 0)
+        return;
+
+    // Announced before checking again, so stop() either sees the block or it sees the stop
+    m_inBlock.store(true);
+    if (!m_recording.load())
+    {
+        m_inBlock.store(false);
+        return;
+    }
+
+    m_fifo.prepareToWrite(numSamples, m_blockStart1, m_blockSize1, m_blockStart2, m_blockSize2);
+    if (m_blockSize1 + m_blockSize2 < numSamples)
+    {
+        // A partial block would shift the tracks against the time of the recording
+        m_blockSize1 = 0;
+        m_blockSize2 = 0;
+        m_numDropped.fetch_add(numSamples, std::memory_order_relaxed);
+        m_inBlock.store(false);
+        return;
+    }
+
+    const auto numInputs = juce::jmin(numChannels, m_numChannels);
+    forEachFrame(
+        [&](float* frame, int sample)
+        {
+            for (int ch = 0; ch < m_numChannels; ++ch)
+                frame[ch] = ch < numInputs ? channels[ch][sample] : 0.0f;
+        });
+}
+
+void DiskRecorder::endBlock(const float* const* channels, int numChannels, bool speech) noexcept
+{
+    const auto numSamples = m_blockSize1 + m_blockSize2;
+    if (numSamples == 0)
+        return;
+
+    const auto numOutputs = juce::jmin(numChannels, m_numChannels);
+    const auto vad        = speech ? 1.0f : 0.0f;
+    forEachFrame(
+        [&](float* frame, int sample)
+        {
+            for (int ch = 0; ch < m_numChannels; ++ch)
+                frame[m_numChannels + ch] = ch < numOutputs ? channels[ch][sample] : 0.0f;
+
+            frame[2 * m_numChannels] = vad;
+        });
+
+    m_fifo.finishedWrite(numSamples);
+    m_numRecorded.fetch_add(numSamples, std::memory_order_relaxed);
+
+    m_blockSize1 = 0;
+    m_blockSize2 = 0;
+    m_inBlock.store(false);
+}
+
+void DiskRecorder::run()
+{
+    while (!threadShouldExit())
+    {
+        if (!writeChunk(chunkFrames))
+            wait(pollIntervalMs);
+    }
+
+    while (writeChunk(1))
+    {
+    }
+}
+
+bool DiskRecorder::writeChunk(int minFrames)
+{
+    auto numFrames = juce::jmin(m_fifo.getNumReady(), chunkFrames);
+    if (numFrames < minFrames || numFrames == 0)
+        return false;
+
+    {
+        const auto  scope     = m_fifo.read(numFrames);
+        const auto* ring      = m_ring.data();
+        const auto  frameSize = static_cast<size_t>(m_frameSize);
+
+        auto deinterleave = [&](int start, int size, int offset)
+        {
+            for (auto& track : m_tracks)
+            {
+                for (int ch = 0; ch < track.numChannels; ++ch)
+                {
+                    auto*       destination = track.buffer.getWritePointer(ch, offset);
+                    const auto* source      = ring + static_cast<size_t>(start) * frameSize +
+                                         static_cast<size_t>(track.firstChannel + ch);
+
+                    for (int index = 0; index < size; ++index)
+                        destination[index] = source[static_cast<size_t>(index) * frameSize];
+                }
+            }
+        };
+
+        deinterleave(scope.startIndex1, scope.blockSize1, 0);
+        deinterleave(scope.startIndex2, scope.blockSize2, scope.blockSize1);
+    }
+
+    for (auto& track : m_tracks)
+    {
+        if (track.writer != nullptr)
+        {
+            track.writer->writeFromAudioSampleBuffer(track.buffer, 0, numFrames);
+        }
+        else if (track.rawStream != nullptr)
+        {
+            for (int ch = 0; ch < track.numChannels; ++ch)
+            {
+                const auto* source = track.buffer.getReadPointer(ch);
+                for (int index = 0; index < numFrames; ++index)
+                    track.interleaved[static_cast<size_t>(index * track.numChannels + ch)] =
+                        source[index];
+            }
+
+            track.rawStream->write(track.interleaved.data(),
+                                   static_cast<size_t>(numFrames * track.numChannels) *
+                                       sizeof(float));
+        }
+    }
+
+    return true;
+}
+
+} // namespace aic
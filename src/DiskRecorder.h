@@ -0,0 +1,161 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <memory>
+#include <vector>
+
+namespace aic
+{
+
+/**
+ * @brief Records the input, the enhanced output and the VAD result of the processor to disk.
+ *
+ * Meant for long field tests with the standalone app. The audio thread copies every block into a
+ * preallocated lock-free ring, sample aligned across the three tracks. A background thread writes
+ * the ring to one file per track in large chunks, so the audio thread never allocates or touches
+ * a file. Blocks which do not fit into the ring because the disk fell behind are dropped as a
+ * whole and counted.
+ */
+class DiskRecorder : private juce::Thread
+{
+  public:
+    enum class Format
+    {
+        Wav,     // 32 bit float, RF64 beyond 4 GB, the VAD as 16 bit
+        RawFloat // Interleaved 32 bit float without header, rate and channels in the file name
+    };
+
+    DiskRecorder();
+    ~DiskRecorder() override;
+
+    /**
+     * @brief Sets the sample rate and channels, a running recording continues in new files.
+     *
+     * Not real-time safe, called while the audio thread is stopped.
+     */
+    void prepare(double sampleRate, int numChannels);
+
+    /**
+     * @brief Starts recording into new files in the directory, named by the current time.
+     *
+     * Allocates the ring, not real-time safe.
+     *
+     * @return false if a file could not be created
+     */
+    bool start(const juce::File& directory, Format format);
+
+    /**
+     * @brief Stops recording and closes the files once everything queued is written.
+     */
+    void stop();
+
+    bool isRecording() const
+    {
+        return m_recording.load();
+    }
+
+    /**
+     * @brief Queues the input of a block, before it is processed. Real-time safe.
+     */
+    void beginBlock(const float* const* channels, int numChannels, int numSamples) noexcept;
+
+    /**
+     * @brief Completes the block begun with the output and the VAD result. Real-time safe.
+     */
+    void endBlock(const float* const* channels, int numChannels, bool speech) noexcept;
+
+    /**
+     * @brief Samples per track queued since the recording started.
+     */
+    juce::int64 getNumRecordedSamples() const
+    {
+        return m_numRecorded.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Samples per track dropped since the recording started because the ring was full.
+     */
+    juce::int64 getNumDroppedSamples() const
+    {
+        return m_numDropped.load(std::memory_order_relaxed);
+    }
+
+    double getSampleRate() const
+    {
+        return m_sampleRate;
+    }
+
+    /**
+     * @brief The recordings folder in the music folder of the user.
+     */
+    static juce::File getDefaultDirectory();
+
+  private:
+    static constexpr double ringSeconds      = 10.0;
+    static constexpr int    chunkFrames      = 1 << 16;
+    static constexpr int    streamBytes      = 1 << 20;
+    static constexpr int    pollIntervalMs   = 50;
+    static constexpr int    stopTimeoutMs    = 10000;
+    static constexpr int    vadBitsPerSample = 16;
+
+    /**
+     * @brief The file of the input, the output or the VAD and where it is in a ring frame.
+     */
+    struct Track
+    {
+        int firstChannel{0};
+        int numChannels{0};
+
+        std::unique_ptr<juce::AudioFormatWriter> writer;
+        std::unique_ptr<juce::FileOutputStream>  rawStream;
+        juce::AudioBuffer<float>                 buffer;
+        std::vector<float>                       interleaved;
+    };
+
+    bool openTrack(Track& track, const juce::File& directory, const juce::String& name,
+                   int firstChannel, int numChannels, int bitsPerSample);
+    void closeTracks();
+
+    void run() override;
+
+    /**
+     * @brief Writes up to one chunk of the ring to the files.
+     *
+     * @return false if fewer than minFrames were queued
+     */
+    bool writeChunk(int minFrames);
+
+    /**
+     * @brief Calls copy(frame, sample) for the frames of the ring reserved by beginBlock.
+     */
+    template <typename Copy>
+    void forEachFrame(Copy&& copy) noexcept;
+
+    double     m_sampleRate{48000.0};
+    int        m_numChannels{2};
+    int        m_frameSize{5};
+    juce::File m_directory;
+    Format     m_format{Format::Wav};
+
+    // Frames of input channels, output channels and the VAD, interleaved
+    juce::AbstractFifo   m_fifo{1};
+    std::vector<float>   m_ring;
+    std::array<Track, 3> m_tracks;
+
+    std::atomic<bool>        m_recording{false};
+    std::atomic<bool>        m_inBlock{false};
+    std::atomic<juce::int64> m_numRecorded{0};
+    std::atomic<juce::int64> m_numDropped{0};
+
+    // Only used by the audio thread, the part of the ring reserved by beginBlock
+    int m_blockStart1{0};
+    int m_blockSize1{0};
+    int m_blockStart2{0};
+    int m_blockSize2{0};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DiskRecorder)
+};
+
+} // namespace aic
@@ -0,0 +1,122 @@
+#include "EnhancementBackend.h"
+
+#include "StubBackend.h"
+
+namespace aic
+{
+
+namespace
+{
+
+class SdkEngine : public EnhancementEngine
+{
+  public:
+    SdkEngine(std::unique_ptr<aic::AicModel> model, std::unique_ptr<aic::AicVad> vad)
+        : m_model(std::move(model)), m_vad(std::move(vad))
+    {
+    }
+
+    aic::ErrorCode initialize(uint32_t sampleRate, uint16_t numChannels, size_t numFrames,
+                              bool allowVariableFrames) override
+    {
+        return m_model->initialize(sampleRate, numChannels, numFrames, allowVariableFrames);
+    }
+
+    aic::ErrorCode processPlanar(float* const* audio, uint16_t numChannels,
+                                 size_t numFrames) override
+    {
+        return m_model->process_planar(audio, numChannels, numFrames);
+    }
+
+    void reset() override
+    {
+        m_model->reset();
+    }
+
+    void setParameter(aic::EnhancementParameter parameter, float value) override
+    {
+        m_model->set_parameter(parameter, value);
+    }
+
+    size_t getOutputDelay() const override
+    {
+        return static_cast<size_t>(m_model->get_output_delay());
+    }
+
+    uint32_t getOptimalSampleRate() const override
+    {
+        return static_cast<uint32_t>(m_model->get_optimal_sample_rate());
+    }
+
+    size_t getOptimalNumFrames(uint32_t sampleRate) const override
+    {
+        return static_cast<size_t>(m_model->get_optimal_num_frames(sampleRate));
+    }
+
+    bool hasVad() const override
+    {
+        return m_vad != nullptr;
+    }
+
+    void setVadParameter(aic::VadParameter parameter, float value) override
+    {
+        if (m_vad != nullptr)
+            m_vad->set_parameter(parameter, value);
+    }
+
+    bool isSpeechDetected() const override
+    {
+        return m_vad != nullptr && m_vad->is_speech_detected();
+    }
+
+  private:
+    std::unique_ptr<aic::AicModel> m_model;
+    std::unique_ptr<aic::AicVad>   m_vad;
+};
+
+class SdkBackend : public EnhancementBackend
+{
+  public:
+    std::pair<std::unique_ptr<EnhancementEngine>, aic::ErrorCode>
+    create(aic::ModelType modelType, const std::string& licenseKey) override
+    {
+        auto [model, errorCode] = aic::AicModel::create(modelType, licenseKey);
+        if (!model || errorCode != aic::ErrorCode::Success)
+            return {nullptr, errorCode};
+
+        // The model works without a VAD, the speech detection just stays off
+        auto [vad, errorCodeVad] = aic::AicVad::create(*model);
+        if (errorCodeVad != aic::ErrorCode::Success)
+            vad.reset();
+
+        return {std::make_unique<SdkEngine>(std::move(model), std::move(vad)),
+                aic::ErrorCode::Success};
+    }
+
+    bool requiresLicense() const override
+    {
+        return true;
+    }
+
+    juce::String getName() const override
+    {
+        return "sdk";
+    }
+};
+
+} // namespace
+
+std::unique_ptr<EnhancementBackend> createSdkBackend()
+{
+    return std::make_unique<SdkBackend>();
+}
+
+std::unique_ptr<EnhancementBackend> createDefaultBackend()
+{
+    if (juce::SystemStats::getEnvironmentVariable("AIC_BACKEND", {}) == "stub")
+        return std::make_unique<StubBackend>();
+
+    return createSdkBackend();
+}
+
+} // namespace aic
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <aic.hpp>
+#include <cstdint>
+#include <juce_core/juce_core.h>
+#include <memory>
+#include <string>
+#include <utility>
+
+namespace aic
+{
+
+/**
+ * @brief One enhancement model together with its VAD, everything the processor calls on it.
+ *
+ * The calls mirror the SDK. processPlanar() and the getters are called on the audio thread and
+ * must be real-time safe, everything else is called while the model is set up.
+ */
+class EnhancementEngine
+{
+  public:
+    virtual ~EnhancementEngine() = default;
+
+    virtual aic::ErrorCode initialize(uint32_t sampleRate, uint16_t numChannels, size_t numFrames,
+                                      bool allowVariableFrames) = 0;
+
+    virtual aic::ErrorCode processPlanar(float* const* audio, uint16_t numChannels,
+                                         size_t numFrames) = 0;
+
+    /**
+     * @brief Clears the internal state, e.g. after a seek.
+     */
+    virtual void reset() = 0;
+
+    virtual void setParameter(aic::EnhancementParameter parameter, float value) = 0;
+
+    /**
+     * @brief Delay of the output in samples at the initialized sample rate.
+     */
+    virtual size_t getOutputDelay() const = 0;
+
+    virtual uint32_t getOptimalSampleRate() const = 0;
+
+    virtual size_t getOptimalNumFrames(uint32_t sampleRate) const = 0;
+
+    virtual bool hasVad() const = 0;
+
+    virtual void setVadParameter(aic::VadParameter parameter, float value) = 0;
+
+    /**
+     * @brief Result of the VAD for the last processed block, false without a VAD.
+     */
+    virtual bool isSpeechDetected() const = 0;
+};
+
+/**
+ * @brief Creates the engines the processor runs, the SDK or a stand-in.
+ *
+ * Called on the model loader thread, implementations must be thread safe.
+ */
+class EnhancementBackend
+{
+  public:
+    virtual ~EnhancementBackend() = default;
+
+    /**
+     * @return The engine, or nullptr and the error code if it could not be created
+     */
+    virtual std::pair<std::unique_ptr<EnhancementEngine>, aic::ErrorCode>
+    create(aic::ModelType modelType, const std::string& licenseKey) = 0;
+
+    /**
+     * @brief Whether create() needs a valid license key.
+     */
+    virtual bool requiresLicense() const = 0;
+
+    virtual juce::String getName() const = 0;
+};
+
+/**
+ * @brief The backend of the ai-coustics SDK.
+ */
+std::unique_ptr<EnhancementBackend> createSdkBackend();
+
+/**
+ * @brief The backend selected with the AIC_BACKEND environment variable, "sdk" or "stub".
+ *
+ * The SDK if the variable is not set.
+ */
+std::unique_ptr<EnhancementBackend> createDefaultBackend();
+
+} // namespace aic
@@ -0,0 +1,76 @@
+#include "LevelMeter.h"
+
+#include <cmath>
+
+namespace aic::dsp
+{
+
+void LevelMeter::prepare(double sampleRate)
+{
+    m_sampleRate = sampleRate;
+    reset();
+}
+
+void LevelMeter::reset()
+{
+    m_meanSquare = 0.0f;
+    m_peak       = 0.0f;
+    m_publishedPeak.store(0.0f, std::memory_order_relaxed);
+    m_publishedRms.store(0.0f, std::memory_order_relaxed);
+}
+
+void LevelMeter::process(const float* const* channels, int numChannels, int numSamples) noexcept
+{
+    if (numChannels <= 0 || numSamples <= 0)
+        return;
+
+    float peak         = 0.0f;
+    float sumOfSquares = 0.0f;
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        peak = juce::jmax(peak, getPeak(channels[ch], numSamples));
+        sumOfSquares += getSumOfSquares(channels[ch], numSamples);
+    }
+
+    // One-pole ballistics applied per block, exact for any block size
+    const auto seconds    = static_cast<double>(numSamples) / m_sampleRate;
+    const auto rmsCoeff   = static_cast<float>(1.0 - std::exp(-seconds / rmsWindowSeconds));
+    const auto peakCoeff  = static_cast<float>(std::exp(-seconds / peakReleaseSeconds));
+    const auto meanSquare = sumOfSquares / static_cast<float>(numChannels * numSamples);
+
+    m_meanSquare += rmsCoeff * (meanSquare - m_meanSquare);
+    m_peak = juce::jmax(peak, m_peak * peakCoeff);
+
+    m_publishedPeak.store(m_peak, std::memory_order_relaxed);
+    m_publishedRms.store(std::sqrt(m_meanSquare), std::memory_order_relaxed);
+}
+
+float LevelMeter::getPeak(const float* samples, int numSamples) noexcept
+{
+    auto range = juce::FloatVectorOperations::findMinAndMax(samples, numSamples);
+    return juce::jmax(-range.getStart(), range.getEnd());
+}
+
+float LevelMeter::getSumOfSquares(const float* samples, int numSamples) noexcept
+{
+    constexpr int lanes = 8;
+
+    float sums[lanes] = {};
+    int   i           = 0;
+
+    for (; i + lanes <= numSamples; i += lanes)
+        for (int lane = 0; lane < lanes; ++lane)
+            sums[lane] += samples[i + lane] * samples[i + lane];
+
+    float sum = 0.0f;
+    for (auto laneSum : sums)
+        sum += laneSum;
+
+    for (; i < numSamples; ++i)
+        sum += samples[i] * samples[i];
+
+    return sum;
+}
+
+} // namespace aic::dsp
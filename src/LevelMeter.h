@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <juce_audio_basics/juce_audio_basics.h>
+
+namespace aic::dsp
+{
+
+/**
+ * @brief Peak and RMS level of a signal, measured on the audio thread and read by the UI.
+ *
+ * Every block is measured with vectorised loops and smoothed with the meter ballistics on the
+ * audio thread. The results are published as atomics, so the editor can read them at its own
+ * rate without locks and without missing peaks between two reads.
+ */
+class LevelMeter
+{
+  public:
+    /**
+     * @brief Linear levels, 1.0 is full scale.
+     */
+    struct Levels
+    {
+        float peak{0.0f};
+        float rms{0.0f};
+    };
+
+    LevelMeter() = default;
+
+    /**
+     * @brief Sets the sample rate the ballistics are based on and resets the levels.
+     */
+    void prepare(double sampleRate);
+
+    void reset();
+
+    /**
+     * @brief Measures a block. Real-time safe.
+     */
+    void process(const float* const* channels, int numChannels, int numSamples) noexcept;
+
+    /**
+     * @brief Gets the smoothed levels after the last measured block. Can be called from any thread.
+     */
+    Levels getLevels() const noexcept
+    {
+        return {m_publishedPeak.load(std::memory_order_relaxed),
+                m_publishedRms.load(std::memory_order_relaxed)};
+    }
+
+    /**
+     * @brief Gets the largest absolute sample value.
+     */
+    static float getPeak(const float* samples, int numSamples) noexcept;
+
+    /**
+     * @brief Gets the sum of the squared samples.
+     *
+     * Accumulates in independent lanes, so the compiler can vectorise the loop without relaxed
+     * floating point rules.
+     */
+    static float getSumOfSquares(const float* samples, int numSamples) noexcept;
+
+  private:
+    // Integration time of the RMS and fall time constant of the peak
+    static constexpr double rmsWindowSeconds   = 0.3;
+    static constexpr double peakReleaseSeconds = 0.5;
+
+    double m_sampleRate{48000.0};
+
+    // Only touched by the audio thread
+    float m_meanSquare{0.0f};
+    float m_peak{0.0f};
+
+    std::atomic<float> m_publishedPeak{0.0f};
+    std::atomic<float> m_publishedRms{0.0f};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LevelMeter)
+};
+
+} // namespace aic::dsp
@@ -259,6 +259,11 @@ void LicenseDialog::setupComponents()
     m_cancelButton.addListener(this);
     addAndMakeVisible(m_cancelButton);
 
+    m_progressBar.setPercentageDisplay(false);
+    m_progressBar.setColour(juce::ProgressBar::backgroundColourId, aic::ui::BLACK_15);
+    m_progressBar.setColour(juce::ProgressBar::foregroundColourId, aic::ui::BLUE_50);
+    addChildComponent(m_progressBar);
+
     // Set dialog size
     setSize(415, 310);
 }
@@ -301,6 +306,8 @@ void LicenseDialog::resized()
     m_okButton.setBounds(buttonArea.removeFromRight(147));
     buttonArea.removeFromRight(8);
     m_cancelButton.setBounds(buttonArea.removeFromRight(81));
+    buttonArea.removeFromRight(16);
+    m_progressBar.setBounds(buttonArea.withSizeKeepingCentre(buttonArea.getWidth(), 6));
 }
 
 void LicenseDialog::buttonClicked(juce::Button* button)
@@ -328,6 +335,11 @@ bool LicenseDialog::keyPressed(const juce::KeyPress& key)
 
 void LicenseDialog::handleOkAction()
 {
+    if (m_isValidating)
+    {
+        return;
+    }
+
     auto licenseKey = m_licenseKeyEditor.getText();
 
     if (licenseKey.trim().isEmpty())
@@ -337,20 +349,64 @@ void LicenseDialog::handleOkAction()
         return;
     }
 
-    if (m_licenseCallback && m_licenseCallback(licenseKey))
+    if (m_licenseCallback)
+    {
+        setValidating(true);
+        m_licenseCallback(licenseKey);
+    }
+}
+
+void LicenseDialog::showValidationResult(bool accepted, bool saved)
+{
+    if (!m_isValidating)
+    {
+        return;
+    }
+
+    m_isLicenseActive = accepted;
+    setValidating(false);
+
+    if (accepted && saved)
     {
-        m_isLicenseActive = true;
         closeDialog();
     }
+    else if (accepted)
+    {
+        // Active for this session, the dialog stays open so the error is seen
+        showErrorDialog("License Not Saved",
+                        "The license key is active, but it could not be saved to the license "
+                        "file. It has to be entered again next time.");
+    }
     else
     {
         showErrorDialog("Invalid License Key", "The license key you entered is not valid.");
-        m_isLicenseActive = false;
         m_licenseKeyEditor.selectAll();
         m_licenseKeyEditor.grabKeyboardFocus();
     }
 }
 
+void LicenseDialog::setValidating(bool isValidating)
+{
+    m_isValidating = isValidating;
+
+    m_licenseKeyEditor.setReadOnly(isValidating);
+    m_okButton.setEnabled(!isValidating);
+    m_progressBar.setVisible(isValidating);
+
+    if (isValidating)
+    {
+        m_okButton.setButtonText("Validating...");
+    }
+    else if (m_isLicenseActive)
+    {
+        m_okButton.setButtonText("Update License");
+    }
+    else
+    {
+        m_okButton.setButtonText("Activate License");
+    }
+}
+
 void LicenseDialog::setCloseCallback(CloseCallback callback)
 {
     m_closeCallback = std::move(callback);
@@ -385,6 +441,9 @@ void LicenseDialog::showDialog(juce::Component* parentComponent)
 
 void LicenseDialog::closeDialog()
 {
+    // A result that arrives after closing is ignored
+    setValidating(false);
+
     // Clear the license key input field
     m_licenseKeyEditor.clear();
 
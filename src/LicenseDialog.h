@@ -116,12 +116,12 @@ class LicenseDialog : public juce::Component, public juce::Button::Listener
   public:
     /// Callback function type for handling license key submission.
     ///
+    /// Starts the validation and returns immediately. The dialog shows its progress until
+    /// the result is reported with `showValidationResult`.
+    ///
     /// # Arguments
     /// * `licenseKey` - The license key entered by the user
-    ///
-    /// # Returns
-    /// `true` if the license key was accepted, `false` otherwise
-    using LicenseCallback = std::function<bool(const juce::String& licenseKey)>;
+    using LicenseCallback = std::function<void(const juce::String& licenseKey)>;
 
     /// Callback function type for handling dialog close events.
     ///
@@ -178,6 +178,16 @@ class LicenseDialog : public juce::Component, public juce::Button::Listener
         m_isLicenseActive = isActive;
     }
 
+    /// Ends the validation started by the license callback.
+    ///
+    /// Closes the dialog if the key was accepted and saved, shows an error otherwise. Ignored if
+    /// the dialog was closed while validating.
+    ///
+    /// # Arguments
+    /// * `accepted` - Whether the license key was valid and is now active
+    /// * `saved` - Whether the accepted key was saved to the license file
+    void showValidationResult(bool accepted, bool saved);
+
   private:
     //==============================================================================
     // UI Components
@@ -191,6 +201,10 @@ class LicenseDialog : public juce::Component, public juce::Button::Listener
     juce::TextButton m_okButton;
     juce::TextButton m_cancelButton;
 
+    // Indeterminate progress while a key is validated
+    double            m_progress = -1.0;
+    juce::ProgressBar m_progressBar{m_progress};
+
     // Callback for license validation
     LicenseCallback m_licenseCallback;
 
@@ -206,6 +220,9 @@ class LicenseDialog : public juce::Component, public juce::Button::Listener
     // Whether a license is currently active
     bool m_isLicenseActive = false;
 
+    // Whether a license key is being validated
+    bool m_isValidating = false;
+
     /// Handles the OK button click or Enter key press.
     void handleOkAction();
 
@@ -215,6 +232,12 @@ class LicenseDialog : public juce::Component, public juce::Button::Listener
     /// Sets up the UI components with appropriate styling and properties.
     void setupComponents();
 
+    /// Shows the progress and blocks further input while a key is validated.
+    ///
+    /// # Arguments
+    /// * `isValidating` - Whether a validation is running
+    void setValidating(bool isValidating);
+
     /// Shows a custom error dialog with the specified title and message.
     ///
     /// # Arguments
@@ -0,0 +1,254 @@
+#include "Logging.h"
+
+#include <cstring>
+
+namespace aic::log
+{
+
+void write(Level level, Code code, std::int64_t arg0, std::int64_t arg1) noexcept
+{
+    // Counted before the load, the destructor either waits for this call or it finds no logger
+    detail::numWriting.fetch_add(1);
+    if (auto* logger = detail::activeLogger.load())
+        logger->push(level, code, arg0, arg1, nullptr);
+    detail::numWriting.fetch_sub(1);
+}
+
+void write(Level level, Code code, const juce::String& text) noexcept
+{
+    detail::numWriting.fetch_add(1);
+    if (auto* logger = detail::activeLogger.load())
+        logger->push(level, code, 0, 0, text.toRawUTF8());
+    detail::numWriting.fetch_sub(1);
+}
+
+Logger::Logger()
+    : juce::Thread("aic logger"),
+      m_records(new Record[capacity]),
+      m_file(getLogDirectory().getChildFile("aic-sdk-plugin.log"))
+{
+    for (std::uint32_t index = 0; index < capacity; ++index)
+        m_records[index].sequence.store(index, std::memory_order_relaxed);
+
+    openFile();
+
+    detail::activeLogger.store(this, std::memory_order_release);
+    startThread(juce::Thread::Priority::low);
+}
+
+Logger::~Logger()
+{
+    auto* expected = this;
+    detail::activeLogger.compare_exchange_strong(expected, nullptr);
+
+    // Writers that loaded the logger before it was unpublished finish their record first
+    while (detail::numWriting.load() > 0)
+        juce::Thread::yield();
+
+    stopThread(1000);
+    drain();
+}
+
+juce::File Logger::getLogDirectory()
+{
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("aic")
+        .getChildFile("logs");
+}
+
+bool Logger::push(Level level, Code code, std::int64_t arg0, std::int64_t arg1,
+                  const char* text) noexcept
+{
+    // Bounded multi-producer queue, a slot is free when its sequence equals the position
+    auto    position = m_writePosition.load(std::memory_order_relaxed);
+    Record* record   = nullptr;
+
+    for (;;)
+    {
+        record        = &m_records[position & (capacity - 1)];
+        auto sequence = record->sequence.load(std::memory_order_acquire);
+        auto distance = static_cast<std::int32_t>(sequence - position);
+
+        if (distance == 0)
+        {
+            if (m_writePosition.compare_exchange_weak(position, position + 1,
+                                                      std::memory_order_relaxed))
+                break;
+        }
+        else if (distance < 0)
+        {
+            m_numDropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        else
+        {
+            position = m_writePosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    record->timeMs  = juce::Time::currentTimeMillis();
+    record->level   = level;
+    record->code    = code;
+    record->arg0    = arg0;
+    record->arg1    = arg1;
+    record->text[0] = 0;
+
+    if (text != nullptr)
+    {
+        std::strncpy(record->text.data(), text, record->text.size() - 1);
+        record->text.back() = 0;
+    }
+
+    record->sequence.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+void Logger::run()
+{
+    while (!threadShouldExit())
+    {
+        wait(flushIntervalMs);
+        drain();
+    }
+}
+
+void Logger::drain()
+{
+    for (;;)
+    {
+        auto& record   = m_records[m_readPosition & (capacity - 1)];
+        auto  sequence = record.sequence.load(std::memory_order_acquire);
+        if (static_cast<std::int32_t>(sequence - (m_readPosition + 1)) < 0)
+            break;
+
+        auto line = format(record);
+        record.sequence.store(m_readPosition + capacity, std::memory_order_release);
+        ++m_readPosition;
+
+        writeLine(line);
+    }
+
+    if (auto dropped = m_numDropped.exchange(0))
+    {
+        Record record;
+        record.timeMs = juce::Time::currentTimeMillis();
+        record.level  = Level::Warning;
+        record.code   = Code::RecordsDropped;
+        record.arg0   = dropped;
+        writeLine(format(record));
+    }
+
+    if (m_stream != nullptr)
+        m_stream->flush();
+}
+
+void Logger::writeLine(const juce::String& line)
+{
+#if JUCE_DEBUG
+    juce::Logger::outputDebugString(line);
+#endif
+
+    if (m_stream == nullptr)
+        return;
+
+    if (m_stream->getPosition() >= maxFileBytes)
+        rotate();
+
+    if (m_stream != nullptr)
+        *m_stream << line << juce::newLine;
+}
+
+void Logger::openFile()
+{
+    // Logging is best effort, the plugin works without the file
+    if (!m_file.getParentDirectory().createDirectory())
+        return;
+
+    m_stream = std::make_unique<juce::FileOutputStream>(m_file);
+    if (!m_stream->openedOk())
+        m_stream.reset();
+}
+
+void Logger::rotate()
+{
+    m_stream.reset();
+
+    // aic-sdk-plugin.log becomes aic-sdk-plugin.1.log, the oldest file is deleted
+    auto getRotatedFile = [this](int index)
+    {
+        return m_file.getSiblingFile(m_file.getFileNameWithoutExtension() + "." +
+                                     juce::String(index) + m_file.getFileExtension());
+    };
+
+    getRotatedFile(numRotatedFiles).deleteFile();
+    for (int index = numRotatedFiles - 1; index >= 1; --index)
+        getRotatedFile(index).moveFileTo(getRotatedFile(index + 1));
+
+    m_file.moveFileTo(getRotatedFile(1));
+    openFile();
+}
+
+juce::String Logger::format(const Record& record)
+{
+    auto text = juce::String::fromUTF8(record.text.data());
+
+    juce::String message;
+    switch (record.code)
+    {
+    case Code::LicenseNotFound:
+        message = "License file not found";
+        break;
+    case Code::LicenseReadFailed:
+        message = "Failed to open the license file";
+        break;
+    case Code::LicenseInvalid:
+        message = "Invalid license key found in the license file";
+        break;
+    case Code::LicenseDirectoryFailed:
+        message = "Failed to create the license directory: " + text;
+        break;
+    case Code::LicenseWriteFailed:
+        message = "Failed to open the license file for writing";
+        break;
+    case Code::ModelCreateFailed:
+        message = "Failed to create model " + juce::String(record.arg0) + ", error " +
+                  juce::String(record.arg1);
+        break;
+    case Code::ModelInitializeFailed:
+        message = "Failed to initialize model " + juce::String(record.arg0) + ", error " +
+                  juce::String(record.arg1);
+        break;
+    case Code::ProcessingFailed:
+        message = "Processing failed with error " + juce::String(record.arg0);
+        break;
+    case Code::ProcessingRecovered:
+        message = "Processing succeeds again";
+        break;
+    case Code::LockMemoryFailed:
+        message = "Failed to lock the process memory";
+        break;
+    case Code::TraceFileFailed:
+        message = "Failed to open the trace file " + text;
+        break;
+    case Code::DeviceSetupFailed:
+        message = "Failed to configure the audio device: " + text;
+        break;
+    case Code::RecordingFailed:
+        message = "Failed to create the recording " + text;
+        break;
+    case Code::RecordsDropped:
+        message = juce::String(record.arg0) + " log records dropped, the queue was full";
+        break;
+    }
+
+    const char* levelName = record.level == Level::Error     ? "ERROR"
+                            : record.level == Level::Warning ? "WARNING"
+                                                             : "INFO";
+
+    auto time = juce::Time(record.timeMs);
+    return time.formatted("%Y-%m-%d %H:%M:%S.") +
+           juce::String(time.getMilliseconds()).paddedLeft('0', 3) + " " + levelName + " " +
+           message;
+}
+
+} // namespace aic::log
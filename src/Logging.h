@@ -0,0 +1,121 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <juce_core/juce_core.h>
+#include <memory>
+#include <vector>
+
+namespace aic::log
+{
+
+enum class Level : std::uint8_t
+{
+    Info,
+    Warning,
+    Error
+};
+
+/**
+ * @brief What happened, the message of each code is formatted by the logger thread.
+ */
+enum class Code : std::uint8_t
+{
+    LicenseNotFound,
+    LicenseReadFailed,
+    LicenseInvalid,
+    LicenseDirectoryFailed, // text: error message
+    LicenseWriteFailed,
+    ModelCreateFailed,     // model index, error code
+    ModelInitializeFailed, // model index, error code
+    ProcessingFailed,      // error code
+    ProcessingRecovered,
+    LockMemoryFailed,
+    TraceFileFailed,   // text: path
+    DeviceSetupFailed, // text: error message
+    RecordingFailed,   // text: path
+    RecordsDropped     // number of records
+};
+
+class Logger;
+
+namespace detail
+{
+// Set while a logger runs, records are dropped without one
+inline std::atomic<Logger*> activeLogger{nullptr};
+
+// Threads inside write(), the logger is only freed once none of them can still be using it
+inline std::atomic<int> numWriting{0};
+} // namespace detail
+
+/**
+ * @brief Queues a record for the log file. Real-time safe, never blocks or allocates.
+ *
+ * The record is dropped if the queue is full, the logger writes how many were dropped.
+ */
+void write(Level level, Code code, std::int64_t arg0 = 0, std::int64_t arg1 = 0) noexcept;
+
+/**
+ * @brief Queues a record with a text, which is truncated to 95 bytes.
+ */
+void write(Level level, Code code, const juce::String& text) noexcept;
+
+/**
+ * @brief Writes the queued records of all threads to a rotating log file while it exists.
+ *
+ * Held by every processor, one logger serves all instances of the process. The file is
+ * aic-sdk-plugin.log in the logs folder next to the license key file, it is rotated at 1 MB
+ * keeping two older files. Debug builds also print every record like DBG.
+ */
+class Logger : private juce::Thread
+{
+  public:
+    Logger();
+    ~Logger() override;
+
+    /**
+     * @brief Adds the record to the queue, false if it is full.
+     */
+    bool push(Level level, Code code, std::int64_t arg0, std::int64_t arg1,
+              const char* text) noexcept;
+
+    static juce::File getLogDirectory();
+
+  private:
+    static constexpr std::uint32_t capacity        = 1024;
+    static constexpr int           flushIntervalMs = 200;
+    static constexpr juce::int64   maxFileBytes    = 1024 * 1024;
+    static constexpr int           numRotatedFiles = 2;
+    static constexpr size_t        maxTextBytes    = 96;
+
+    struct Record
+    {
+        std::atomic<std::uint32_t>     sequence{0};
+        juce::int64                    timeMs{0};
+        std::int64_t                   arg0{0};
+        std::int64_t                   arg1{0};
+        Level                          level{Level::Info};
+        Code                           code{Code::LicenseNotFound};
+        std::array<char, maxTextBytes> text{};
+    };
+
+    void run() override;
+    void drain();
+    void writeLine(const juce::String& line);
+    void openFile();
+    void rotate();
+
+    static juce::String format(const Record& record);
+
+    std::unique_ptr<Record[]>               m_records;
+    std::atomic<std::uint32_t>              m_writePosition{0};
+    std::uint32_t                           m_readPosition{0};
+    std::atomic<std::uint32_t>              m_numDropped{0};
+    juce::File                              m_file;
+    std::unique_ptr<juce::FileOutputStream> m_stream;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Logger)
+};
+
+} // namespace aic::log
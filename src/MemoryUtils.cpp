@@ -0,0 +1,102 @@
+#include <juce_core/juce_core.h>
+
+#if JUCE_LINUX || JUCE_BSD
+#include <cstdio>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#elif JUCE_MAC
+#include <mach/mach.h>
+#elif JUCE_WINDOWS
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+// windows.h has to come first
+#include <psapi.h>
+#if JUCE_MSVC
+#pragma comment(lib, "psapi.lib")
+#endif
+#endif
+
+#include "MemoryUtils.h"
+
+namespace aic::memory
+{
+
+bool lockProcessMemory()
+{
+#if JUCE_LINUX || JUCE_BSD
+    return mlockall(MCL_CURRENT) == 0;
+#else
+    // macOS declares mlockall but does not implement it
+    return false;
+#endif
+}
+
+juce::int64 getResidentMemoryBytes()
+{
+#if JUCE_LINUX
+    // The second field is the number of resident pages
+    long  totalPages    = 0;
+    long  residentPages = 0;
+    FILE* statm         = std::fopen("/proc/self/statm", "r");
+    if (statm == nullptr)
+        return -1;
+
+    auto numFields = std::fscanf(statm, "%ld %ld", &totalPages, &residentPages);
+    std::fclose(statm);
+
+    if (numFields != 2)
+        return -1;
+
+    return static_cast<juce::int64>(residentPages) *
+           static_cast<juce::int64>(sysconf(_SC_PAGESIZE));
+#elif JUCE_MAC
+    mach_task_basic_info_data_t info;
+    mach_msg_type_number_t      count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info),
+                  &count) != KERN_SUCCESS)
+        return -1;
+
+    return static_cast<juce::int64>(info.resident_size);
+#elif JUCE_WINDOWS
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return -1;
+
+    return static_cast<juce::int64>(counters.WorkingSetSize);
+#else
+    return -1;
+#endif
+}
+
+juce::int64 getPeakResidentMemoryBytes()
+{
+#if JUCE_LINUX || JUCE_BSD
+    // Reported in kilobytes
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return -1;
+
+    return static_cast<juce::int64>(usage.ru_maxrss) * 1024;
+#elif JUCE_MAC
+    mach_task_basic_info_data_t info;
+    mach_msg_type_number_t      count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info),
+                  &count) != KERN_SUCCESS)
+        return -1;
+
+    return static_cast<juce::int64>(info.resident_size_max);
+#elif JUCE_WINDOWS
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return -1;
+
+    return static_cast<juce::int64>(counters.PeakWorkingSetSize);
+#else
+    return -1;
+#endif
+}
+
+} // namespace aic::memory
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+namespace aic::memory
+{
+
+/**
+ * @brief Locks all pages currently mapped by the process into RAM.
+ *
+ * Keeps the model weights from being paged out while the host is idle. This affects the whole
+ * host process, so it is opt-in. Only supported on Linux.
+ *
+ * @return true if the pages were locked
+ */
+bool lockProcessMemory();
+
+/**
+ * @brief Gets the resident memory of the whole process.
+ *
+ * Used to estimate the memory a model needs by measuring before and after creating it. Other
+ * threads of the host allocate concurrently, so the difference is an estimate.
+ *
+ * @return The resident set size in bytes, or -1 if it is not available on this platform
+ */
+juce::int64 getResidentMemoryBytes();
+
+/**
+ * @brief Gets the highest resident memory of the whole process since it started.
+ *
+ * @return The peak resident set size in bytes, or -1 if it is not available on this platform
+ */
+juce::int64 getPeakResidentMemoryBytes();
+
+/**
+ * @brief Gets the growth of the resident memory since the given measurement.
+ *
+ * @return The growth in bytes, 0 if the memory shrank, or -1 if either value is not available
+ */
+inline juce::int64 getResidentMemoryGrowth(juce::int64 residentBytesBefore)
+{
+    auto residentBytes = getResidentMemoryBytes();
+    if (residentBytesBefore < 0 || residentBytes < 0)
+        return -1;
+
+    return juce::jmax(static_cast<juce::int64>(0), residentBytes - residentBytesBefore);
+}
+
+} // namespace aic::memory
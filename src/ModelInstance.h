@@ -0,0 +1,85 @@
+#pragma once
+
+#include "BandSplitEngine.h"
+#include "EnhancementBackend.h"
+
+#include <cstdint>
+#include <memory>
+
+namespace aic
+{
+
+/**
+ * @brief Model and audio settings a model instance is built for.
+ */
+struct ModelConfig
+{
+    size_t   modelIndex{0};
+    bool     bandSplit{false};
+    uint32_t sampleRate{48000};
+    uint16_t numChannels{2};
+    size_t   numFrames{480};
+
+    bool operator==(const ModelConfig& other) const
+    {
+        return modelIndex == other.modelIndex && bandSplit == other.bandSplit &&
+               sampleRate == other.sampleRate && numChannels == other.numChannels &&
+               numFrames == other.numFrames;
+    }
+
+    bool operator!=(const ModelConfig& other) const
+    {
+        return !(*this == other);
+    }
+};
+
+/**
+ * @brief The values of the parameters a model processes with, read once per block.
+ */
+struct ModelParameters
+{
+    float bypass{0.0f};
+    float enhancement{1.0f};
+    float voiceGain{1.0f}; // Linear
+    float vadLookback{0.0f};
+    float vadSensitivity{0.0f};
+
+    bool operator==(const ModelParameters& other) const
+    {
+        return bypass == other.bypass && enhancement == other.enhancement &&
+               voiceGain == other.voiceGain && vadLookback == other.vadLookback &&
+               vadSensitivity == other.vadSensitivity;
+    }
+
+    bool operator!=(const ModelParameters& other) const
+    {
+        return !(*this == other);
+    }
+};
+
+/**
+ * @brief A model together with everything the audio thread needs to run it.
+ *
+ * Instances are built, initialized and warmed up away from the audio thread and handed over as a
+ * whole, so the audio thread never sees a model that is still being set up.
+ */
+struct ModelInstance
+{
+    ModelConfig config;
+
+    // The model and its VAD, from the SDK or a stand-in
+    std::unique_ptr<aic::EnhancementEngine> model;
+
+    aic::dsp::BandSplitEngine bandSplit;
+    bool                      bandSplitActive{false};
+
+    bool   initialized{false};
+    size_t outputDelaySamples{0};
+
+    // Growth of the resident memory while creating and while initializing the model, the latter
+    // includes the allocations of the first processed blocks. -1 if unknown.
+    std::int64_t createMemoryBytes{-1};
+    std::int64_t initializeMemoryBytes{-1};
+};
+
+} // namespace aic
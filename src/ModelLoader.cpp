@@ -0,0 +1,123 @@
+#include "ModelLoader.h"
+
+namespace aic
+{
+
+ModelLoader::ModelLoader(ConfigProvider configProvider, Builder builder,
+                         PublishCallback onPublish)
+    : juce::Thread("aic model loader"), m_configProvider(std::move(configProvider)),
+      m_builder(std::move(builder)), m_onPublish(std::move(onPublish))
+{
+}
+
+ModelLoader::~ModelLoader()
+{
+    stop();
+
+    delete m_recycled.exchange(nullptr);
+    delete m_published.exchange(nullptr);
+    collectRetired();
+}
+
+void ModelLoader::start()
+{
+    if (!isThreadRunning())
+        startThread(juce::Thread::Priority::normal);
+}
+
+void ModelLoader::stop()
+{
+    // Building can take a while, the SDK call in progress is not interruptible
+    stopThread(10000);
+}
+
+void ModelLoader::rebuild()
+{
+    m_rebuild.store(true);
+    notify();
+}
+
+void ModelLoader::recycle(std::unique_ptr<ModelInstance> instance)
+{
+    delete m_recycled.exchange(instance.release());
+    notify();
+}
+
+std::unique_ptr<ModelInstance> ModelLoader::reclaim()
+{
+    while (m_building.load() && isThreadRunning())
+        m_idle.wait(reclaimWaitMs);
+
+    if (auto* recycled = m_recycled.exchange(nullptr))
+    {
+        delete m_published.exchange(nullptr);
+        return std::unique_ptr<ModelInstance>(recycled);
+    }
+
+    return std::unique_ptr<ModelInstance>(m_published.exchange(nullptr));
+}
+
+std::unique_ptr<ModelInstance> ModelLoader::takePublished()
+{
+    if (m_retired.load() != nullptr)
+        return nullptr;
+
+    return std::unique_ptr<ModelInstance>(m_published.exchange(nullptr));
+}
+
+void ModelLoader::retire(std::unique_ptr<ModelInstance> instance)
+{
+    if (instance == nullptr)
+        return;
+
+    jassert(m_retired.load() == nullptr);
+    m_retired.store(instance.release());
+}
+
+void ModelLoader::collectRetired()
+{
+    delete m_retired.exchange(nullptr);
+}
+
+void ModelLoader::run()
+{
+    while (!threadShouldExit())
+    {
+        collectRetired();
+        m_building.store(true);
+
+        std::unique_ptr<ModelInstance> recycled(m_recycled.exchange(nullptr));
+        auto                           config  = m_configProvider();
+        auto                           rebuild = m_rebuild.exchange(false);
+
+        // A rebuild needs a new model, the recycled one was created with the old license
+        if (rebuild)
+            recycled.reset();
+
+        if (recycled != nullptr || rebuild || !m_hasBuilt || config != m_builtConfig)
+        {
+            auto instance = m_builder(config, std::move(recycled));
+            m_builtConfig = config;
+            m_hasBuilt    = true;
+
+            if (instance != nullptr)
+            {
+                m_onPublish(*instance);
+
+                // An instance that was never taken over is outdated by now
+                delete m_published.exchange(instance.release());
+            }
+
+            continue;
+        }
+
+        m_building.store(false);
+        m_idle.signal();
+
+        // Configuration changes, recycled instances and rebuilds wake the loader
+        auto handingOver = hasPublished() || m_retired.load() != nullptr;
+        wait(handingOver ? pollIntervalMs : -1);
+    }
+}
+
+} // namespace aic
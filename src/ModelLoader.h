@@ -0,0 +1,138 @@
+#pragma once
+
+#include "ModelInstance.h"
+
+#include <atomic>
+#include <functional>
+#include <juce_core/juce_core.h>
+#include <memory>
+
+namespace aic
+{
+
+/**
+ * @brief Builds model instances on a background thread and publishes them to the audio thread.
+ *
+ * The loader builds a new instance when it is woken and the desired configuration changed, or
+ * when an instance is recycled for it to finish, e.g. to warm up a model that was just
+ * initialized. It sleeps until then, only polling while the audio thread takes an instance over.
+ *
+ * Finished instances are published through an atomic pointer, the audio thread takes them over at
+ * the start of a block and hands the instance it replaced back for deletion. No model is created,
+ * initialized or destroyed on the audio thread.
+ */
+class ModelLoader : private juce::Thread
+{
+  public:
+    using ConfigProvider = std::function<ModelConfig()>;
+
+    /**
+     * @brief Builds an instance for the configuration, reusing the given instance if possible.
+     *
+     * @return The finished instance, or nullptr if no model could be created
+     */
+    using Builder = std::function<std::unique_ptr<ModelInstance>(
+        const ModelConfig& config, std::unique_ptr<ModelInstance> reuse)>;
+
+    /**
+     * @brief Called on the loader thread right before an instance is published.
+     */
+    using PublishCallback = std::function<void(const ModelInstance& instance)>;
+
+    ModelLoader(ConfigProvider configProvider, Builder builder, PublishCallback onPublish);
+    ~ModelLoader() override;
+
+    void start();
+    void stop();
+
+    /**
+     * @brief Wakes the loader after the desired configuration changed.
+     *
+     * Must be called for every change, the loader does not poll the configuration.
+     */
+    void configChanged()
+    {
+        notify();
+    }
+
+    /**
+     * @brief Builds a new instance even if the configuration did not change, e.g. after the
+     * license changed.
+     */
+    void rebuild();
+
+    /**
+     * @brief Hands an instance to the loader to be finished and published. Not real-time safe.
+     */
+    void recycle(std::unique_ptr<ModelInstance> instance);
+
+    /**
+     * @brief Takes back the newest instance that was not taken over yet. Not real-time safe.
+     *
+     * Waits for a build in progress first, it would publish afterwards and overwrite the
+     * instance prepared in its place.
+     *
+     * @return The recycled or the published instance, or nullptr if there is none
+     */
+    std::unique_ptr<ModelInstance> reclaim();
+
+    /**
+     * @brief Takes over the published instance. Real-time safe.
+     *
+     * @return The published instance, or nullptr if there is none or the previous instance was
+     * not collected yet
+     */
+    std::unique_ptr<ModelInstance> takePublished();
+
+    /**
+     * @brief Hands an instance back to be deleted on the loader thread. Real-time safe.
+     *
+     * Only one instance can be pending at a time, takePublished() waits for it to be collected.
+     */
+    void retire(std::unique_ptr<ModelInstance> instance);
+
+    bool hasPublished() const
+    {
+        return m_published.load() != nullptr;
+    }
+
+    /**
+     * @brief Whether the loader is building or has instances waiting to be taken over.
+     */
+    bool isBusy() const
+    {
+        return m_building.load() || m_recycled.load() != nullptr || hasPublished();
+    }
+
+  private:
+    // While an instance is handed over, the loader checks this often whether the audio thread
+    // took it and retired the one it replaced
+    static constexpr int pollIntervalMs = 50;
+
+    // Upper bound for one wait of reclaim(), checked again until the build is finished
+    static constexpr int reclaimWaitMs = 100;
+
+    void run() override;
+
+    void collectRetired();
+
+    ConfigProvider  m_configProvider;
+    Builder         m_builder;
+    PublishCallback m_onPublish;
+
+    ModelConfig m_builtConfig;
+    bool        m_hasBuilt{false};
+
+    std::atomic<bool>           m_rebuild{false};
+    std::atomic<bool>           m_building{false};
+    std::atomic<ModelInstance*> m_recycled{nullptr};
+    std::atomic<ModelInstance*> m_published{nullptr};
+    std::atomic<ModelInstance*> m_retired{nullptr};
+
+    // Signalled whenever the loader stops building
+    juce::WaitableEvent m_idle;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ModelLoader)
+};
+
+} // namespace aic
@@ -0,0 +1,199 @@
+#include "OfflineRenderer.h"
+
+#include "Tracing.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace aic::dsp
+{
+
+OfflineRenderer::OfflineRenderer(LaneCallback callback) : m_render(std::move(callback)) {}
+
+OfflineRenderer::~OfflineRenderer()
+{
+    release();
+}
+
+void OfflineRenderer::prepare(int numLanes, int numChannels, int segmentSamples,
+                              int historySamples)
+{
+    release();
+
+    m_numLanes       = juce::jmax(1, numLanes);
+    m_numChannels    = numChannels;
+    m_historySamples = juce::jmax(0, historySamples);
+    m_segmentSamples = juce::jmax(m_historySamples, segmentSamples);
+    m_chunkSamples   = m_numLanes * m_segmentSamples;
+
+    m_pending.setSize(numChannels, m_historySamples + m_chunkSamples);
+    m_pendingChanges.reserve(maxChangesPerChunk);
+    m_ready.setSize(numChannels, m_chunkSamples);
+    m_readySpeech.resize(static_cast<size_t>(m_chunkSamples));
+
+    const auto laneSamples = static_cast<size_t>(m_historySamples + m_segmentSamples);
+    m_laneBuffers.resize(static_cast<size_t>(m_numLanes));
+    m_laneChanges.resize(static_cast<size_t>(m_numLanes));
+    m_laneSpeech.resize(static_cast<size_t>(m_numLanes));
+    for (size_t lane = 0; lane < m_laneBuffers.size(); ++lane)
+    {
+        m_laneBuffers[lane].setSize(numChannels, static_cast<int>(laneSamples));
+        m_laneChanges[lane].reserve(maxChangesPerChunk);
+        m_laneSpeech[lane].resize(laneSamples);
+    }
+
+    reset();
+
+    m_pool = std::make_unique<juce::ThreadPool>(juce::ThreadPoolOptions{}
+                                                    .withThreadName("aic offline renderer")
+                                                    .withNumberOfThreads(m_numLanes));
+}
+
+void OfflineRenderer::release()
+{
+    m_pool.reset();
+    m_laneBuffers.clear();
+    m_laneChanges.clear();
+    m_laneSpeech.clear();
+    m_pending.setSize(0, 0);
+    m_pendingChanges.clear();
+    m_ready.setSize(0, 0);
+    m_readySpeech.clear();
+}
+
+void OfflineRenderer::reset()
+{
+    // The first chunk has silence as history and outputs silence while it is collected
+    m_pending.clear();
+    m_pendingChanges.clear();
+    m_ready.clear();
+    std::fill(m_readySpeech.begin(), m_readySpeech.end(), std::uint8_t{0});
+    m_position = 0;
+}
+
+bool OfflineRenderer::process(float* const* channels, int numChannels, int numSamples,
+                              const aic::ModelParameters& parameters)
+{
+    const auto numProcessed = juce::jmin(numChannels, m_numChannels);
+    auto       speech       = false;
+
+    for (int offset = 0; offset < numSamples;)
+    {
+        const auto count = juce::jmin(numSamples - offset, m_chunkSamples - m_position);
+
+        recordParameters(m_historySamples + m_position, parameters);
+
+        for (int ch = 0; ch < numProcessed; ++ch)
+        {
+            m_pending.copyFrom(ch, m_historySamples + m_position, channels[ch] + offset, count);
+            juce::FloatVectorOperations::copy(channels[ch] + offset,
+                                              m_ready.getReadPointer(ch, m_position), count);
+        }
+
+        speech = m_readySpeech[static_cast<size_t>(m_position + count - 1)] != 0;
+
+        offset += count;
+        m_position += count;
+
+        if (m_position == m_chunkSamples)
+        {
+            renderChunk();
+            m_position = 0;
+        }
+    }
+
+    return speech;
+}
+
+void OfflineRenderer::recordParameters(int position, const aic::ModelParameters& parameters)
+{
+    // The first block after a reset also applies to the silent history before it
+    if (m_pendingChanges.empty())
+    {
+        m_pendingChanges.push_back({0, parameters});
+        return;
+    }
+
+    auto& last = m_pendingChanges.back();
+    if (last.parameters == parameters)
+        return;
+
+    if (last.position == position || m_pendingChanges.size() == maxChangesPerChunk)
+        last.parameters = parameters;
+    else
+        m_pendingChanges.push_back({position, parameters});
+}
+
+void OfflineRenderer::renderChunk()
+{
+    const aic::trace::ScopedSpan span("offline chunk");
+
+    m_numRendering.store(m_numLanes);
+
+    for (int lane = 0; lane < m_numLanes; ++lane)
+    {
+        m_pool->addJob(
+            [this, lane]()
+            {
+                auto&      buffer  = m_laneBuffers[static_cast<size_t>(lane)];
+                auto&      changes = m_laneChanges[static_cast<size_t>(lane)];
+                auto&      speech  = m_laneSpeech[static_cast<size_t>(lane)];
+                const auto start   = lane * m_segmentSamples;
+                const auto end     = start + buffer.getNumSamples();
+
+                // The segment starts in the pending buffer right after its history
+                for (int ch = 0; ch < m_numChannels; ++ch)
+                    buffer.copyFrom(ch, 0, m_pending, ch, start, buffer.getNumSamples());
+
+                // The parameters in effect at the start of the lane, followed by its changes
+                changes.clear();
+                for (const auto& change : m_pendingChanges)
+                {
+                    if (change.position >= end)
+                        break;
+
+                    const auto position = juce::jmax(0, change.position - start);
+                    if (!changes.empty() && changes.back().position == position)
+                        changes.back().parameters = change.parameters;
+                    else
+                        changes.push_back({position, change.parameters});
+                }
+
+                Segment segment;
+                segment.channels    = buffer.getArrayOfWritePointers();
+                segment.numChannels = m_numChannels;
+                segment.numSamples  = buffer.getNumSamples();
+                segment.changes     = changes.data();
+                segment.numChanges  = static_cast<int>(changes.size());
+                segment.speech      = speech.data();
+                m_render(lane, segment);
+
+                for (int ch = 0; ch < m_numChannels; ++ch)
+                    m_ready.copyFrom(ch, start, buffer, ch, m_historySamples, m_segmentSamples);
+
+                std::copy_n(speech.begin() + m_historySamples, m_segmentSamples,
+                            m_readySpeech.begin() + start);
+
+                if (m_numRendering.fetch_sub(1) == 1)
+                    m_rendered.signal();
+            });
+    }
+
+    m_rendered.wait();
+
+    // The end of this chunk is the history of the first segment of the next one
+    for (int ch = 0; ch < m_numChannels; ++ch)
+        m_pending.copyFrom(ch, 0, m_pending, ch, m_chunkSamples, m_historySamples);
+
+    // So are the parameters in effect from its start on
+    auto first = m_pendingChanges.begin();
+    for (auto next = std::next(first);
+         next != m_pendingChanges.end() && next->position <= m_chunkSamples; ++next)
+        first = next;
+
+    m_pendingChanges.erase(m_pendingChanges.begin(), first);
+    for (auto& change : m_pendingChanges)
+        change.position = juce::jmax(0, change.position - m_chunkSamples);
+}
+
+} // namespace aic::dsp
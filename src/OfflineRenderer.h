@@ -0,0 +1,146 @@
+#pragma once
+
+#include "ModelInstance.h"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_core/juce_core.h>
+#include <memory>
+#include <vector>
+
+namespace aic::dsp
+{
+
+/**
+ * @brief Renders offline bounces in large chunks whose segments are processed in parallel.
+ *
+ * A model processes a stream strictly in order, so a bounce runs on one core no matter how many
+ * there are. The renderer collects the input into chunks of one segment per lane and delays the
+ * output by a chunk. When a chunk is complete, every lane renders its segment with its own model
+ * on a thread of a pool. A lane starts from a reset model which is primed with the history before
+ * the segment, so the segments join seamlessly as long as the history determines the model state.
+ *
+ * The parameters of every block are collected with its input and the VAD result of every sample
+ * is output with it, so both apply to the same audio as in a realtime render.
+ *
+ * Only meant for non-realtime rendering, the audio thread waits for the lanes at chunk boundaries.
+ */
+class OfflineRenderer
+{
+  public:
+    /**
+     * @brief The parameters from a position of a segment on.
+     */
+    struct ParameterChange
+    {
+        int                  position{0};
+        aic::ModelParameters parameters;
+    };
+
+    /**
+     * @brief The input of a lane, its history followed by the segment.
+     */
+    struct Segment
+    {
+        float* const* channels{nullptr};
+        int           numChannels{0};
+        int           numSamples{0};
+
+        // Sorted by position, the first one at 0
+        const ParameterChange* changes{nullptr};
+        int                    numChanges{0};
+
+        // Written by the lane, whether the model detected speech after processing each sample
+        std::uint8_t* speech{nullptr};
+    };
+
+    /**
+     * @brief Renders a segment with the model of the lane, in place, on a thread of the pool.
+     *
+     * The model has to be reset first, the first history samples only prime it.
+     */
+    using LaneCallback = std::function<void(int lane, const Segment& segment)>;
+
+    explicit OfflineRenderer(LaneCallback callback);
+    ~OfflineRenderer();
+
+    /**
+     * @brief Allocates the buffers and starts a thread per lane. Not real-time safe.
+     *
+     * @param numLanes Number of segments rendered in parallel, each with its own model
+     * @param numChannels Number of channels to process
+     * @param segmentSamples Length of a segment, at least the history
+     * @param historySamples Input before a segment the model of its lane is primed with
+     */
+    void prepare(int numLanes, int numChannels, int segmentSamples, int historySamples);
+
+    /**
+     * @brief Stops the threads and frees the buffers.
+     */
+    void release();
+
+    /**
+     * @brief Clears the collected input and the output still to come.
+     */
+    void reset();
+
+    /**
+     * @brief Collects the block and outputs the block a chunk before it, renders full chunks.
+     *
+     * @param parameters The parameters the block is rendered with
+     * @return Whether the model detected speech at the end of the output block
+     */
+    bool process(float* const* channels, int numChannels, int numSamples,
+                 const aic::ModelParameters& parameters);
+
+    bool isPrepared() const
+    {
+        return m_pool != nullptr;
+    }
+
+    /**
+     * @brief The delay of the output, one chunk. 0 while not prepared.
+     */
+    int getLatencySamples() const
+    {
+        return isPrepared() ? m_chunkSamples : 0;
+    }
+
+  private:
+    // More changes per chunk only make the last one apply earlier, nothing is allocated
+    static constexpr size_t maxChangesPerChunk = 4096;
+
+    void recordParameters(int position, const aic::ModelParameters& parameters);
+    void renderChunk();
+
+    LaneCallback m_render;
+
+    int m_numLanes{0};
+    int m_numChannels{0};
+    int m_segmentSamples{0};
+    int m_historySamples{0};
+    int m_chunkSamples{0};
+
+    // The history of the first segment followed by the chunk being collected, with the
+    // parameters from the start of the history on
+    juce::AudioBuffer<float>     m_pending;
+    std::vector<ParameterChange> m_pendingChanges;
+    int                          m_position{0};
+
+    // The rendered previous chunk, output while the next one is collected
+    juce::AudioBuffer<float>  m_ready;
+    std::vector<std::uint8_t> m_readySpeech;
+
+    std::vector<juce::AudioBuffer<float>>     m_laneBuffers;
+    std::vector<std::vector<ParameterChange>> m_laneChanges;
+    std::vector<std::vector<std::uint8_t>>    m_laneSpeech;
+    std::unique_ptr<juce::ThreadPool>     m_pool;
+    std::atomic<int>                      m_numRendering{0};
+    juce::WaitableEvent                   m_rendered;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OfflineRenderer)
+};
+
+} // namespace aic::dsp
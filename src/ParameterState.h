@@ -0,0 +1,36 @@
+#pragma once
+
+#include "RealtimeSafety.h"
+
+#include <atomic>
+#include <juce_audio_processors/juce_audio_processors.h>
+
+namespace aic
+{
+
+/**
+ * @brief The parameter tree of the plugin, reporting lookups by ID in real-time scopes.
+ *
+ * A lookup searches the parameters by their string IDs. The processor looks up the values it
+ * reads while processing once in its constructor, aic-rtcheck fails on any lookup processBlock
+ * still makes.
+ */
+class ParameterState : public juce::AudioProcessorValueTreeState
+{
+  public:
+    using juce::AudioProcessorValueTreeState::AudioProcessorValueTreeState;
+
+    std::atomic<float>* getRawParameterValue(juce::StringRef parameterID) const noexcept
+    {
+        realtime::reportCall("parameter lookup by ID");
+        return juce::AudioProcessorValueTreeState::getRawParameterValue(parameterID);
+    }
+
+    juce::RangedAudioParameter* getParameter(juce::StringRef parameterID) const noexcept
+    {
+        realtime::reportCall("parameter lookup by ID");
+        return juce::AudioProcessorValueTreeState::getParameter(parameterID);
+    }
+};
+
+} // namespace aic
@@ -8,18 +8,32 @@
 
 #include <juce_graphics/juce_graphics.h>
 
+namespace
+{
+// Property of the state tree, saved with the plugin state
+const juce::Identifier deviceProfileId("deviceProfile");
+} // namespace
+
 //==============================================================================
 AicDemoAudioProcessorEditor::AicDemoAudioProcessorEditor(AicDemoAudioProcessor& p)
     : AudioProcessorEditor(&p), processorRef(p),
       modelSelectorAttachment(p.state, "model", modelSelector),
       enhancementAttachment(p.state, "enhancement", enhancementSlider),
       m_licenseDialog([this](const juce::String& licenseKey)
-                      { return handleLicenseValidation(licenseKey); },
-                      processorRef.isLicenseValid())
+                      { handleLicenseValidation(licenseKey); },
+                      processorRef.isLicenseValid()),
+      m_licenseValid(p.isLicenseValid()), m_background(p.getSdkVersion()),
+      m_spectrumView(p.getSpectrumAnalyzer()), m_refreshRegistration(*this, [this]() { refresh(); })
 {
+    setOpaque(true);
+    addAndMakeVisible(m_background);
+
     // Set up close callback for license dialog to hide overlay when closed
     m_licenseDialog.setCloseCallback([this]() { hideModalOverlay(); });
 
+    // The result of an activation started by a previous editor has no dialog to go to
+    processorRef.takeLicenseActivationResult();
+
     getLookAndFeel().setDefaultSansSerifTypeface(getFont());
 
     // Set up license button
@@ -39,12 +53,51 @@ AicDemoAudioProcessorEditor::AicDemoAudioProcessorEditor(AicDemoAudioProcessor&
     modelSelector.setSelectedItemIndex(
         static_cast<int>(processorRef.state.getRawParameterValue("model")->load()));
 
+    // The standalone app follows the model with its device, plugins leave it to the host
+    m_deviceConfigurator = aic::DeviceConfigurator::create([this]() { updateModelInfo(); });
+    if (m_deviceConfigurator != nullptr)
+    {
+        modelInfoBox.setShowsEndToEndLatency(true);
+
+        m_deviceProfileSelector.addItemList(aic::DeviceConfigurator::getProfileNames(), 1);
+        m_deviceProfileSelector.onChange = [this]()
+        {
+            processorRef.state.state.setProperty(
+                deviceProfileId, m_deviceProfileSelector.getSelectedItemIndex(), nullptr);
+            applyDeviceProfile();
+        };
+        addAndMakeVisible(m_deviceProfileSelector);
+
+        applyDeviceProfile();
+    }
+
     updateModelInfo();
     addAndMakeVisible(modelInfoBox);
 
-    m_logo =
-        juce::Drawable::createFromImageData(BinaryData::aic_logo_svg, BinaryData::aic_logo_svgSize);
-    addAndMakeVisible(m_logo.get());
+    // Field recordings without a DAW running alongside
+    if (juce::JUCEApplicationBase::isStandaloneApp())
+    {
+        m_recordButton.setColour(juce::TextButton::buttonColourId,
+                                 juce::Colours::transparentBlack);
+        m_recordButton.setColour(juce::TextButton::buttonOnColourId,
+                                 juce::Colours::transparentBlack);
+        m_recordButton.setColour(juce::TextButton::textColourOffId, aic::ui::BLACK_70);
+        m_recordButton.setButtonText("Record");
+        m_recordButton.setMouseCursor(juce::MouseCursor::PointingHandCursor);
+        m_recordButton.onClick = [this]() { showRecordMenu(); };
+        addAndMakeVisible(m_recordButton);
+        updateRecordButton();
+    }
+
+    // Events queued while no editor was open are outdated, start from the current result
+    m_vadEvents.reserve(256);
+    processorRef.collectEditorVadEvents(m_vadEvents);
+    m_vadEvents.assign(1, {processorRef.getVadPosition(), processorRef.isSpeechDetected()});
+    m_vadTimeline.update(m_vadEvents, processorRef.getVadPosition(), processorRef.getSampleRate());
+    addAndMakeVisible(m_vadTimeline);
+
+    addAndMakeVisible(m_levelMeter);
+    addAndMakeVisible(m_spectrumView);
 
     // Check if license is valid and show dialog if needed
     if (!processorRef.isLicenseValid())
@@ -59,95 +112,104 @@ AicDemoAudioProcessorEditor::AicDemoAudioProcessorEditor(AicDemoAudioProcessor&
                                     });
     }
 
-    startTimer(100);
-
     setResizable(false, false);
 
     // Make sure that before the constructor has finished, you've set the
     // editor's size to whatever you need it to be.
-    setSize(454, 512);
+    setSize(454, m_deviceConfigurator != nullptr ? 810 : 780);
 }
 
-AicDemoAudioProcessorEditor::~AicDemoAudioProcessorEditor()
-{
-    stopTimer();
-}
+AicDemoAudioProcessorEditor::~AicDemoAudioProcessorEditor() = default;
 
 //==============================================================================
-void AicDemoAudioProcessorEditor::paint(juce::Graphics& g)
+AicDemoAudioProcessorEditor::Background::Background(const juce::String& sdkVersion)
+    : m_sdkVersion(sdkVersion),
+      m_logo(juce::Drawable::createFromImageData(BinaryData::aic_logo_svg,
+                                                 BinaryData::aic_logo_svgSize))
 {
-    g.fillAll(aic::ui::BLACK_0);
+    setOpaque(true);
+    setInterceptsMouseClicks(false, false);
+    setBufferedToImage(true);
+}
 
-    auto bounds = getLocalBounds();
-    bounds.reduce(35.f, 33.f);
+void AicDemoAudioProcessorEditor::Background::setAreas(const Areas& areas)
+{
+    m_areas = areas;
+    repaint();
+}
 
-    // Position license button
-    m_licenseButton.setBounds(bounds.removeFromTop(16).removeFromRight(120));
+void AicDemoAudioProcessorEditor::Background::paint(juce::Graphics& g)
+{
+    g.fillAll(aic::ui::BLACK_0);
 
     g.setColour(aic::ui::BLACK_70);
     g.setFont(16.f);
-    g.drawText("Model", bounds.removeFromTop(24), juce::Justification::centredLeft);
+    g.drawText("Model", m_areas.model, juce::Justification::centredLeft);
+    g.drawText("Enhancement Level", m_areas.enhancement, juce::Justification::centredLeft);
+    g.drawText("Voice Activity Detection", m_areas.vad, juce::Justification::centredLeft);
 
-    bounds.removeFromTop(8.f);
+    auto spectrumHeader = m_areas.spectrum;
+    g.drawText("Spectrum", spectrumHeader, juce::Justification::centredLeft);
 
-    modelSelector.setBounds(bounds.removeFromTop(40));
+    g.setFont(14.f);
+    g.setColour(aic::ui::BLUE_50);
+    g.drawText("Output", spectrumHeader.removeFromRight(50), juce::Justification::centredRight);
+    g.setColour(aic::ui::BLACK_40);
+    g.drawText("Input", spectrumHeader.removeFromRight(50), juce::Justification::centredRight);
 
-    bounds.removeFromTop(8.f);
+    if (m_logo != nullptr)
+        m_logo->drawWithin(g, m_areas.logo.toFloat(), juce::RectanglePlacement::centred, 1.0f);
 
-    modelInfoBox.setBounds(bounds.removeFromTop(160));
+    g.setColour(aic::ui::BLACK_70);
+    g.drawText(m_sdkVersion, m_areas.sdkVersion, juce::Justification::centredRight);
+}
 
-    bounds.removeFromTop(24.f);
+//==============================================================================
+void AicDemoAudioProcessorEditor::resized()
+{
+    Background::Areas areas;
 
-    g.setColour(aic::ui::BLACK_70);
-    g.setFont(16.f);
-    g.drawText("Enhancement Level", bounds.removeFromTop(24), juce::Justification::centredLeft);
+    auto bounds = getLocalBounds();
+    bounds.reduce(35, 33);
 
-    enhancementSlider.setBounds(bounds.removeFromTop(54.f).expanded(7, 0));
+    m_licenseButton.setBounds(bounds.removeFromTop(16).removeFromRight(120));
 
-    bounds.removeFromTop(24.f);
+    areas.model = bounds.removeFromTop(24);
+    m_deviceProfileSelector.setBounds(areas.model.withLeft(areas.model.getRight() - 200));
+    bounds.removeFromTop(8);
+    modelSelector.setBounds(bounds.removeFromTop(40));
+    bounds.removeFromTop(8);
 
-    // Voice Activity Detection
-    auto vadArea = bounds.removeFromTop(20);
-    g.setColour(aic::ui::BLACK_70);
-    g.setFont(16.f);
-    g.drawText("Voice Activity Detection", vadArea, juce::Justification::centredLeft);
+    // One more line with the end-to-end latency of the standalone app
+    modelInfoBox.setBounds(bounds.removeFromTop(m_deviceConfigurator != nullptr ? 226 : 196));
 
-    // VAD indicator circle on the right
-    const float circleSize = 20.0f;
-    auto circleArea = vadArea.removeFromRight(static_cast<int>(circleSize));
-    auto circleBounds = circleArea.toFloat().withSizeKeepingCentre(circleSize, circleSize);
+    bounds.removeFromTop(24);
+    areas.enhancement = bounds.removeFromTop(24);
+    enhancementSlider.setBounds(bounds.removeFromTop(54).expanded(7, 0));
 
-    if (m_speechDetected)
-    {
-        g.setColour(aic::ui::ROSA_SHADE);
-        g.fillEllipse(circleBounds);
-        g.setColour(aic::ui::ROSA_TINT);
-        g.fillEllipse(circleBounds.reduced(3.f));
-    }
-    else
-    {
-        g.setColour(aic::ui::BLACK_20);
-        g.fillEllipse(circleBounds);
-        g.setColour(aic::ui::BLACK_0);
-        g.fillEllipse(circleBounds.reduced(3.f));
-    }
+    // Voice Activity Detection, timeline and indicator on the right
+    bounds.removeFromTop(24);
+    areas.vad = bounds.removeFromTop(20);
+    m_vadTimeline.setBounds(areas.vad.removeFromRight(180));
+
+    bounds.removeFromTop(24);
+    m_levelMeter.setBounds(bounds.removeFromTop(56));
 
-    bounds.removeFromTop(24.f);
+    bounds.removeFromTop(24);
+    areas.spectrum = bounds.removeFromTop(20);
+    bounds.removeFromTop(8);
+    m_spectrumView.setBounds(bounds.removeFromTop(100));
 
     // Footer
-    auto footer = bounds.removeFromTop(20);
+    bounds.removeFromTop(24);
+    auto footer      = bounds.removeFromTop(20);
+    areas.logo       = footer.removeFromLeft(100);
+    areas.sdkVersion = footer.removeFromRight(100);
+    m_recordButton.setBounds(footer.reduced(4, 0));
 
-    m_logo->setTransformToFit(footer.removeFromLeft(100).toFloat(),
-                              juce::RectanglePlacement::centred);
+    m_background.setBounds(getLocalBounds());
+    m_background.setAreas(areas);
 
-    g.setColour(aic::ui::BLACK_70);
-    g.setFont(14.f);
-    g.drawText(processorRef.getSdkVersion(), footer.removeFromRight(100),
-               juce::Justification::centredRight);
-}
-
-void AicDemoAudioProcessorEditor::resized()
-{
     // Update modal overlay bounds if it's currently visible
     if (m_modalOverlay && m_modalOverlay->isVisible())
     {
@@ -155,17 +217,17 @@ void AicDemoAudioProcessorEditor::resized()
     }
 }
 
-void AicDemoAudioProcessorEditor::timerCallback()
+void AicDemoAudioProcessorEditor::refresh()
 {
-    static bool lastLicenseState    = processorRef.isLicenseValid();
-    bool        currentLicenseState = processorRef.isLicenseValid();
+    const aic::trace::ScopedSpan span("editor refresh");
+
+    bool currentLicenseState = processorRef.isLicenseValid();
 
     // Check if license state changed
-    if (lastLicenseState != currentLicenseState)
+    if (m_licenseValid != currentLicenseState)
     {
-        lastLicenseState = currentLicenseState;
-        updateLicenseButton(); // Update button text and color
-        repaint();             // Repaint to update license status display
+        m_licenseValid = currentLicenseState;
+        updateLicenseButton(); // Only the button repaints, the rest does not depend on it
 
         // If license became invalid, show the dialog
         if (!currentLicenseState)
@@ -175,25 +237,135 @@ void AicDemoAudioProcessorEditor::timerCallback()
         }
     }
 
+    updateLicenseActivation();
+    updateRecordButton();
+
     if (processorRef.modelChanged())
     {
         processorRef.acknowledgeModelChanged();
+        applyDeviceProfile();
         updateModelInfo();
     }
 
-    bool speechDetected = processorRef.isSpeechDetected();
-    if (speechDetected != m_speechDetected) {
-        m_speechDetected = speechDetected;
-        repaint();
-    }
+    // Only the timeline repaints itself, and only if it moved or got new events
+    m_vadEvents.clear();
+    processorRef.collectEditorVadEvents(m_vadEvents);
+    m_vadTimeline.update(m_vadEvents, processorRef.getVadPosition(), processorRef.getSampleRate());
+
+    auto levels = processorRef.getMeterLevels();
+    m_levelMeter.setLevels(levels.input, levels.output);
+
+    m_spectrumView.refresh();
 }
 
 void AicDemoAudioProcessorEditor::updateModelInfo()
 {
     auto modelInfo = processorRef.getModelInfo();
+
+    if (m_deviceConfigurator != nullptr)
+        modelInfo.endToEndLatency = aic::ui::ModelInfo::formatMilliseconds(
+            m_deviceConfigurator->getEndToEndLatencyMs(processorRef.getLatencySamples()));
+
     modelInfoBox.setModelInfo(modelInfo);
 }
 
+void AicDemoAudioProcessorEditor::applyDeviceProfile()
+{
+    if (m_deviceConfigurator == nullptr)
+        return;
+
+    // Read every time, restoring a state replaces the tree
+    using Profile = aic::DeviceConfigurator::Profile;
+    auto index    = juce::jlimit(static_cast<int>(Profile::Off),
+                                 static_cast<int>(Profile::LowestLatency),
+                                 static_cast<int>(processorRef.state.state.getProperty(
+                                     deviceProfileId, static_cast<int>(Profile::Off))));
+    m_deviceProfileSelector.setSelectedItemIndex(index, juce::dontSendNotification);
+
+    auto optimum = processorRef.getModelOptimum();
+    m_deviceConfigurator->apply(static_cast<Profile>(index), optimum.sampleRate,
+                                optimum.numFrames);
+}
+
+void AicDemoAudioProcessorEditor::showRecordMenu()
+{
+    auto& recorder = processorRef.getDiskRecorder();
+    if (recorder.isRecording())
+    {
+        recorder.stop();
+        updateRecordButton();
+        return;
+    }
+
+    using Format = aic::DiskRecorder::Format;
+
+    juce::PopupMenu menu;
+    menu.addItem("Record WAV", [this]() { startRecording(Format::Wav); });
+    menu.addItem("Record Raw Float", [this]() { startRecording(Format::RawFloat); });
+    menu.addSeparator();
+    menu.addItem("Show Recordings",
+                 []()
+                 {
+                     auto directory = aic::DiskRecorder::getDefaultDirectory();
+                     directory.createDirectory();
+                     directory.startAsProcess();
+                 });
+
+    menu.showMenuAsync(juce::PopupMenu::Options().withTargetComponent(m_recordButton));
+}
+
+void AicDemoAudioProcessorEditor::startRecording(aic::DiskRecorder::Format format)
+{
+    auto directory = aic::DiskRecorder::getDefaultDirectory();
+    if (!processorRef.getDiskRecorder().start(directory, format))
+    {
+        juce::AlertWindow::showAsync(
+            juce::MessageBoxOptions()
+                .withIconType(juce::MessageBoxIconType::WarningIcon)
+                .withTitle("Recording Failed")
+                .withMessage("The files could not be created in " + directory.getFullPathName())
+                .withButton("OK"),
+            nullptr);
+    }
+
+    updateRecordButton();
+}
+
+void AicDemoAudioProcessorEditor::updateRecordButton()
+{
+    if (!m_recordButton.isVisible())
+        return;
+
+    auto& recorder = processorRef.getDiskRecorder();
+    if (!recorder.isRecording())
+    {
+        if (m_recordedSeconds < 0)
+            return;
+
+        m_recordedSeconds = -1;
+        m_droppedSamples  = -1;
+        m_recordButton.setButtonText("Record");
+        m_recordButton.setColour(juce::TextButton::textColourOffId, aic::ui::BLACK_70);
+        return;
+    }
+
+    auto seconds = static_cast<juce::int64>(recorder.getNumRecordedSamples() /
+                                            juce::jmax(1.0, recorder.getSampleRate()));
+    auto dropped = recorder.getNumDroppedSamples();
+    if (seconds == m_recordedSeconds && dropped == m_droppedSamples)
+        return;
+
+    m_recordedSeconds = seconds;
+    m_droppedSamples  = dropped;
+
+    auto time = juce::String::formatted("%02d:%02d:%02d", static_cast<int>(seconds / 3600),
+                                        static_cast<int>(seconds / 60 % 60),
+                                        static_cast<int>(seconds % 60));
+    m_recordButton.setButtonText("Stop " + time + ", " + juce::String(dropped) + " dropped");
+    m_recordButton.setColour(juce::TextButton::textColourOffId,
+                             dropped > 0 ? juce::Colours::red : aic::ui::BLACK_100);
+}
+
 void AicDemoAudioProcessorEditor::showModalOverlay()
 {
     if (!m_modalOverlay)
@@ -203,7 +375,10 @@ void AicDemoAudioProcessorEditor::showModalOverlay()
 
     addAndMakeVisible(m_modalOverlay.get());
     m_modalOverlay->setBounds(getLocalBounds());
-    m_modalOverlay->toBack(); // Keep overlay behind other components
+
+    // Keep overlay behind other components, but in front of the background
+    m_modalOverlay->toBack();
+    m_background.toBack();
 }
 
 void AicDemoAudioProcessorEditor::hideModalOverlay()
@@ -214,45 +389,32 @@ void AicDemoAudioProcessorEditor::hideModalOverlay()
     }
 }
 
-bool AicDemoAudioProcessorEditor::handleLicenseValidation(const juce::String& licenseKey)
+void AicDemoAudioProcessorEditor::handleLicenseValidation(const juce::String& licenseKey)
 {
-    // Trim whitespace from the license key
-    juce::String trimmedKey = licenseKey.trim();
-
-    if (trimmedKey.isEmpty())
-    {
-        return false; // Empty license key is invalid
-    }
-
-    // Validate the license key using the processor
-    if (processorRef.validateLicenseKey(trimmedKey))
-    {
-        // License is valid, save it and update the processor's license
-        if (processorRef.saveLicenseKey(trimmedKey))
-        {
-            // Reload and validate the license in the processor
-            if (processorRef.loadAndValidateLicense())
-            {
-                // Force recreation of the current model with the new license
-                processorRef.forceModelRecreation();
-
-                // Force update the model info since we now have a valid license
-                updateModelInfo();
+    // Creating a model takes seconds, the processor checks the key on its loader thread
+    processorRef.activateLicenseKey(licenseKey.trim());
+}
 
-                // Update license button text and color
-                updateLicenseButton();
+void AicDemoAudioProcessorEditor::updateLicenseActivation()
+{
+    using LicenseActivation = AicDemoAudioProcessor::LicenseActivation;
 
-                // Trigger a repaint to update the license status display
-                repaint();
+    auto activation = processorRef.takeLicenseActivationResult();
+    if (activation == LicenseActivation::Idle || activation == LicenseActivation::Running)
+        return;
 
-                m_licenseDialog.setLicenseActive(true);
+    auto accepted = activation != LicenseActivation::Rejected;
+    if (accepted)
+    {
+        // Force update the model info since we now have a valid license
+        updateModelInfo();
 
-                return true; // License accepted, close dialog
-            }
-        }
+        // Update license button text and color
+        m_licenseValid = true;
+        updateLicenseButton();
     }
-    m_licenseDialog.setLicenseActive(false);
-    return false; // License invalid or save failed, keep dialog open
+
+    m_licenseDialog.showValidationResult(accepted, activation != LicenseActivation::NotSaved);
 }
 
 void AicDemoAudioProcessorEditor::updateLicenseButton()
@@ -1,32 +1,79 @@
 #pragma once
 
+#include "AicLevelMeter.h"
 #include "AicModelInfoBox.h"
 #include "AicModelSelector.h"
+#include "AicRefreshScheduler.h"
 #include "AicSlider.h"
+#include "AicSpectrumView.h"
+#include "AicVadTimeline.h"
 #include "BinaryData.h"
+#include "DeviceConfigurator.h"
 #include "LicenseDialog.h"
 #include "PluginProcessor.h"
 
 //==============================================================================
-class AicDemoAudioProcessorEditor final : public juce::AudioProcessorEditor, public juce::Timer
+class AicDemoAudioProcessorEditor final : public juce::AudioProcessorEditor
 {
   public:
     explicit AicDemoAudioProcessorEditor(AicDemoAudioProcessor&);
     ~AicDemoAudioProcessorEditor() override;
 
-    void timerCallback() override;
-
     //==============================================================================
-    void paint(juce::Graphics&) override;
     void resized() override;
 
     auto getFont() -> juce::Typeface::Ptr
     {
-        return juce::Typeface::createSystemTypefaceFor(BinaryData::aic_font_otf,
-                                                       BinaryData::aic_font_otfSize);
+        return m_typeface->typeface;
     }
 
   private:
+    /**
+     * @brief Typeface of the binary data, created once and shared by all editors.
+     *
+     * A new typeface for every editor would also clear the typeface cache of JUCE each time the
+     * default typeface of the look and feel is replaced.
+     */
+    struct SharedTypeface
+    {
+        juce::Typeface::Ptr typeface = juce::Typeface::createSystemTypefaceFor(
+            BinaryData::aic_font_otf, BinaryData::aic_font_otfSize);
+    };
+
+    juce::SharedResourcePointer<SharedTypeface> m_typeface;
+
+    /**
+     * @brief Everything of the editor that does not change: fill, section titles, legend, logo
+     * and SDK version.
+     *
+     * Buffered to an image, so it is only drawn again when the layout or the display scale
+     * changes, and the repaints of the child components on top of it only copy the image.
+     */
+    class Background : public juce::Component
+    {
+      public:
+        struct Areas
+        {
+            juce::Rectangle<int> model;
+            juce::Rectangle<int> enhancement;
+            juce::Rectangle<int> vad;
+            juce::Rectangle<int> spectrum;
+            juce::Rectangle<int> logo;
+            juce::Rectangle<int> sdkVersion;
+        };
+
+        explicit Background(const juce::String& sdkVersion);
+
+        void setAreas(const Areas& areas);
+
+        void paint(juce::Graphics& g) override;
+
+      private:
+        Areas                           m_areas;
+        juce::String                    m_sdkVersion;
+        std::unique_ptr<juce::Drawable> m_logo;
+    };
+
     // This reference is provided as a quick way for your editor to
     // access the processor object that created it.
     AicDemoAudioProcessor& processorRef;
@@ -42,10 +89,28 @@ class AicDemoAudioProcessorEditor final : public juce::AudioProcessorEditor, pub
 
     aic::ui::LicenseDialog m_licenseDialog;
 
-    juce::TextButton                m_licenseButton;
-    std::unique_ptr<juce::Drawable> m_logo;
+    juce::TextButton m_licenseButton;
+    bool             m_licenseValid;
+
+    Background m_background;
 
-    bool m_speechDetected;
+    // Scrolling VAD results, fed with the events of the audio thread
+    aic::ui::AicVadTimeline      m_vadTimeline;
+    std::vector<aic::vad::Event> m_vadEvents;
+
+    aic::ui::AicLevelMeter m_levelMeter;
+
+    // Input and output spectrum, analysed while the editor is open
+    aic::ui::AicSpectrumView m_spectrumView;
+
+    // Only in the standalone app, which owns its audio device
+    std::unique_ptr<aic::DeviceConfigurator> m_deviceConfigurator;
+    aic::ui::AicModelSelector                m_deviceProfileSelector;
+
+    // Records the input, output and VAD of the standalone app, shows the time and drops
+    juce::TextButton m_recordButton;
+    juce::int64      m_recordedSeconds{-1};
+    juce::int64      m_droppedSamples{-1};
 
     // Modal overlay component for dimming background when dialog is shown
     class ModalOverlay : public juce::Component
@@ -59,9 +124,35 @@ class AicDemoAudioProcessorEditor final : public juce::AudioProcessorEditor, pub
 
     std::unique_ptr<ModalOverlay> m_modalOverlay;
 
+    // Driven by the scheduler shared by all editors, declared last so it stops first
+    aic::ui::AicRefreshScheduler::Registration m_refreshRegistration;
+
+    /**
+     * @brief Polls the telemetry of the processor and repaints the components that changed.
+     *
+     * Called by the shared refresh scheduler while the editor is showing.
+     */
+    void refresh();
+
     void updateModelInfo();
     void updateLicenseButton();
 
+    /**
+     * @brief Sets the device of the standalone app up for the active model by the saved profile.
+     */
+    void applyDeviceProfile();
+
+    /**
+     * @brief Offers the recording formats, or stops the recording if one runs.
+     */
+    void showRecordMenu();
+    void startRecording(aic::DiskRecorder::Format format);
+
+    /**
+     * @brief Shows the recorded time and the dropped samples, only changes the text if they did.
+     */
+    void updateRecordButton();
+
     /**
      * @brief Shows a modal overlay that darkens the background.
      *
@@ -82,13 +173,17 @@ class AicDemoAudioProcessorEditor final : public juce::AudioProcessorEditor, pub
      * @brief Handles license key validation when user submits a key through the dialog.
      *
      * This method is called as a callback from the LicenseDialog when the user
-     * enters a license key and clicks OK. It validates the key using the processor,
-     * saves it if valid, and updates the UI accordingly.
+     * enters a license key and clicks OK. It starts the activation in the processor,
+     * which runs in the background. refresh() reports the result to the dialog.
      *
      * @param licenseKey The license key entered by the user
-     * @return true if the license key was valid and accepted, false otherwise
      */
-    bool handleLicenseValidation(const juce::String& licenseKey);
+    void handleLicenseValidation(const juce::String& licenseKey);
+
+    /**
+     * @brief Passes the result of a finished license activation to the dialog.
+     */
+    void updateLicenseActivation();
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AicDemoAudioProcessorEditor)
 };
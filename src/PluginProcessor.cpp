@@ -1,14 +1,17 @@
 #include "PluginProcessor.h"
 
+#include "MemoryUtils.h"
 #include "PluginEditor.h"
+#include "RealtimeSafety.h"
 
 #include <aic.hpp>
+#include <algorithm>
 #include <cstdint>
 #include <juce_audio_basics/juce_audio_basics.h>
 #include <juce_audio_processors/juce_audio_processors.h>
 
 //==============================================================================
-AicDemoAudioProcessor::AicDemoAudioProcessor()
+AicDemoAudioProcessor::AicDemoAudioProcessor(std::unique_ptr<aic::EnhancementBackend> backend)
     : AudioProcessor(BusesProperties()
                          .withInput("Input", juce::AudioChannelSet::stereo(), true)
                          .withOutput("Output", juce::AudioChannelSet::stereo(), true)),
@@ -28,18 +31,104 @@ AicDemoAudioProcessor::AicDemoAudioProcessor()
                  juce::NormalisableRange<float>(1.0f, 20.0f), 6.0f),
              std::make_unique<juce::AudioParameterFloat>(
                  juce::ParameterID{"vad_sensitivity", 1}, "VAD Sensitivity",
-                 juce::NormalisableRange<float>(1.0f, 15.0f), 6.0f)
-})
+                 juce::NormalisableRange<float>(1.0f, 15.0f), 6.0f),
+             std::make_unique<juce::AudioParameterBool>(juce::ParameterID{"bandsplit", 1},
+                                                        "Band-Split Hybrid", false),
+             std::make_unique<juce::AudioParameterBool>(juce::ParameterID{"anticipative", 1},
+                                                        "Anticipative Rendering", false),
+             std::make_unique<juce::AudioParameterBool>(juce::ParameterID{"rendercache", 1},
+                                                        "Render Cache", false),
+             std::make_unique<juce::AudioParameterBool>(juce::ParameterID{"highpass", 1},
+                                                        "High-Pass", false),
+             std::make_unique<juce::AudioParameterFloat>(
+                 juce::ParameterID{"highpass_freq", 1}, "High-Pass Frequency",
+                 juce::NormalisableRange<float>(10.0f, 300.0f, 0.0f, 0.5f), 80.0f),
+             std::make_unique<juce::AudioParameterFloat>(
+                 juce::ParameterID{"trim", 1}, "Input Trim",
+                 juce::NormalisableRange<float>(-24.0f, 24.0f), 0.0f),
+             std::make_unique<juce::AudioParameterBool>(juce::ParameterID{"gate", 1}, "Noise Gate",
+                                                        false),
+             std::make_unique<juce::AudioParameterFloat>(
+                 juce::ParameterID{"gate_threshold", 1}, "Noise Gate Threshold",
+                 juce::NormalisableRange<float>(-90.0f, -20.0f), -60.0f),
+             std::make_unique<juce::AudioParameterBool>(juce::ParameterID{"limiter", 1},
+                                                        "True-Peak Limiter", false),
+             std::make_unique<juce::AudioParameterFloat>(
+                 juce::ParameterID{"limiter_ceiling", 1}, "True-Peak Ceiling",
+                 juce::NormalisableRange<float>(-12.0f, 0.0f), -1.0f),
+             // Output of the VAD for hosts to record, written by the audio thread
+             std::make_unique<juce::AudioParameterBool>(
+                 juce::ParameterID{"vad_state", 1}, "Speech Detected", false,
+                 juce::AudioParameterBoolAttributes().withCategory(
+                     juce::AudioProcessorParameter::otherMeter))
+}),
+      m_backend(std::move(backend)),
+      m_loader(
+          [this]
+          {
+              const juce::ScopedLock lock(m_configLock);
+              return getDesiredModelConfig();
+          },
+          [this](const aic::ModelConfig& config, std::unique_ptr<aic::ModelInstance> reuse)
+          { return buildModelInstance(config, std::move(reuse)); },
+          [this](const aic::ModelInstance& instance)
+          {
+              publishModelInfo(instance);
+
+              const juce::ScopedLock lock(m_configLock);
+              if (instance.config == getDesiredModelConfig())
+                  m_modelReady.store(true);
+          }),
+      m_offlineRenderer([this](int lane, const aic::dsp::OfflineRenderer::Segment& segment)
+                        { renderOfflineLane(lane, segment); }),
+      m_renderer([this](float* const* channels, int numChannels, int numSamples)
+                 { renderModel(channels, numChannels, numSamples); })
 {
-    // Load and validate license key
-    loadAndValidateLicense();
+    m_vadStateParameter = dynamic_cast<juce::AudioParameterBool*>(state.getParameter("vad_state"));
 
-    // Only create model if license is valid
-    if (isLicenseValid())
-    {
-        createModel(m_activeModelIndex);
-        initializeModel();
-    }
+    m_parameters.model             = state.getRawParameterValue("model");
+    m_parameters.bandSplit         = state.getRawParameterValue("bandsplit");
+    m_parameters.bypass            = state.getRawParameterValue("bypass");
+    m_parameters.enhancement       = state.getRawParameterValue("enhancement");
+    m_parameters.voiceGain         = state.getRawParameterValue("voicegain");
+    m_parameters.vadLookback       = state.getRawParameterValue("vad_loopback");
+    m_parameters.vadSensitivity    = state.getRawParameterValue("vad_sensitivity");
+    m_parameters.anticipative      = state.getRawParameterValue("anticipative");
+    m_parameters.renderCache       = state.getRawParameterValue("rendercache");
+    m_parameters.highPass          = state.getRawParameterValue("highpass");
+    m_parameters.highPassFrequency = state.getRawParameterValue("highpass_freq");
+    m_parameters.trim              = state.getRawParameterValue("trim");
+    m_parameters.gate              = state.getRawParameterValue("gate");
+    m_parameters.gateThreshold     = state.getRawParameterValue("gate_threshold");
+    m_parameters.limiter           = state.getRawParameterValue("limiter");
+    m_parameters.limiterCeiling    = state.getRawParameterValue("limiter_ceiling");
+
+    // The loader sleeps until the model it should build changes
+    state.addParameterListener("model", this);
+    state.addParameterListener("bandsplit", this);
+
+    // The high-pass comes before the trim, so rumble does not drive the model harder. The limiter
+    // is last, nothing may raise the peaks after it.
+    m_stages.add(aic::dsp::StageChain::Position::PreModel, m_highPass);
+    m_stages.add(aic::dsp::StageChain::Position::PreModel, m_trim);
+    m_stages.add(aic::dsp::StageChain::Position::PostModel, m_gate);
+    m_stages.add(aic::dsp::StageChain::Position::PostModel, m_limiter);
+
+    // The stored license key is checked by the loader, which creates the active model with it.
+    // Stand-ins run without one.
+    if (m_backend->requiresLicense())
+        loadLicenseKey();
+    else
+        m_licenseValid.store(true);
+
+    // Builds the model right away, prepareToPlay reinitializes the same instance
+    m_loader.start();
+}
+
+AicDemoAudioProcessor::~AicDemoAudioProcessor()
+{
+    state.removeParameterListener("model", this);
+    state.removeParameterListener("bandsplit", this);
 }
 
 //==============================================================================
@@ -77,7 +166,9 @@ bool AicDemoAudioProcessor::isMidiEffect() const
 
 double AicDemoAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    // Offline bounces are extended by the latency, so the delayed output is not cut off
+    auto sampleRate = getSampleRate();
+    return sampleRate > 0.0 ? getLatencySamples() / sampleRate : 0.0;
 }
 
 int AicDemoAudioProcessor::getNumPrograms()
@@ -109,24 +200,91 @@ void AicDemoAudioProcessor::changeProgramName(int index, const juce::String& new
 //==============================================================================
 void AicDemoAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
-    m_currentSampleRate  = static_cast<uint32_t>(sampleRate);
-    m_currentNumChannels = static_cast<uint16_t>(getTotalNumInputChannels());
-    m_currentNumFrames   = static_cast<size_t>(samplesPerBlock);
+    const aic::trace::ScopedSpan span("prepareToPlay");
+
+    {
+        const juce::ScopedLock lock(m_configLock);
+        m_currentSampleRate  = static_cast<uint32_t>(sampleRate);
+        m_currentNumChannels = static_cast<uint16_t>(getTotalNumInputChannels());
+        m_currentNumFrames   = static_cast<size_t>(samplesPerBlock);
+    }
+
+    // The lookahead is the deadline of the background thread during playback
+    auto lookahead = juce::jmax(4 * samplesPerBlock,
+                                juce::roundToInt(sampleRate * anticipationLookaheadSeconds));
+    m_renderer.prepare(m_currentNumChannels, samplesPerBlock, lookahead);
+
+    // Room for the delay of any model, the loader may swap in another one before it is adopted
+    m_passThroughDelay.setMaximumDelayInSamples(
+        lookahead + juce::roundToInt(sampleRate * maxPassThroughModelDelaySeconds));
+    m_passThroughDelay.prepare({sampleRate, static_cast<juce::uint32>(samplesPerBlock),
+                                static_cast<juce::uint32>(m_currentNumChannels)});
+
+    m_renderCache.prepare(getLicenseFile().getParentDirectory().getChildFile("cache"),
+                          m_currentNumChannels, samplesPerBlock,
+                          juce::roundToInt(sampleRate * renderCacheHistorySeconds));
 
-    initializeModel();
+    m_inputMeter.prepare(sampleRate);
+    m_outputMeter.prepare(sampleRate);
+    m_spectrum.prepare(sampleRate);
+    m_diskRecorder.prepare(sampleRate, m_currentNumChannels);
+
+    // Before the model, whose latency is reported including the enabled stages
+    m_stages.prepare(sampleRate, m_currentNumChannels);
+    applyStageParameters();
+
+    prepareModel();
+    prepareOfflineRendering();
+
+    m_vadPosition = 0;
+    m_vadSpeech   = false;
+    m_vadTimelinePosition.store(0);
 }
 
 void AicDemoAudioProcessor::releaseResources()
 {
+    m_renderer.release();
+    m_renderCache.release();
+
+    m_offlineRenderer.release();
+    m_offlineInstances.clear();
+    m_offlineActive    = false;
+    m_renderingOffline = false;
+
     // Models will be automatically destroyed when unique_ptrs go out of scope
 }
 
 void AicDemoAudioProcessor::reset()
 {
-    if (m_model)
+    // The background thread of the anticipative renderer may be rendering with the model right
+    // now, the audio thread resets it once it has been handed back
+    m_resetPending.store(true);
+}
+
+void AicDemoAudioProcessor::resetAudioThreadState()
+{
+    m_offlineRenderer.reset();
+    m_stages.reset();
+    m_passThroughDelay.reset();
+
+    m_vadPosition = 0;
+    m_vadSpeech   = false;
+    m_vadTimelinePosition.store(0);
+}
+
+void AicDemoAudioProcessor::resetModelState()
+{
+    if (m_instance && m_instance->model)
     {
-        m_model->reset();
+        m_instance->model->reset();
+
+        if (m_instance->bandSplitActive)
+            m_instance->bandSplit.reset();
     }
+
+    // A reset stream starts without history, nothing rendered for the old one may be reused
+    m_renderCache.resetHistory();
+    m_renderer.reset();
 }
 
 bool AicDemoAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
@@ -153,6 +311,9 @@ void AicDemoAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer,
 {
     juce::ignoreUnused(midiMessages);
 
+    const aic::realtime::ScopedContext realtimeContext;
+    const aic::trace::ScopedSpan       span("processBlock");
+
     juce::ScopedNoDenormals noDenormals;
     auto                    totalNumInputChannels  = getTotalNumInputChannels();
     auto                    totalNumOutputChannels = getTotalNumOutputChannels();
@@ -161,55 +322,780 @@ void AicDemoAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer,
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear(i, 0, buffer.getNumSamples());
 
+    m_inputMeter.process(buffer.getArrayOfReadPointers(), totalNumInputChannels,
+                         buffer.getNumSamples());
+    m_spectrum.pushInput(buffer.getArrayOfReadPointers(), totalNumInputChannels,
+                         buffer.getNumSamples());
+    m_diskRecorder.beginBlock(buffer.getArrayOfReadPointers(), totalNumInputChannels,
+                              buffer.getNumSamples());
+
+    if (m_resetPending.exchange(false))
+    {
+        resetAudioThreadState();
+        m_modelResetPending = true;
+    }
+
+    // Enabling the limiter changes the latency
+    auto stageLatency = m_stages.getLatencySamples();
+    applyStageParameters();
+    if (m_stages.getLatencySamples() != stageLatency)
+        updateLatency();
+
+    m_stages.process(aic::dsp::StageChain::Position::PreModel, buffer.getArrayOfWritePointers(),
+                     totalNumInputChannels, buffer.getNumSamples());
+
     // Get parameter values in a real-time safe way
-    auto modelParameterValue = state.getRawParameterValue("model");
+    bool anticipativeEnabled = m_parameters.anticipative->load() > 0.5f;
+    bool anticipate          = anticipativeEnabled && shouldAnticipate(buffer.getNumSamples());
 
-    // Convert model parameter to index
-    size_t modelIndex = static_cast<size_t>(modelParameterValue->load());
+    m_renderCache.setEnabled(m_parameters.renderCache->load() > 0.5f);
 
-    // update model if model changed
-    if (m_activeModelIndex != modelIndex)
+    // The background thread has to hand the model back before anything it uses can change
+    bool ownsModel          = m_renderer.isIdle();
+    bool modelUpdatePending = m_loader.hasPublished() ||
+                              m_anticipativeEnabled != anticipativeEnabled || m_modelResetPending;
+    if (!ownsModel && modelUpdatePending)
     {
-        m_activeModelIndex = modelIndex;
-        // Only create model if we have a valid license
-        if (isLicenseValid())
+        anticipate = false;
+    }
+
+    if (ownsModel && m_modelResetPending)
+    {
+        m_modelResetPending = false;
+        resetModelState();
+    }
+
+    if (ownsModel && m_anticipativeEnabled != anticipativeEnabled)
+    {
+        m_anticipativeEnabled = anticipativeEnabled;
+        m_renderer.reset();
+        updateLatency();
+    }
+
+    // Model and band-split changes are built and warmed up by the loader, switching to the new
+    // instance is only a pointer swap
+    if (ownsModel)
+    {
+        adoptPublishedModel();
+    }
+
+    // The host may switch between offline and realtime processing without preparing again
+    if (isRenderingOffline() != m_renderingOffline)
+    {
+        m_renderingOffline = isRenderingOffline();
+        m_offlineRenderer.reset();
+        updateLatency();
+    }
+
+    // The lanes have their own models, they do not wait for the loader to warm one up
+    if (m_renderingOffline)
+    {
+        // Only while the host renders offline, nobody listens in real time
+        const aic::realtime::ScopedAllowance allowance("offline render waits for its lanes");
+        m_speechDetected.store(m_offlineRenderer.process(buffer.getArrayOfWritePointers(),
+                                                         totalNumInputChannels,
+                                                         buffer.getNumSamples(),
+                                                         getModelParameters()));
+        finishBlock(buffer);
+        return;
+    }
+
+    if (!m_instance || !m_instance->initialized || !isLicenseValid())
+    {
+        // Model is nullptr, not running, or license invalid - audio passes through, delayed like
+        // the output of the model whose latency is reported
+        delayPassThrough(buffer, totalNumInputChannels);
+        finishBlock(buffer);
+        return;
+    }
+
+    if (m_anticipativeEnabled)
+    {
+        m_renderer.process(buffer.getArrayOfWritePointers(), totalNumInputChannels,
+                           buffer.getNumSamples(), anticipate);
+    }
+    else
+    {
+        renderModel(buffer.getArrayOfWritePointers(), totalNumInputChannels,
+                    buffer.getNumSamples());
+    }
+
+    finishBlock(buffer);
+}
+
+void AicDemoAudioProcessor::updateLatency()
+{
+    auto latency = getTotalLatencySamples();
+    if (latency != getLatencySamples())
+    {
+        // Model swaps and toggled stages change the latency between blocks. Hosts are told on the
+        // thread that changed it, JUCE holds the listener lock of the processor while calling
+        // them. Only contended while the listeners change.
+        const aic::realtime::ScopedAllowance allowance("host latency notification");
+        setLatencySamples(latency);
+    }
+
+    aic::trace::counter("latency samples", latency);
+}
+
+void AicDemoAudioProcessor::delayPassThrough(juce::AudioBuffer<float>& buffer, int numChannels)
+{
+    auto lookahead = m_anticipativeEnabled ? m_renderer.getLatencySamples() : 0;
+    auto delay     = static_cast<int>(m_outputDelaySamples) + lookahead;
+    if (delay == 0)
+        return;
+
+    m_passThroughDelay.setDelay(static_cast<float>(delay));
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        auto* samples = buffer.getWritePointer(ch);
+        for (int i = 0; i < buffer.getNumSamples(); ++i)
         {
-            /// This is not real-time safe and will lead to clicks.
-            /// Though we want to show the RAM usage of each model and they are not meant to be
-            /// changed in real-time. When loading all models prior, the RAM usage is way higher
-            /// than necessary.
-            createModel(m_activeModelIndex);
-            initializeModel();
+            m_passThroughDelay.pushSample(ch, samples[i]);
+            samples[i] = m_passThroughDelay.popSample(ch);
         }
     }
+}
 
-    if (!m_model || !m_modelIsInitialized || !isLicenseValid())
+void AicDemoAudioProcessor::finishBlock(juce::AudioBuffer<float>& buffer)
+{
+    const auto numChannels = getTotalNumOutputChannels();
+
+    m_stages.process(aic::dsp::StageChain::Position::PostModel, buffer.getArrayOfWritePointers(),
+                     numChannels, buffer.getNumSamples());
+
+    m_outputMeter.process(buffer.getArrayOfReadPointers(), numChannels, buffer.getNumSamples());
+    m_spectrum.pushOutput(buffer.getArrayOfReadPointers(), numChannels, buffer.getNumSamples());
+    recordVadState(buffer.getNumSamples());
+    m_diskRecorder.endBlock(buffer.getArrayOfReadPointers(), numChannels, m_vadSpeech);
+}
+
+void AicDemoAudioProcessor::adoptPublishedModel()
+{
+    auto instance = m_loader.takePublished();
+    if (instance == nullptr)
+        return;
+
+    // Built for a model or audio settings that are outdated, the loader builds the next one
+    if (instance->config != getDesiredModelConfig())
     {
-        // Model is nullptr, not running, or license invalid - audio passes through unchanged
+        m_loader.retire(std::move(instance));
         return;
     }
 
+    m_loader.retire(std::move(m_instance));
+    m_instance           = std::move(instance);
+    m_outputDelaySamples = m_instance->outputDelaySamples;
+
+    m_renderCache.resetHistory();
+    updateLatency();
+    m_modelChanged.store(true);
+    aic::trace::instant("model swap");
+}
+
+aic::ModelConfig AicDemoAudioProcessor::getDesiredModelConfig() const
+{
+    aic::ModelConfig config;
+    config.modelIndex = static_cast<size_t>(
+        juce::jlimit(0, static_cast<int>(m_numModels - 1),
+                     static_cast<int>(m_parameters.model->load())));
+    config.bandSplit   = m_parameters.bandSplit->load() > 0.5f;
+    config.sampleRate  = m_currentSampleRate;
+    config.numChannels = m_currentNumChannels;
+    config.numFrames   = m_currentNumFrames;
+    return config;
+}
+
+void AicDemoAudioProcessor::prepareModel()
+{
+    // The audio thread is stopped, take back the newest instance, whether the loader still has it
+    // or the audio thread processed with it. Waits for a build in progress, e.g. the prefetch of a
+    // restored state.
+    auto instance = m_loader.reclaim();
+    if (instance == nullptr)
+    {
+        instance = std::move(m_instance);
+    }
+    m_instance.reset();
+    m_modelReady.store(false);
+
+    // Only the model selected now is adopted, the loader builds any other one in the background
+    // and the audio thread takes it over once it is warmed up
+    auto config = getDesiredModelConfig();
+    if (instance != nullptr && instance->config.modelIndex != config.modelIndex)
+        instance.reset();
+
+    m_outputDelaySamples = 0;
+    if (instance == nullptr)
+    {
+        m_loader.configChanged();
+    }
+    else
+    {
+        instance->config = config;
+        initializeModelInstance(*instance);
+        m_outputDelaySamples = instance->outputDelaySamples;
+        publishModelInfo(*instance);
+
+        // The loader warms the model up and publishes it afterwards
+        m_loader.recycle(std::move(instance));
+    }
+
+    m_renderCache.resetHistory();
+    updateLatency();
+}
+
+void AicDemoAudioProcessor::prepareOfflineRendering()
+{
+    m_offlineRenderer.release();
+    m_offlineInstances.clear();
+    m_offlineActive    = false;
+    m_renderingOffline = false;
+
+    auto numLanes = juce::jmin(maxOfflineLanes, juce::SystemStats::getNumCpus());
+    if (!isNonRealtime() || !isLicenseValid() || numLanes < 2)
+    {
+        updateLatency();
+        return;
+    }
+
+    const aic::trace::ScopedSpan span("prepareOfflineRendering");
+
+    std::string licenseKey;
+    {
+        const juce::ScopedLock lock(m_configLock);
+        licenseKey = m_licenseKey;
+    }
+
+    // Built right away, the bounce starts after prepareToPlay returns
+    auto config = getDesiredModelConfig();
+    for (int lane = 0; lane < numLanes; ++lane)
+    {
+        auto instance = createModelInstance(config.modelIndex, licenseKey);
+        if (instance == nullptr)
+            break;
+
+        instance->config = config;
+        initializeModelInstance(*instance);
+        if (!instance->initialized)
+            break;
+
+        m_offlineInstances.push_back(std::move(instance));
+    }
+
+    // Falls back to the regular path, which renders the bounce on one core
+    if (static_cast<int>(m_offlineInstances.size()) != numLanes)
+    {
+        m_offlineInstances.clear();
+        updateLatency();
+        return;
+    }
+
+    // A lane starts from a reset model, it is primed until its first output is determined by the
+    // input of the segment
+    auto sampleRate  = static_cast<double>(config.sampleRate);
+    auto outputDelay = static_cast<int>(m_offlineInstances.front()->outputDelaySamples);
+    auto history     = outputDelay + juce::roundToInt(sampleRate * offlineHistorySeconds);
+    auto segment     = juce::jmax(history, juce::roundToInt(sampleRate * offlineSegmentSeconds));
+
+    m_offlineRenderer.prepare(numLanes, config.numChannels, segment, history);
+    m_offlineActive    = true;
+    m_renderingOffline = true;
+    updateLatency();
+}
+
+std::unique_ptr<aic::ModelInstance>
+AicDemoAudioProcessor::createModelInstance(size_t index, const std::string& licenseKey)
+{
+    const aic::trace::ScopedSpan span("createModel");
+
+    index = static_cast<size_t>(
+        juce::jlimit(0, static_cast<int>(m_numModels - 1), static_cast<int>(index)));
+
+    // Only attempt to create model if we have a license key
+    if (licenseKey.empty() && m_backend->requiresLicense())
+    {
+        return nullptr;
+    }
+
+    // The backend also creates the VAD of the model
+    auto residentBytes      = aic::memory::getResidentMemoryBytes();
+    auto [model, errorCode] = m_backend->create(modelInfos[index].modelType, licenseKey);
+    if (!model || errorCode != aic::ErrorCode::Success)
+    {
+        aic::log::write(aic::log::Level::Error, aic::log::Code::ModelCreateFailed,
+                        static_cast<std::int64_t>(index), static_cast<std::int64_t>(errorCode));
+        return nullptr;
+    }
+
+    auto instance               = std::make_unique<aic::ModelInstance>();
+    instance->config.modelIndex = index;
+    instance->model             = std::move(model);
+
+    instance->createMemoryBytes = aic::memory::getResidentMemoryGrowth(residentBytes);
+
+    return instance;
+}
+
+void AicDemoAudioProcessor::initializeModelInstance(aic::ModelInstance& instance)
+{
+    const aic::trace::ScopedSpan span("initializeModel");
+
+    const auto& config          = instance.config;
+    auto        modelSampleRate = instance.model->getOptimalSampleRate();
+    auto        residentBytes   = aic::memory::getResidentMemoryBytes();
+
+    // Narrowband models can run at their native rate on the low band only
+    instance.bandSplitActive =
+        config.bandSplit &&
+        aic::dsp::BandSplitEngine::canSplit(static_cast<double>(config.sampleRate),
+                                            static_cast<double>(modelSampleRate));
+
+    aic::ErrorCode errorCode;
+    if (instance.bandSplitActive)
+    {
+        instance.bandSplit.prepare(static_cast<double>(config.sampleRate),
+                                   static_cast<double>(modelSampleRate), config.numChannels,
+                                   static_cast<int>(config.numFrames));
+        errorCode = instance.model->initialize(modelSampleRate, config.numChannels,
+                                               instance.bandSplit.getMaxModelFrames(), true);
+        instance.bandSplit.setModelOutputDelay(instance.model->getOutputDelay());
+        instance.outputDelaySamples =
+            static_cast<size_t>(instance.bandSplit.getLatencySamples());
+    }
+    else
+    {
+        errorCode = instance.model->initialize(config.sampleRate, config.numChannels,
+                                               config.numFrames, true);
+        instance.outputDelaySamples = instance.model->getOutputDelay();
+    }
+
+    instance.initialized           = errorCode == aic::ErrorCode::Success;
+    instance.initializeMemoryBytes = aic::memory::getResidentMemoryGrowth(residentBytes);
+
+    if (!instance.initialized)
+        aic::log::write(aic::log::Level::Error, aic::log::Code::ModelInitializeFailed,
+                        static_cast<std::int64_t>(config.modelIndex),
+                        static_cast<std::int64_t>(errorCode));
+}
+
+void AicDemoAudioProcessor::warmUpModelInstance(aic::ModelInstance& instance,
+                                                const WarmUpSettings& settings)
+{
+    const aic::trace::ScopedSpan span("warmUpModel");
+
+    const auto& config    = instance.config;
+    const auto  numFrames = static_cast<int>(config.numFrames);
+    const auto  numBlocks = juce::roundToInt(settings.durationMs * 0.001 *
+                                             static_cast<double>(config.sampleRate) / numFrames);
+
+    if (numBlocks > 0)
+    {
+        // Real blocks fault in the weights and trigger the lazy allocations inside the SDK
+        juce::AudioBuffer<float> buffer(config.numChannels, numFrames);
+        juce::Random             random;
+        auto                     residentBytes = aic::memory::getResidentMemoryBytes();
+
+        applyParameters(instance, getModelParameters());
+
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            buffer.clear();
+            if (settings.useNoise)
+            {
+                for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                    for (int i = 0; i < numFrames; ++i)
+                        buffer.setSample(ch, i,
+                                         (random.nextFloat() * 2.0f - 1.0f) * warmUpNoiseLevel);
+            }
+
+            runModel(instance, buffer.getArrayOfWritePointers(), config.numChannels, numFrames);
+        }
+
+        // Nothing of the warm-up may leak into the first real block
+        instance.model->reset();
+        if (instance.bandSplitActive)
+            instance.bandSplit.reset();
+
+        // Lazy allocations of the first blocks count towards the initialization
+        auto growth = aic::memory::getResidentMemoryGrowth(residentBytes);
+        if (instance.initializeMemoryBytes >= 0 && growth >= 0)
+            instance.initializeMemoryBytes += growth;
+    }
+
+    if (settings.lockMemory && !aic::memory::lockProcessMemory())
+    {
+        aic::log::write(aic::log::Level::Warning, aic::log::Code::LockMemoryFailed);
+    }
+}
+
+std::unique_ptr<aic::ModelInstance>
+AicDemoAudioProcessor::buildModelInstance(const aic::ModelConfig&             config,
+                                          std::unique_ptr<aic::ModelInstance> reuse)
+{
+    const aic::trace::ScopedSpan span("buildModel");
+
+    std::string    licenseKey;
+    std::string    pendingLicenseKey;
+    WarmUpSettings warmUp;
+    {
+        const juce::ScopedLock lock(m_configLock);
+        licenseKey = m_licenseKey;
+        warmUp     = m_warmUpSettings;
+        std::swap(pendingLicenseKey, m_pendingLicenseKey);
+    }
+
+    auto instance = std::move(reuse);
+
+    // A license key to activate is checked by creating the model with it, which then becomes the
+    // active one. An invalid key leaves the active license as it is.
+    if (!pendingLicenseKey.empty())
+    {
+        auto candidate = createModelInstance(config.modelIndex, pendingLicenseKey);
+        if (candidate != nullptr)
+        {
+            {
+                const juce::ScopedLock lock(m_configLock);
+                m_licenseKey = pendingLicenseKey;
+            }
+
+            // A valid key is active either way, unsaved it has to be entered again next time
+            m_licenseValid.store(true);
+            m_licenseActivation.store(saveLicenseKey(pendingLicenseKey)
+                                          ? LicenseActivation::Accepted
+                                          : LicenseActivation::NotSaved);
+            instance = std::move(candidate);
+        }
+        else
+        {
+            m_licenseActivation.store(LicenseActivation::Rejected);
+        }
+    }
+
+    /// Models are created on demand instead of all being loaded up front. The RAM usage of each
+    /// model is measured and shown, and loading all models prior uses way more RAM than necessary.
+    /// Creating the model is also what validates the stored license key.
+    if (instance == nullptr || instance->config.modelIndex != config.modelIndex)
+    {
+        instance = createModelInstance(config.modelIndex, licenseKey);
+        m_licenseValid.store(instance != nullptr);
+        if (instance == nullptr)
+        {
+            return nullptr;
+        }
+    }
+
+    if (!instance->initialized || instance->config != config)
+    {
+        instance->config = config;
+        initializeModelInstance(*instance);
+    }
+
+    if (instance->initialized)
+    {
+        warmUpModelInstance(*instance, warmUp);
+    }
+
+    return instance;
+}
+
+void AicDemoAudioProcessor::publishModelInfo(const aic::ModelInstance& instance)
+{
+    ModelSnapshot snapshot;
+    snapshot.initialized = instance.model && instance.initialized;
+    snapshot.modelIndex  = instance.config.modelIndex;
+    snapshot.sampleRate  = instance.config.sampleRate;
+    snapshot.memory      = {instance.createMemoryBytes, instance.initializeMemoryBytes};
+
+    if (snapshot.initialized)
+    {
+        snapshot.optimalSampleRate = static_cast<int>(instance.model->getOptimalSampleRate());
+
+        // in band-split mode the model runs at its native rate
+        snapshot.optimalNumFrames =
+            instance.bandSplitActive
+                ? static_cast<int>(instance.model->getOptimalNumFrames(
+                      instance.model->getOptimalSampleRate())) *
+                      instance.bandSplit.getDecimationFactor()
+                : static_cast<int>(instance.model->getOptimalNumFrames(snapshot.sampleRate));
+    }
+
+    {
+        const juce::SpinLock::ScopedLockType lock(m_snapshotLock);
+        m_snapshot = snapshot;
+    }
+
+    m_modelChanged.store(true);
+}
+
+bool AicDemoAudioProcessor::shouldAnticipate(int numSamples)
+{
+    // Offline renders run faster than real time, the background thread could not keep up
+    if (isNonRealtime())
+        return false;
+
+    auto* playHead = getPlayHead();
+    if (playHead == nullptr)
+        return false;
+
+    auto position = playHead->getPosition();
+    if (!position.hasValue() || !position->getTimeInSamples().hasValue())
+        return false;
+
+    // Seeks and loop jumps show up as a discontinuity in the timeline position
+    auto timeInSamples      = *position->getTimeInSamples();
+    bool isContinuous       = timeInSamples == m_expectedTimeInSamples;
+    m_expectedTimeInSamples = timeInSamples + numSamples;
+
+    // Recording means the input is live and not known ahead
+    return position->getIsPlaying() && !position->getIsRecording() && isContinuous;
+}
+
+aic::ModelParameters AicDemoAudioProcessor::getModelParameters() const
+{
+    aic::ModelParameters parameters;
+    parameters.bypass         = m_parameters.bypass->load();
+    parameters.enhancement    = m_parameters.enhancement->load();
+    parameters.voiceGain      = juce::Decibels::decibelsToGain(m_parameters.voiceGain->load());
+    parameters.vadLookback    = m_parameters.vadLookback->load();
+    parameters.vadSensitivity = m_parameters.vadSensitivity->load();
+    return parameters;
+}
+
+void AicDemoAudioProcessor::applyParameters(aic::ModelInstance&         instance,
+                                            const aic::ModelParameters& parameters)
+{
     // Set parameters for selected model
-    m_model->set_parameter(aic::EnhancementParameter::Bypass, state.getRawParameterValue("bypass")->load());
-    m_model->set_parameter(aic::EnhancementParameter::EnhancementLevel,
-                           state.getRawParameterValue("enhancement")->load());
-    m_model->set_parameter(
-        aic::EnhancementParameter::VoiceGain,
-        juce::Decibels::decibelsToGain(state.getRawParameterValue("voicegain")->load()));
-
-    m_vad->set_parameter(aic::VadParameter::LookbackBufferSize,state.getRawParameterValue("vad_loopback")->load());
-    m_vad->set_parameter(aic::VadParameter::Sensitivity,state.getRawParameterValue("vad_sensitivity")->load());
-
-    auto processing_result = m_model->process_planar(buffer.getArrayOfWritePointers(),
-                                                     static_cast<uint16_t>(totalNumInputChannels),
-                                                     static_cast<size_t>(buffer.getNumSamples()));
+    instance.model->setParameter(aic::EnhancementParameter::Bypass, parameters.bypass);
+    instance.model->setParameter(aic::EnhancementParameter::EnhancementLevel,
+                                 parameters.enhancement);
+    instance.model->setParameter(aic::EnhancementParameter::VoiceGain, parameters.voiceGain);
+
+    if (instance.model->hasVad())
+    {
+        instance.model->setVadParameter(aic::VadParameter::LookbackBufferSize,
+                                        parameters.vadLookback);
+        instance.model->setVadParameter(aic::VadParameter::Sensitivity,
+                                        parameters.vadSensitivity);
+    }
+}
+
+void AicDemoAudioProcessor::applyStageParameters()
+{
+    m_highPass.setEnabled(m_parameters.highPass->load() > 0.5f);
+    m_highPass.setCutoffFrequency(m_parameters.highPassFrequency->load());
+
+    // Enabled while the gain differs from 0 dB or ramps back to it
+    m_trim.setGainDecibels(m_parameters.trim->load());
+
+    m_gate.setEnabled(m_parameters.gate->load() > 0.5f);
+    m_gate.setThresholdDecibels(m_parameters.gateThreshold->load());
+
+    m_limiter.setEnabled(m_parameters.limiter->load() > 0.5f);
+    m_limiter.setCeilingDecibels(m_parameters.limiterCeiling->load());
+}
+
+void AicDemoAudioProcessor::renderModel(float* const* channels, int numChannels, int numSamples)
+{
+    applyParameters(*m_instance, getModelParameters());
+
+    if (!m_renderCache.isEnabled())
+    {
+        // Keys must not span the blocks processed while the cache was off
+        m_renderCache.resetHistory();
+        processModel(channels, numChannels, numSamples);
+        return;
+    }
+
+    auto parameterHash = getRenderCacheParameterHash();
+    auto maxBlock      = static_cast<int>(m_currentNumFrames);
+
+    auto render = [this](float* const* c, int nc, int ns) { processModel(c, nc, ns); };
+
+    std::array<float*, 2> block{};
+    for (int start = 0; start < numSamples; start += maxBlock)
+    {
+        auto blockSize = juce::jmin(maxBlock, numSamples - start);
+        for (int ch = 0; ch < numChannels; ++ch)
+            block[static_cast<size_t>(ch)] = channels[ch] + start;
+
+        auto key    = m_renderCache.beginBlock(block.data(), numChannels, blockSize, parameterHash);
+        auto speech = false;
+        if (m_renderCache.lookup(key, block.data(), numChannels, blockSize, speech))
+        {
+            // Close to the end of the run the model follows the input again, one block per hit
+            if (m_renderCache.isHitRunEnding())
+                m_renderCache.prime(render, blockSize);
+
+            m_speechDetected.store(speech);
+            continue;
+        }
+
+        // Catches up on at most one block when the miss was not seen coming
+        m_renderCache.prime(render, maxBlock);
+
+        if (processModel(block.data(), numChannels, blockSize) == aic::ErrorCode::Success)
+            m_renderCache.store(key, block.data(), numChannels, blockSize,
+                                m_speechDetected.load());
+    }
+}
+
+void AicDemoAudioProcessor::renderOfflineLane(int                                      lane,
+                                              const aic::dsp::OfflineRenderer::Segment& segment)
+{
+    auto& instance = *m_offlineInstances[static_cast<size_t>(lane)];
+
+    instance.model->reset();
+    if (instance.bandSplitActive)
+        instance.bandSplit.reset();
+
+    // The model takes at most the block size it was initialized for
+    auto maxBlock = static_cast<int>(instance.config.numFrames);
+
+    std::array<float*, 2> block{};
+    for (int change = 0; change < segment.numChanges; ++change)
+    {
+        applyParameters(instance, segment.changes[change].parameters);
+
+        auto end = change + 1 < segment.numChanges ? segment.changes[change + 1].position
+                                                   : segment.numSamples;
+
+        for (auto start = segment.changes[change].position; start < end; start += maxBlock)
+        {
+            auto blockSize = juce::jmin(maxBlock, end - start);
+            for (int ch = 0; ch < segment.numChannels; ++ch)
+                block[static_cast<size_t>(ch)] = segment.channels[ch] + start;
+
+            runModel(instance, block.data(), segment.numChannels, blockSize);
+
+            std::fill_n(segment.speech + start, blockSize,
+                        static_cast<std::uint8_t>(instance.model->isSpeechDetected()));
+        }
+    }
+}
+
+aic::ErrorCode AicDemoAudioProcessor::runModel(aic::ModelInstance& instance, float* const* channels,
+                                              int numChannels, int numSamples)
+{
+    const aic::trace::ScopedSpan span("process_planar");
+
+    return instance.bandSplitActive
+               ? processBandSplit(instance, channels, numChannels, numSamples)
+               : instance.model->processPlanar(channels, static_cast<uint16_t>(numChannels),
+                                               static_cast<size_t>(numSamples));
+}
+
+aic::ErrorCode AicDemoAudioProcessor::processModel(float* const* channels, int numChannels,
+                                                  int numSamples)
+{
+    auto processing_result = runModel(*m_instance, channels, numChannels, numSamples);
+    m_speechDetected.store(m_instance->model->isSpeechDetected());
+
+    // Logged once per change, not per block
+    if (processing_result != m_lastProcessingResult)
+    {
+        m_lastProcessingResult = processing_result;
+        if (processing_result == aic::ErrorCode::Success)
+            aic::log::write(aic::log::Level::Info, aic::log::Code::ProcessingRecovered);
+        else
+            aic::log::write(aic::log::Level::Error, aic::log::Code::ProcessingFailed,
+                            static_cast<std::int64_t>(processing_result));
+    }
+
     // update model info box if state of processingNotAllowed changed
     bool currentProcessingNotAllowed = (processing_result == aic::ErrorCode::EnhancementNotAllowed);
-    if (m_processingNotAllowed != currentProcessingNotAllowed)
+    if (m_processingNotAllowed.load() != currentProcessingNotAllowed)
     {
-        m_processingNotAllowed = currentProcessingNotAllowed;
+        m_processingNotAllowed.store(currentProcessingNotAllowed);
         m_modelChanged.store(true);
     }
+    return processing_result;
+}
+
+void AicDemoAudioProcessor::recordVadState(int numSamples)
+{
+    m_vadPosition += numSamples;
+
+    // The VAD runs on the model output, which lags the input by the delay of the model
+    auto position =
+        juce::jmax(static_cast<std::int64_t>(0), m_vadPosition - getVadDelaySamples());
+    m_vadTimelinePosition.store(position);
+
+    auto speech = m_speechDetected.load();
+
+    // Read-only for the host, values written by automation are overwritten
+    if (m_vadStateParameter->get() != speech)
+    {
+        // Hosts expect the notification on the audio thread, JUCE holds the listener lock of the
+        // parameter while calling them. Only contended while the listeners change.
+        const aic::realtime::ScopedAllowance allowance("host parameter notification");
+        m_vadStateParameter->setValueNotifyingHost(speech ? 1.0f : 0.0f);
+    }
+
+    if (speech == m_vadSpeech)
+        return;
+
+    m_vadSpeech = speech;
+    aic::trace::counter("speech", speech ? 1.0 : 0.0);
+    if (m_collectingVadEvents.load())
+        m_vadEvents.push({position, speech});
+
+    m_vadEditorEvents.push({position, speech});
+}
+
+std::uint64_t AicDemoAudioProcessor::getRenderCacheParameterHash()
+{
+    // Everything the output depends on besides the input
+    const std::array<float, 8> values{
+        static_cast<float>(m_instance->config.modelIndex),
+        m_instance->bandSplitActive ? 1.0f : 0.0f,
+        static_cast<float>(m_currentSampleRate),
+        m_parameters.bypass->load(),
+        m_parameters.enhancement->load(),
+        m_parameters.voiceGain->load(),
+        m_parameters.vadLookback->load(),
+        m_parameters.vadSensitivity->load()};
+
+    return aic::dsp::RenderCache::hash(values.data(), sizeof(values), 0);
+}
+
+aic::ErrorCode AicDemoAudioProcessor::processBandSplit(aic::ModelInstance& instance,
+                                                      float* const* channels, int numChannels,
+                                                      int numSamples)
+{
+    auto& bandSplit = instance.bandSplit;
+
+    auto result = aic::ErrorCode::Success;
+
+    // Attenuate the high band by the enhancement level while no speech is detected
+    auto bypass           = m_parameters.bypass->load() > 0.5f;
+    auto enhancementLevel = m_parameters.enhancement->load();
+    auto speechDetected   = instance.model->isSpeechDetected();
+    bandSplit.setHighBandGain(bypass || speechDetected ? 1.0f : 1.0f - enhancementLevel);
+
+    auto maxBlock = bandSplit.getMaxBlockSize();
+
+    // Hosts may exceed the block size announced in prepareToPlay
+    for (int start = 0; start < numSamples; start += maxBlock)
+    {
+        auto blockSize = juce::jmin(maxBlock, numSamples - start);
+
+        std::array<float*, 2> block{};
+        for (int ch = 0; ch < numChannels; ++ch)
+            block[static_cast<size_t>(ch)] = channels[ch] + start;
+
+        auto numModelFrames = bandSplit.splitAndDecimate(block.data(), numChannels, blockSize);
+        if (numModelFrames > 0)
+        {
+            result = instance.model->processPlanar(bandSplit.getModelChannels(),
+                                                   static_cast<uint16_t>(numChannels),
+                                                   static_cast<size_t>(numModelFrames));
+        }
+        bandSplit.interpolateAndSum(block.data(), numChannels, blockSize);
+    }
+
+    return result;
 }
 
 //==============================================================================
@@ -226,29 +1112,56 @@ juce::AudioProcessorEditor* AicDemoAudioProcessor::createEditor()
 //==============================================================================
 void AicDemoAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
-    // Store an XML representation of our state
-    if (auto xmlState = state.copyState().createXml())
-        copyXmlToBinary(*xmlState, destData);
+    // A compact binary representation, several times smaller and faster to parse than XML
+    juce::MemoryOutputStream stream(destData, false);
+    stream.writeInt(stateMagic);
+    stream.writeInt(stateVersion);
+    state.copyState().writeToStream(stream);
 }
 
 void AicDemoAudioProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
-    // Restore the plugin's state from the XML representation
-    if (auto xmlState = getXmlFromBinary(data, sizeInBytes))
-        state.replaceState(juce::ValueTree::fromXml(*xmlState));
+    const aic::trace::ScopedSpan span("setStateInformation");
+
+    auto restored = readState(data, sizeInBytes);
+    if (!restored.hasType(state.state.getType()))
+        return;
+
+    state.replaceState(restored);
+
+    // Wakes the loader, which builds and warms up the model of the restored state right away in
+    // the background. prepareToPlay adopts it, waiting for the build if it is still running.
+    m_loader.configChanged();
+}
+
+void AicDemoAudioProcessor::parameterChanged(const juce::String& parameterID, float newValue)
+{
+    juce::ignoreUnused(parameterID, newValue);
+
+    // Hosts may automate the model on the audio thread, waking the loader takes a lock
+    const aic::realtime::ScopedAllowance allowance("loader woken for a model change");
+    m_loader.configChanged();
 }
 
-bool AicDemoAudioProcessor::validateLicenseKey(const juce::String& licenseKey)
+juce::ValueTree AicDemoAudioProcessor::readState(const void* data, int sizeInBytes) const
 {
-    if (licenseKey.trim().isEmpty())
+    juce::MemoryInputStream stream(data, static_cast<size_t>(juce::jmax(0, sizeInBytes)), false);
+
+    if (sizeInBytes >= 8 && stream.readInt() == stateMagic)
     {
-        return false;
+        // Versions only ever add to the tree, which is read the same way
+        auto version = stream.readInt();
+        if (version >= 1)
+            return juce::ValueTree::readFromStream(stream);
+
+        return {};
     }
 
-    // Test the license key by attempting to create a model
-    auto [testModel, errorCode] =
-        aic::AicModel::create(modelInfos[0].modelType, licenseKey.toStdString());
-    return testModel != nullptr && errorCode == aic::ErrorCode::Success;
+    // Sessions saved by older versions
+    if (auto xmlState = getXmlFromBinary(data, sizeInBytes))
+        return juce::ValueTree::fromXml(*xmlState);
+
+    return {};
 }
 
 bool AicDemoAudioProcessor::saveLicenseKey(const juce::String& licenseKey)
@@ -262,7 +1175,8 @@ bool AicDemoAudioProcessor::saveLicenseKey(const juce::String& licenseKey)
         auto result = parentDir.createDirectory();
         if (result.failed())
         {
-            DBG("Failed to create license directory: " + result.getErrorMessage());
+            aic::log::write(aic::log::Level::Error, aic::log::Code::LicenseDirectoryFailed,
+                            result.getErrorMessage());
             return false;
         }
     }
@@ -282,12 +1196,12 @@ bool AicDemoAudioProcessor::saveLicenseKey(const juce::String& licenseKey)
     }
     else
     {
-        DBG("Failed to open license file for writing!");
+        aic::log::write(aic::log::Level::Error, aic::log::Code::LicenseWriteFailed);
         return false;
     }
 }
 
-bool AicDemoAudioProcessor::loadAndValidateLicense()
+bool AicDemoAudioProcessor::loadLicenseKey()
 {
     juce::File licenseFile = getLicenseFile();
 
@@ -298,50 +1212,58 @@ bool AicDemoAudioProcessor::loadAndValidateLicense()
         {
             juce::String licenseKey = stream.readEntireStreamAsString().trim();
 
-            if (validateLicenseKey(licenseKey))
+            // Valid until the loader fails to create the model with it, no model is built here
+            if (licenseKey.isNotEmpty())
             {
+                const juce::ScopedLock lock(m_configLock);
                 m_licenseKey = licenseKey.toStdString();
                 m_licenseValid.store(true);
                 return true;
             }
             else
             {
-                DBG("Invalid license key found in file!");
+                aic::log::write(aic::log::Level::Warning, aic::log::Code::LicenseInvalid);
                 m_licenseValid.store(false);
                 return false;
             }
         }
         else
         {
-            DBG("Failed to open license file!");
+            aic::log::write(aic::log::Level::Error, aic::log::Code::LicenseReadFailed);
             m_licenseValid.store(false);
             return false;
         }
     }
     else
     {
-        DBG("License file not found!");
+        aic::log::write(aic::log::Level::Info, aic::log::Code::LicenseNotFound);
         m_licenseValid.store(false);
         return false;
     }
 }
 
-void AicDemoAudioProcessor::forceModelRecreation()
+void AicDemoAudioProcessor::activateLicenseKey(const juce::String& licenseKey)
 {
-    if (isLicenseValid())
     {
-        // Get current model index
-        auto currentModelIndex = static_cast<size_t>(state.getRawParameterValue("model")->load());
+        const juce::ScopedLock lock(m_configLock);
+        m_pendingLicenseKey = licenseKey.trim().toStdString();
+    }
 
-        // Recreate the model
-        createModel(currentModelIndex);
+    m_licenseActivation.store(LicenseActivation::Running);
 
-        // Reinitialize if we have valid audio parameters
-        if (m_currentSampleRate > 0 && m_currentNumChannels > 0 && m_currentNumFrames > 0)
-        {
-            initializeModel();
-        }
-    }
+    // The loader creates the model with the new key, and warms it up and publishes it if it is
+    // valid. A rebuild, the model of the current key must not be reused.
+    m_loader.rebuild();
+}
+
+AicDemoAudioProcessor::LicenseActivation AicDemoAudioProcessor::takeLicenseActivationResult()
+{
+    auto activation = m_licenseActivation.load();
+
+    if (activation != LicenseActivation::Idle && activation != LicenseActivation::Running)
+        m_licenseActivation.compare_exchange_strong(activation, LicenseActivation::Idle);
+
+    return activation;
 }
 
 //==============================================================================
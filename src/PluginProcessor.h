@@ -1,6 +1,20 @@
 #pragma once
 
 #include "AicModelInfoBox.h"
+#include "AnticipativeRenderer.h"
+#include "DiskRecorder.h"
+#include "EnhancementBackend.h"
+#include "LevelMeter.h"
+#include "Logging.h"
+#include "ModelLoader.h"
+#include "OfflineRenderer.h"
+#include "ParameterState.h"
+#include "RenderCache.h"
+#include "SpectrumAnalyzer.h"
+#include "StageChain.h"
+#include "Stages.h"
+#include "Tracing.h"
+#include "VadEvents.h"
 #include "juce_core/juce_core.h"
 
 #include <aic.h>
@@ -8,6 +22,7 @@
 #include <array>
 #include <cassert>
 #include <juce_audio_processors/juce_audio_processors.h>
+#include <vector>
 
 // Struct to hold model information
 struct ModelInfo
@@ -19,12 +34,17 @@ struct ModelInfo
 };
 
 //==============================================================================
-class AicDemoAudioProcessor final : public juce::AudioProcessor
+class AicDemoAudioProcessor final : public juce::AudioProcessor,
+                                    private juce::AudioProcessorValueTreeState::Listener
 {
   public:
     //==============================================================================
-    AicDemoAudioProcessor();
-    ~AicDemoAudioProcessor() override = default;
+    /**
+     * @param backend Creates the models, the SDK unless AIC_BACKEND selects a stand-in
+     */
+    explicit AicDemoAudioProcessor(
+        std::unique_ptr<aic::EnhancementBackend> backend = aic::createDefaultBackend());
+    ~AicDemoAudioProcessor() override;
 
     //==============================================================================
     void prepareToPlay(double sampleRate, int samplesPerBlock) override;
@@ -59,7 +79,7 @@ class AicDemoAudioProcessor final : public juce::AudioProcessor
     void getStateInformation(juce::MemoryBlock& destData) override;
     void setStateInformation(const void* data, int sizeInBytes) override;
 
-    const juce::StringArray getModelChoices() const
+    static const juce::StringArray getModelChoices()
     {
         juce::StringArray choices;
         for (const auto& modelInfo : modelInfos)
@@ -69,7 +89,7 @@ class AicDemoAudioProcessor final : public juce::AudioProcessor
         return choices;
     }
 
-    juce::AudioProcessorValueTreeState state;
+    aic::ParameterState state;
 
     /**
      * @brief Checks if the current license key is valid.
@@ -111,17 +131,6 @@ class AicDemoAudioProcessor final : public juce::AudioProcessor
         return licenseFile;
     }
 
-    /**
-     * @brief Validates a license key by attempting to create a model with it.
-     *
-     * This method tests the provided license key by creating a temporary model
-     * and checking if the creation succeeds.
-     *
-     * @param licenseKey The license key to validate
-     * @return true if the license key is valid and can create models, false otherwise
-     */
-    bool validateLicenseKey(const juce::String& licenseKey);
-
     /**
      * @brief Saves a license key to the application's license file.
      *
@@ -134,22 +143,47 @@ class AicDemoAudioProcessor final : public juce::AudioProcessor
     bool saveLicenseKey(const juce::String& licenseKey);
 
     /**
-     * @brief Loads and validates the license key from the application directory.
+     * @brief Loads the license key from the application directory.
+     *
+     * The key is not checked here. The loader creates the active model with it, which validates
+     * it, and invalidates the license if that fails.
+     *
+     * @return true if a license key was found and loaded, false otherwise
+     */
+    bool loadLicenseKey();
+
+    /**
+     * @brief State of the license activation started by activateLicenseKey().
+     */
+    enum class LicenseActivation
+    {
+        Idle,
+        Running,
+        Accepted,
+        // Valid and active, but the key could not be saved for the next session
+        NotSaved,
+        Rejected
+    };
+
+    /**
+     * @brief Activates a license key on the loader thread, returns immediately.
      *
-     * Attempts to load the license key from the standard location and validate it.
-     * Updates the internal license state accordingly.
+     * The key is checked by creating the model of the current configuration with it. If that
+     * succeeds, the key is saved and the same model is initialized, warmed up and published to
+     * the audio thread like any other instance. An invalid key leaves the active license and
+     * model untouched.
      *
-     * @return true if a valid license was found and loaded, false otherwise
+     * @param licenseKey The license key entered by the user
      */
-    bool loadAndValidateLicense();
+    void activateLicenseKey(const juce::String& licenseKey);
 
     /**
-     * @brief Forces recreation of the current model with the updated license.
+     * @brief Returns the result of a finished activation once, afterwards Idle.
      *
-     * This method should be called after a license change to ensure the model
-     * is recreated with the new license key and properly initialized.
+     * @return Accepted, NotSaved or Rejected once the activation finished, Running or Idle
+     * otherwise
      */
-    void forceModelRecreation();
+    LicenseActivation takeLicenseActivationResult();
 
     aic::ui::ModelInfo getModelInfo() const
     {
@@ -159,23 +193,28 @@ class AicDemoAudioProcessor final : public juce::AudioProcessor
         }
         else
         {
+            ModelSnapshot snapshot;
+            {
+                const juce::SpinLock::ScopedLockType lock(m_snapshotLock);
+                snapshot = m_snapshot;
+            }
+
             if (m_processingNotAllowed)
             {
                 return aic::ui::ModelInfo(aic::ui::ModelState::ProcessingNotAllowed);
             }
-            else if (m_model && m_modelIsInitialized)
+            else if (snapshot.initialized)
             {
                 // calculate outputDelay in ms
                 auto outputDelayMs = static_cast<int>(
-                    juce::roundToInt((static_cast<double>(m_model->get_output_delay()) * 1000.0) /
-                                     static_cast<double>(m_currentSampleRate))); // ms
-
-                return aic::ui::ModelInfo(
-                    static_cast<int>(m_model->get_optimal_sample_rate()),
-                    modelInfos[m_activeModelIndex].windowLengthMs,
-                    modelInfos[m_activeModelIndex].modelDelayMs,
-                    static_cast<int>(m_model->get_optimal_num_frames(m_currentSampleRate)),
-                    outputDelayMs);
+                    juce::roundToInt((static_cast<double>(getLatencySamples()) * 1000.0) /
+                                     static_cast<double>(snapshot.sampleRate))); // ms
+
+                return aic::ui::ModelInfo(snapshot.optimalSampleRate,
+                                          modelInfos[snapshot.modelIndex].windowLengthMs,
+                                          modelInfos[snapshot.modelIndex].modelDelayMs,
+                                          snapshot.optimalNumFrames, outputDelayMs,
+                                          snapshot.memory.getTotalBytes());
             }
             else
             {
@@ -184,6 +223,24 @@ class AicDemoAudioProcessor final : public juce::AudioProcessor
         }
     }
 
+    /**
+     * @brief The sample rate and number of frames the active model works best with.
+     */
+    struct ModelOptimum
+    {
+        int sampleRate{0}; // 0 without an initialized model
+        int numFrames{0};  // At the current sample rate
+    };
+
+    ModelOptimum getModelOptimum() const
+    {
+        const juce::SpinLock::ScopedLockType lock(m_snapshotLock);
+        if (!m_snapshot.initialized)
+            return {};
+
+        return {m_snapshot.optimalSampleRate, m_snapshot.optimalNumFrames};
+    }
+
     bool modelChanged() const
     {
         return m_modelChanged.load();
@@ -201,77 +258,388 @@ class AicDemoAudioProcessor final : public juce::AudioProcessor
 
     bool isSpeechDetected() const
     {
-        if (m_vad)
-        {
-            // this is safe to call from UI thread
-            return m_vad->is_speech_detected();
-        }
-        else
+        // updated by the audio thread after every processed block
+        return m_speechDetected.load();
+    }
+
+    /**
+     * @brief Moves the VAD changes recorded by the audio thread into the vector.
+     *
+     * Positions are in samples of the input since prepareToPlay or reset, compensated by the delay
+     * of the model. The VAD decides once per processed block, so changes fall on block boundaries.
+     * Only one thread may collect the events, and only while setCollectingVadEvents() is on.
+     *
+     * @return The number of events appended
+     */
+    int collectVadEvents(std::vector<aic::vad::Event>& events)
+    {
+        return m_vadEvents.popAll(events);
+    }
+
+    /**
+     * @brief Records the VAD changes for collectVadEvents() while on, off by default.
+     *
+     * Nothing in the plugin itself collects them, the queue would fill up and drop the changes.
+     * Turned on by the tools that export them, before the blocks they export are processed.
+     */
+    void setCollectingVadEvents(bool collecting)
+    {
+        m_collectingVadEvents.store(collecting);
+    }
+
+    /**
+     * @brief Moves the VAD changes for the editor into the vector, a queue separate from
+     * collectVadEvents(). Only called by the editor.
+     */
+    int collectEditorVadEvents(std::vector<aic::vad::Event>& events)
+    {
+        return m_vadEditorEvents.popAll(events);
+    }
+
+    /**
+     * @brief Gets the stream position of the end of the last block, in the timeline of the VAD
+     * events.
+     */
+    std::int64_t getVadPosition() const
+    {
+        return m_vadTimelinePosition.load();
+    }
+
+    /**
+     * @brief Settings of the warm-up that runs after a model has been initialized.
+     *
+     * The first blocks a model processes are much slower than the following ones, the SDK
+     * allocates lazily and the weights are faulted in. The warm-up processes this audio on the
+     * loader thread before the model is published to the audio thread.
+     */
+    struct WarmUpSettings
+    {
+        // Duration of the audio processed before the model is published, 0 disables the warm-up
+        int durationMs{250};
+
+        // Low-level noise instead of silence, so no code path is skipped for quiet input
+        bool useNoise{true};
+
+        // Locks the pages of the whole host process into RAM afterwards, see lockProcessMemory()
+        bool lockMemory{false};
+    };
+
+    void setWarmUpSettings(const WarmUpSettings& settings)
+    {
+        const juce::ScopedLock lock(m_configLock);
+        m_warmUpSettings = settings;
+    }
+
+    WarmUpSettings getWarmUpSettings() const
+    {
+        const juce::ScopedLock lock(m_configLock);
+        return m_warmUpSettings;
+    }
+
+    /**
+     * @brief Resident memory a model needed, measured while it was created and initialized.
+     */
+    struct ModelMemoryUsage
+    {
+        // -1 if the resident memory can not be measured on this platform
+        juce::int64 createBytes{-1};
+        juce::int64 initializeBytes{-1};
+
+        juce::int64 getTotalBytes() const
         {
-            return false;
+            if (createBytes < 0 || initializeBytes < 0)
+                return -1;
+
+            return createBytes + initializeBytes;
         }
+    };
+
+    /**
+     * @brief Gets the memory usage of the most recently published model.
+     */
+    ModelMemoryUsage getModelMemoryUsage() const
+    {
+        const juce::SpinLock::ScopedLockType lock(m_snapshotLock);
+        return m_snapshot.memory;
+    }
+
+    struct MeterLevels
+    {
+        aic::dsp::LevelMeter::Levels input;
+        aic::dsp::LevelMeter::Levels output;
+    };
+
+    /**
+     * @brief Gets the smoothed levels of the host buffer before and after processing.
+     *
+     * Updated by the audio thread after every block, can be read at any rate.
+     */
+    MeterLevels getMeterLevels() const
+    {
+        return {m_inputMeter.getLevels(), m_outputMeter.getLevels()};
+    }
+
+    /**
+     * @brief Gets the analyzer of the input and output spectrum, shown by the editor.
+     */
+    aic::SpectrumAnalyzer& getSpectrumAnalyzer()
+    {
+        return m_spectrum;
+    }
+
+    /**
+     * @brief Gets the cache of enhanced blocks, e.g. to count its hits.
+     */
+    const aic::dsp::RenderCache& getRenderCache() const
+    {
+        return m_renderCache;
+    }
+
+    /**
+     * @brief Gets the recorder of the input, output and VAD, started by the standalone editor.
+     */
+    aic::DiskRecorder& getDiskRecorder()
+    {
+        return m_diskRecorder;
+    }
+
+    /**
+     * @brief Checks if a warmed up model has been published since the last prepareToPlay call.
+     *
+     * Until then the audio passes through unprocessed.
+     */
+    bool isModelReady() const
+    {
+        return m_modelReady.load();
+    }
+
+    /**
+     * @brief Checks if blocks are rendered by the offline renderer.
+     *
+     * Its lanes are set up by prepareToPlay while the host renders offline. When the host switches
+     * back to realtime processing, the blocks take the regular path again.
+     */
+    bool isRenderingOffline() const
+    {
+        return m_offlineActive && isNonRealtime();
     }
 
   private:
+    struct ModelSnapshot
+    {
+        bool     initialized{false};
+        size_t   modelIndex{0};
+        uint32_t sampleRate{48000};
+        int      optimalSampleRate{0};
+        int      optimalNumFrames{0};
+
+        ModelMemoryUsage memory;
+    };
+
     /**
-     * @brief Creates a new model instance with the current license key.
+     * @brief Creates a new model instance with the given license key.
      *
-     * Attempts to create a model of the specified type using the currently
-     * stored license key. Updates the license validity state based on whether
-     * model creation succeeds.
+     * Attempts to create a model of the specified type. Updates the license validity state based
+     * on whether model creation succeeds.
      *
      * @param index Index of the model type to create (will be clamped to valid range)
+     * @return The uninitialized instance, or nullptr if the model could not be created
      */
-    void createModel(size_t index)
-    {
-        index = static_cast<size_t>(
-            juce::jlimit(0, static_cast<int>(m_numModels - 1), static_cast<int>(index)));
+    std::unique_ptr<aic::ModelInstance> createModelInstance(size_t             index,
+                                                            const std::string& licenseKey);
 
-        // Only attempt to create model if we have a license key
-        if (m_licenseKey.empty())
-        {
-            m_licenseValid.store(false);
-            m_model              = nullptr;
-            m_modelIsInitialized = false;
-            return;
-        }
+    /**
+     * @brief Initializes the model of the instance for the audio settings of its config.
+     */
+    void initializeModelInstance(aic::ModelInstance& instance);
 
-        auto [model, errorCode] = aic::AicModel::create(modelInfos[index].modelType, m_licenseKey);
-        if (model && errorCode == aic::ErrorCode::Success)
-        {
-            m_licenseValid.store(true);
-            m_model = std::move(model);
-            // create VAD
-            auto [vad, errorCodeVad] = aic::AicVad::create(*m_model);
-            if (vad && errorCodeVad == aic::ErrorCode::Success)
-            {
-                m_vad = std::move(vad);
-            }
-            else
-            {
-                m_vad = nullptr;
-            }
-        }
-        else
-        {
-            m_licenseValid.store(false);
-            m_model              = nullptr;
-            m_modelIsInitialized = false;
-        }
+    /**
+     * @brief Processes the warm-up audio with the instance and resets it afterwards.
+     */
+    void warmUpModelInstance(aic::ModelInstance& instance, const WarmUpSettings& settings);
+
+    /**
+     * @brief Builds a ready-to-use instance, called on the loader thread.
+     *
+     * The model of the reused instance is kept if it has the right type, otherwise a new one
+     * is created.
+     */
+    std::unique_ptr<aic::ModelInstance>
+    buildModelInstance(const aic::ModelConfig& config, std::unique_ptr<aic::ModelInstance> reuse);
+
+    /**
+     * @brief Initializes the model for the current audio settings while the audio thread is
+     * stopped, so the latency is known right away. The warm-up runs on the loader thread.
+     *
+     * Adopts the instance the loader built or is building, no model is created here. If there is
+     * none for the selected model, the loader builds it and the latency is updated once the audio
+     * thread takes it over.
+     */
+    void prepareModel();
+
+    /**
+     * @brief Builds a model per lane of the offline renderer if the host renders offline.
+     *
+     * Called in prepareToPlay after prepareModel. The lanes use the model selected at this point,
+     * the offline renderer is not used without a license or with fewer than two cores.
+     */
+    void prepareOfflineRendering();
+
+    /**
+     * @brief Switches to the instance published by the loader, called on the audio thread.
+     */
+    void adoptPublishedModel();
+
+    /**
+     * @brief Model and audio settings the loader should build for.
+     *
+     * The audio settings must only be read by the loader while holding m_configLock.
+     */
+    aic::ModelConfig getDesiredModelConfig() const;
+
+    void publishModelInfo(const aic::ModelInstance& instance);
+
+    /**
+     * @brief Wakes the loader when the model or band-split parameter changes.
+     */
+    void parameterChanged(const juce::String& parameterID, float newValue) override;
+
+    /**
+     * @brief Delays the input passed through without a model by the reported latency.
+     */
+    void delayPassThrough(juce::AudioBuffer<float>& buffer, int numChannels);
+
+    /**
+     * @brief Clears the state only the audio thread uses, at the start of the block after reset().
+     */
+    void resetAudioThreadState();
+
+    /**
+     * @brief Clears the model and everything rendered with it, once the audio thread owns it.
+     */
+    void resetModelState();
+
+    int getTotalLatencySamples() const
+    {
+        // The lanes keep the model of the start of the bounce, whatever the loader swaps in
+        if (isRenderingOffline())
+            return static_cast<int>(m_offlineInstances.front()->outputDelaySamples) +
+                   m_offlineRenderer.getLatencySamples() + m_stages.getLatencySamples();
+
+        auto lookahead = m_anticipativeEnabled ? m_renderer.getLatencySamples() : 0;
+        return static_cast<int>(m_outputDelaySamples) + lookahead + m_stages.getLatencySamples();
     }
 
-    void initializeModel()
+    /**
+     * @brief How far the VAD result lags the input, the delay of the model including the band
+     * split. Offline the lanes report it with the output of their chunk, one chunk later.
+     *
+     * Unlike the latency, the lookahead of the anticipative renderer and the stages are not
+     * included, the VAD decides on the model output before they delay it.
+     */
+    int getVadDelaySamples() const
     {
-        if (m_model)
-        {
-            auto errorCode       = m_model->initialize(m_currentSampleRate, m_currentNumChannels,
-                                                       m_currentNumFrames, true);
-            m_modelIsInitialized = errorCode == aic::ErrorCode::Success;
-            m_modelChanged.store(true);
-            setLatencySamples((int) m_model->get_output_delay());
-        }
+        if (isRenderingOffline())
+            return static_cast<int>(m_offlineInstances.front()->outputDelaySamples) +
+                   m_offlineRenderer.getLatencySamples();
+
+        return static_cast<int>(m_outputDelaySamples);
     }
 
+    /**
+     * @brief Reports the latency to the host, also called on the audio thread when it changes
+     * while processing.
+     */
+    void updateLatency();
+
+    /**
+     * @brief Checks the host playhead to decide whether the input is known ahead of time.
+     *
+     * @return true during continuous timeline playback, false for live input, seeks and loops
+     */
+    bool shouldAnticipate(int numSamples);
+
+    /**
+     * @brief Runs the model on the given channels in place.
+     *
+     * Called on the audio thread, or on the background thread of the anticipative renderer.
+     */
+    void renderModel(float* const* channels, int numChannels, int numSamples);
+
+    /**
+     * @brief Renders a segment with the model of the lane, called on a thread of the offline
+     * renderer.
+     *
+     * The parameters change within the segment where they changed during collection, and the VAD
+     * result is written for every sample, like the audio thread would have seen it.
+     */
+    void renderOfflineLane(int lane, const aic::dsp::OfflineRenderer::Segment& segment);
+
+    /**
+     * @brief Runs the model without the render cache.
+     *
+     * @return The error code of the last model call
+     */
+    aic::ErrorCode processModel(float* const* channels, int numChannels, int numSamples);
+
+    /**
+     * @brief Advances the stream position and queues an event if the VAD result changed.
+     *
+     * Called on the audio thread after every block.
+     */
+    void recordVadState(int numSamples);
+
+    /**
+     * @brief Runs the stages after the model, then measures the output and records the VAD state
+     * at the end of every block.
+     */
+    void finishBlock(juce::AudioBuffer<float>& buffer);
+
+    /**
+     * @brief Sets up the stages around the model from the current parameter values.
+     */
+    void applyStageParameters();
+
+    /**
+     * @brief Reads a state written by getStateInformation(), or the XML state of older versions.
+     *
+     * @return The parameter tree, or an invalid tree if the data is neither
+     */
+    juce::ValueTree readState(const void* data, int sizeInBytes) const;
+
+    /**
+     * @brief Reads the current values of the parameters of the model and its VAD.
+     */
+    aic::ModelParameters getModelParameters() const;
+
+    /**
+     * @brief Sets the parameter values on the model and VAD of the instance.
+     */
+    void applyParameters(aic::ModelInstance& instance, const aic::ModelParameters& parameters);
+
+    /**
+     * @brief Runs the model of the instance in place, fullband or band-split.
+     *
+     * @return The error code of the last model call
+     */
+    aic::ErrorCode runModel(aic::ModelInstance& instance, float* const* channels, int numChannels,
+                            int numSamples);
+
+    /**
+     * @brief Hashes all parameters the output depends on, part of every render cache key.
+     */
+    std::uint64_t getRenderCacheParameterHash();
+
+    /**
+     * @brief Processes the buffer with the band-split engine.
+     *
+     * The low band is processed by the model at its native rate, the high band follows the VAD.
+     *
+     * @return The error code of the last model call
+     */
+    aic::ErrorCode processBandSplit(aic::ModelInstance& instance, float* const* channels,
+                                    int numChannels, int numSamples);
+
     // Define all models here
     inline static const std::array<ModelInfo, 9> modelInfos = {
         {{"Quail L", aic::ModelType::Quail_L48, 10, 30},
@@ -285,21 +653,146 @@ class AicDemoAudioProcessor final : public juce::AudioProcessor
          {"Quail S8", aic::ModelType::Quail_S8, 10, 30}}};
     static constexpr size_t m_numModels = modelInfos.size();
 
-    std::unique_ptr<aic::AicModel> m_model;
-    std::unique_ptr<aic::AicVad>   m_vad;
+    // Amplitude of the warm-up noise, roughly -40 dBFS
+    static constexpr float warmUpNoiseLevel = 0.01f;
+
+    // The binary state starts with "aicS" and the format version, followed by the parameter tree
+    // as a binary value tree. Older versions stored XML.
+    static constexpr int stateMagic   = 0x53636961;
+    static constexpr int stateVersion = 1;
+
+    // Shared by all instances. Declared first, so they outlive every member whose thread logs or
+    // traces, such as the disk recorder and the render cache.
+    juce::SharedResourcePointer<aic::log::Logger> m_logger;
+
+    // Writes the trace if AIC_TRACE is set
+    juce::SharedResourcePointer<aic::trace::Recorder> m_traceRecorder;
+
+    // Guards everything the loader thread reads from the message thread
+    juce::CriticalSection m_configLock;
 
     std::string       m_licenseKey;
     std::atomic<bool> m_licenseValid = {false};
 
-    bool m_processingNotAllowed = {false};
+    // Key to activate on the next build of the loader, guarded by the config lock
+    std::string                    m_pendingLicenseKey;
+    std::atomic<LicenseActivation> m_licenseActivation{LicenseActivation::Idle};
+
+    std::atomic<bool> m_processingNotAllowed = {false};
+
+    // Result of the previous block, logged when it changes. Only used by the thread processing.
+    aic::ErrorCode m_lastProcessingResult{aic::ErrorCode::Success};
 
-    size_t            m_activeModelIndex{0};
     uint32_t          m_currentSampleRate{48000};
     uint16_t          m_currentNumChannels{2};
     size_t            m_currentNumFrames{480};
     std::atomic<bool> m_modelChanged{false};
 
-    bool m_modelIsInitialized{false};
+    WarmUpSettings    m_warmUpSettings;
+    std::atomic<bool> m_modelReady{false};
+    std::atomic<bool> m_speechDetected{false};
+
+    // Set by reset(), which may be called on any thread while the background thread renders. The
+    // audio thread clears its own state on the next block and the model once it is handed back.
+    std::atomic<bool> m_resetPending{false};
+    bool              m_modelResetPending{false};
+
+    // VAD changes for exports and offline runners and for the editor, pushed by the audio thread
+    aic::vad::EventQueue      m_vadEvents;
+    std::atomic<bool>         m_collectingVadEvents{false};
+    aic::vad::EventQueue      m_vadEditorEvents;
+    std::int64_t              m_vadPosition{0};
+    bool                      m_vadSpeech{false};
+    std::atomic<std::int64_t> m_vadTimelinePosition{0};
+    juce::AudioParameterBool* m_vadStateParameter{nullptr};
+
+    // Values read while processing, looked up once instead of by ID in every block
+    struct ParameterValues
+    {
+        std::atomic<float>* model{nullptr};
+        std::atomic<float>* bandSplit{nullptr};
+        std::atomic<float>* bypass{nullptr};
+        std::atomic<float>* enhancement{nullptr};
+        std::atomic<float>* voiceGain{nullptr};
+        std::atomic<float>* vadLookback{nullptr};
+        std::atomic<float>* vadSensitivity{nullptr};
+        std::atomic<float>* anticipative{nullptr};
+        std::atomic<float>* renderCache{nullptr};
+        std::atomic<float>* highPass{nullptr};
+        std::atomic<float>* highPassFrequency{nullptr};
+        std::atomic<float>* trim{nullptr};
+        std::atomic<float>* gate{nullptr};
+        std::atomic<float>* gateThreshold{nullptr};
+        std::atomic<float>* limiter{nullptr};
+        std::atomic<float>* limiterCeiling{nullptr};
+    };
+
+    ParameterValues m_parameters;
+
+    // model info of the last published instance, read by the editor
+    mutable juce::SpinLock m_snapshotLock;
+    ModelSnapshot          m_snapshot;
+
+    size_t m_outputDelaySamples{0};
+
+    // Longest output delay of a model including the band split, the pass-through can match it
+    static constexpr double maxPassThroughModelDelaySeconds = 0.1;
+
+    juce::dsp::DelayLine<float, juce::dsp::DelayLineInterpolationTypes::None> m_passThroughDelay;
+
+    static constexpr double anticipationLookaheadSeconds = 0.2;
+
+    bool        m_anticipativeEnabled{false};
+    juce::int64 m_expectedTimeInSamples{0};
+
+    // A key covers this much input, enough for the model state to be determined by it, aic-soak
+    // measures how far the model is off when a run of hits ends
+    static constexpr double renderCacheHistorySeconds = 0.1;
+
+    aic::dsp::RenderCache m_renderCache;
+
+    aic::dsp::LevelMeter m_inputMeter;
+    aic::dsp::LevelMeter m_outputMeter;
+
+    aic::SpectrumAnalyzer m_spectrum;
+
+    aic::DiskRecorder m_diskRecorder;
+
+    // Optional stages before and after the model, replacing separate plugins in the host
+    aic::dsp::HighPassStage        m_highPass;
+    aic::dsp::TrimStage            m_trim;
+    aic::dsp::NoiseGateStage       m_gate;
+    aic::dsp::TruePeakLimiterStage m_limiter;
+    aic::dsp::StageChain           m_stages;
+
+    // The instance the audio thread processes with, only replaced by the audio thread itself or
+    // while it is stopped
+    std::unique_ptr<aic::ModelInstance> m_instance;
+
+    // Used by the loader thread, declared before it
+    std::unique_ptr<aic::EnhancementBackend> m_backend;
+
+    aic::ModelLoader m_loader;
+
+    // Offline bounces are rendered in chunks, this much of it is processed per lane
+    static constexpr double offlineSegmentSeconds = 1.0;
+
+    // Input each lane is primed with in addition to the output delay of the model
+    static constexpr double offlineHistorySeconds = 0.1;
+
+    static constexpr int maxOfflineLanes = 8;
+
+    // Models of the lanes, only used while the offline renderer is active
+    std::vector<std::unique_ptr<aic::ModelInstance>> m_offlineInstances;
+    bool                                             m_offlineActive{false};
+
+    // Whether the last block was rendered offline, the latency changes with it
+    bool m_renderingOffline{false};
+
+    aic::dsp::OfflineRenderer m_offlineRenderer;
+
+    // Declared last so its background thread is stopped before anything it renders with
+    aic::dsp::AnticipativeRenderer m_renderer;
 
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AicDemoAudioProcessor)
@@ -0,0 +1,151 @@
+#pragma once
+
+#ifndef AIC_REALTIME_CHECKS
+#define AIC_REALTIME_CHECKS 0
+#endif
+
+#if defined(__has_feature)
+#if __has_feature(realtime_sanitizer)
+#define AIC_HAS_REALTIME_SANITIZER 1
+#include <sanitizer/rtsan_interface.h>
+#endif
+#endif
+
+#ifndef AIC_HAS_REALTIME_SANITIZER
+#define AIC_HAS_REALTIME_SANITIZER 0
+#endif
+
+#include <atomic>
+
+namespace aic::realtime
+{
+
+/**
+ * @brief Marks the calling thread as a real-time thread for its lifetime.
+ *
+ * Does nothing unless the sources are compiled with AIC_REALTIME_CHECKS, like in aic-rtcheck,
+ * which then reports allocations, locks and blocking system calls made within the scope. Built
+ * with Clang's RealtimeSanitizer (-fsanitize=realtime) the sanitizer checks the scope as well.
+ */
+class ScopedContext
+{
+  public:
+#if AIC_REALTIME_CHECKS
+    ScopedContext() noexcept
+    {
+        ++depth();
+#if AIC_HAS_REALTIME_SANITIZER
+        __rtsan_realtime_enter();
+#endif
+    }
+
+    ~ScopedContext()
+    {
+#if AIC_HAS_REALTIME_SANITIZER
+        __rtsan_realtime_exit();
+#endif
+        --depth();
+    }
+
+    /**
+     * @brief Whether the calling thread is in a real-time scope and no allowance is active.
+     */
+    static bool isActive() noexcept
+    {
+        return depth() > 0 && allowanceDepth() == 0;
+    }
+
+  private:
+    friend class ScopedAllowance;
+
+    static int& depth() noexcept
+    {
+        static thread_local int value = 0;
+        return value;
+    }
+
+    static int& allowanceDepth() noexcept
+    {
+        static thread_local int value = 0;
+        return value;
+    }
+#else
+    ScopedContext() noexcept = default;
+
+    static bool isActive() noexcept
+    {
+        return false;
+    }
+#endif
+
+    ScopedContext(const ScopedContext&)            = delete;
+    ScopedContext& operator=(const ScopedContext&) = delete;
+};
+
+/**
+ * @brief Accepts a known call that is not real-time safe within a real-time scope.
+ *
+ * Only for calls the plugin cannot avoid, the reason documents why it is accepted.
+ */
+class ScopedAllowance
+{
+  public:
+#if AIC_REALTIME_CHECKS
+    explicit ScopedAllowance(const char* reason) noexcept
+    {
+        static_cast<void>(reason);
+        ++ScopedContext::allowanceDepth();
+#if AIC_HAS_REALTIME_SANITIZER
+        __rtsan_disable();
+#endif
+    }
+
+    ~ScopedAllowance()
+    {
+#if AIC_HAS_REALTIME_SANITIZER
+        __rtsan_enable();
+#endif
+        --ScopedContext::allowanceDepth();
+    }
+#else
+    explicit ScopedAllowance(const char* reason) noexcept
+    {
+        static_cast<void>(reason);
+    }
+#endif
+
+    ScopedAllowance(const ScopedAllowance&)            = delete;
+    ScopedAllowance& operator=(const ScopedAllowance&) = delete;
+};
+
+#if AIC_REALTIME_CHECKS
+/**
+ * @brief Receives the calls passed to reportCall(), installed by aic-rtcheck.
+ */
+inline std::atomic<void (*)(const char* call)> callHandler{nullptr};
+#endif
+
+/**
+ * @brief Reports a call the interceptors cannot see if it is made within a real-time scope.
+ *
+ * For calls that neither allocate nor lock but are still too slow for the audio thread, e.g. a
+ * parameter lookup by ID. Does nothing unless the sources are compiled with AIC_REALTIME_CHECKS.
+ */
+inline void reportCall(const char* call) noexcept
+{
+#if AIC_REALTIME_CHECKS
+    if (!ScopedContext::isActive())
+        return;
+
+#if AIC_HAS_REALTIME_SANITIZER
+    __rtsan_notify_blocking_call(call);
+#else
+    if (auto* handler = callHandler.load())
+        handler(call);
+#endif
+#else
+    static_cast<void>(call);
+#endif
+}
+
+} // namespace aic::realtime
@@ -0,0 +1,554 @@
+#include "RenderCache.h"
+
+#include "RealtimeSafety.h"
+
+#include <cstring>
+
+namespace aic::dsp
+{
+
+namespace
+{
+constexpr char          cacheMagic[8] = {'A', 'I', 'C', 'C', 'A', 'C', 'H', 'E'};
+constexpr std::uint32_t cacheVersion  = 2;
+
+constexpr std::uint64_t prime0 = 0x9E3779B97F4A7C15ull;
+constexpr std::uint64_t prime1 = 0xC2B2AE3D27D4EB4Full;
+} // namespace
+
+RenderCache::RenderCache() : juce::Thread("aic render cache")
+{
+}
+
+RenderCache::~RenderCache()
+{
+    release();
+}
+
+void RenderCache::prepare(const juce::File& directory, int numChannels, int maxBlockSize,
+                          int historySamples)
+{
+    release();
+
+    m_directory      = directory;
+    m_numChannels    = numChannels;
+    m_maxBlockSize   = maxBlockSize;
+    m_historySamples = historySamples;
+
+    m_pendingFifo.reset();
+    m_pending.resize(static_cast<size_t>(pendingBlocks));
+    for (auto& block : m_pending)
+        block.samples.resize(static_cast<size_t>(numChannels * maxBlockSize));
+
+    m_history.setSize(numChannels, historySamples + maxBlockSize);
+    m_scratch.setSize(numChannels, maxBlockSize);
+
+    // Everything lookups and priming read on the audio thread, written once so it is resident.
+    // The mapped file is not covered, which is why lookups only read the staged blocks.
+    m_staged.assign(static_cast<size_t>(stagedBlocks) * getSlotSize(), 0);
+    for (auto& stagedKey : m_stagedKeys)
+        stagedKey.store(0);
+    m_history.clear();
+    m_scratch.clear();
+    resetHistory();
+
+    m_failed.store(false);
+
+    startThread(juce::Thread::Priority::background);
+}
+
+void RenderCache::release()
+{
+    stopThread(1000);
+
+    m_slots.store(nullptr);
+    m_file.reset();
+}
+
+void RenderCache::setEnabled(bool shouldBeEnabled)
+{
+    // The file could not be opened, retrying would only fail again
+    if (m_failed.load())
+        shouldBeEnabled = false;
+
+    if (m_enabled.exchange(shouldBeEnabled) != shouldBeEnabled && shouldBeEnabled)
+    {
+        const aic::realtime::ScopedAllowance allowance("render cache switched on");
+        notify();
+    }
+}
+
+void RenderCache::resetHistory()
+{
+    m_numBlockHashes   = 0;
+    m_newestBlockHash  = 0;
+    m_historyEnd       = 0;
+    m_skippedEnd       = 0;
+    m_skippedSamples   = 0;
+    m_currentKey       = 0;
+    m_previousKey      = 0;
+    m_predictedKey     = 0;
+    m_lookaheadSamples = 0;
+}
+
+std::uint64_t RenderCache::beginBlock(const float* const* input, int numChannels, int numSamples,
+                                      std::uint64_t parameterHash)
+{
+    if (numSamples <= 0 || numSamples > m_maxBlockSize || numChannels > m_numChannels)
+    {
+        resetHistory();
+        return 0;
+    }
+
+    // Hash the block and remember the input in case the model has to be primed later
+    auto blockHash = combine(static_cast<std::uint64_t>(numSamples),
+                             static_cast<std::uint64_t>(numChannels));
+
+    const auto historySize = m_history.getNumSamples();
+    const auto offset      = static_cast<int>(m_historyEnd % historySize);
+    const auto first       = juce::jmin(numSamples, historySize - offset);
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        blockHash = hash(input[ch], sizeof(float) * static_cast<size_t>(numSamples), blockHash);
+
+        m_history.copyFrom(ch, offset, input[ch], first);
+        if (first < numSamples)
+            m_history.copyFrom(ch, 0, input[ch] + first, numSamples - first);
+    }
+
+    m_historyEnd += numSamples;
+
+    m_newestBlockHash = (m_newestBlockHash + 1) % maxBlockHashes;
+    m_blockHashes[static_cast<size_t>(m_newestBlockHash)] = {blockHash, numSamples};
+    m_numBlockHashes = juce::jmin(m_numBlockHashes + 1, maxBlockHashes);
+
+    // The key covers the current block and enough preceding blocks to determine the model state
+    auto key  = parameterHash;
+    int  span = 0;
+    for (int i = 0; i < m_numBlockHashes && span < m_historySamples + numSamples; ++i)
+    {
+        const auto& entry =
+            m_blockHashes[static_cast<size_t>((m_newestBlockHash - i + maxBlockHashes) %
+                                              maxBlockHashes)];
+        key = combine(key, entry.hash);
+        span += entry.numSamples;
+    }
+
+    // Not enough history yet, or blocks too small to cover it
+    if (span < m_historySamples + numSamples)
+        key = 0;
+    else if (key == 0)
+        key = 1;
+
+    m_previousKey = m_currentKey;
+    m_currentKey  = key;
+    return key;
+}
+
+bool RenderCache::lookup(std::uint64_t key, float* const* output, int numChannels, int numSamples,
+                         bool& speechDetected)
+{
+    auto predictedKey  = m_predictedKey;
+    auto lookahead     = m_lookaheadSamples;
+    m_predictedKey     = 0;
+    m_lookaheadSamples = 0;
+
+    if (key == 0 || !isEnabled())
+        return false;
+
+    // The background thread stages the blocks linked after this one for the next lookups
+    m_stageKey.store(key);
+
+    auto* slot = getStaged(key);
+    if (slot == nullptr)
+    {
+        m_misses.fetch_add(1);
+        return false;
+    }
+
+    // The slot may be rewritten concurrently, copy it first and validate the copy afterwards
+    SlotHeader header;
+    std::memcpy(&header, slot, sizeof(SlotHeader));
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    if (header.key != key || header.numSamples != static_cast<std::uint32_t>(numSamples) ||
+        header.numChannels != static_cast<std::uint32_t>(numChannels))
+    {
+        m_misses.fetch_add(1);
+        return false;
+    }
+
+    auto*         samples     = reinterpret_cast<const float*>(slot + sizeof(SlotHeader));
+    std::uint64_t sumOfChecks = 0;
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        juce::FloatVectorOperations::copy(output[ch], samples + ch * m_maxBlockSize, numSamples);
+        sumOfChecks = combine(sumOfChecks, checksum(output[ch], numSamples));
+    }
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    SlotHeader after;
+    std::memcpy(&after, slot, sizeof(SlotHeader));
+
+    if (sumOfChecks != header.checksum || after.key != key)
+    {
+        m_misses.fetch_add(1);
+        return false;
+    }
+
+    // Link the previous block to this one unless its slot already does
+    if (predictedKey != key)
+        queueLink(m_previousKey, key);
+
+    // Continue the lookahead of the run, or start a new one from this block
+    if (predictedKey == key && lookahead > numSamples)
+        m_lookaheadSamples = lookahead - numSamples;
+    else
+        m_lookaheadNextKey = header.nextKey;
+
+    m_predictedKey = header.nextKey;
+    speechDetected = (header.flags & speechFlag) != 0;
+
+    m_skippedSamples = juce::jmin(m_skippedSamples + numSamples, m_historySamples);
+    m_skippedEnd     = m_historyEnd;
+    m_hits.fetch_add(1);
+    return true;
+}
+
+bool RenderCache::isHitRunEnding()
+{
+    // A few links per call, the lookahead only moves by one block per hit once it is known
+    for (int i = 0; i < maxLinksPerHit && m_lookaheadSamples < m_historySamples; ++i)
+    {
+        auto* slot = m_lookaheadNextKey != 0 ? getStaged(m_lookaheadNextKey) : nullptr;
+        if (slot == nullptr)
+            break;
+
+        SlotHeader header;
+        std::memcpy(&header, slot, sizeof(SlotHeader));
+        if (header.key != m_lookaheadNextKey)
+            break;
+
+        m_lookaheadSamples += static_cast<int>(header.numSamples);
+        m_lookaheadNextKey = header.nextKey;
+    }
+
+    return m_lookaheadSamples < m_historySamples;
+}
+
+void RenderCache::store(std::uint64_t key, const float* const* output, int numChannels,
+                        int numSamples, bool speechDetected)
+{
+    if (key == 0 || !isEnabled() || m_slots.load() == nullptr)
+        return;
+
+    // Results are dropped when the background thread can not keep up
+    auto scope = m_pendingFifo.write(1);
+    if (scope.blockSize1 == 0)
+        return;
+
+    auto& block       = m_pending[static_cast<size_t>(scope.startIndex1)];
+    block.key         = key;
+    block.previousKey = m_previousKey;
+    block.numSamples  = numSamples;
+    block.numChannels = numChannels;
+    block.flags       = speechDetected ? speechFlag : 0;
+    for (int ch = 0; ch < numChannels; ++ch)
+        std::memcpy(block.samples.data() + ch * m_maxBlockSize, output[ch],
+                    sizeof(float) * static_cast<size_t>(numSamples));
+}
+
+void RenderCache::queueLink(std::uint64_t previousKey, std::uint64_t key)
+{
+    if (previousKey == 0 || m_slots.load() == nullptr)
+        return;
+
+    auto scope = m_pendingFifo.write(1);
+    if (scope.blockSize1 == 0)
+        return;
+
+    auto& block       = m_pending[static_cast<size_t>(scope.startIndex1)];
+    block.key         = key;
+    block.previousKey = previousKey;
+    block.numSamples  = 0;
+    block.numChannels = 0;
+    block.flags       = 0;
+}
+
+void RenderCache::readHistory(juce::int64 position, int numSamples)
+{
+    const auto historySize = m_history.getNumSamples();
+    const auto offset      = static_cast<int>(position % historySize);
+    const auto first       = juce::jmin(numSamples, historySize - offset);
+
+    for (int ch = 0; ch < m_numChannels; ++ch)
+    {
+        m_scratch.copyFrom(ch, 0, m_history, ch, offset, first);
+        if (first < numSamples)
+            m_scratch.copyFrom(ch, first, m_history, ch, 0, numSamples - first);
+    }
+}
+
+void RenderCache::run()
+{
+    while (!threadShouldExit())
+    {
+        if (isEnabled() && m_slots.load() == nullptr && !openFile())
+        {
+            // Retrying would only fail again, the cache stays disabled for this session
+            m_failed.store(true);
+            m_enabled.store(false);
+        }
+
+        writePending();
+        stageAhead(m_stageKey.load());
+
+        // Sleeps until setEnabled switches the cache back on
+        wait(isEnabled() ? 10 : -1);
+    }
+}
+
+bool RenderCache::openFile()
+{
+    if (!m_directory.createDirectory())
+        return false;
+
+    const auto slotSize = getSlotSize();
+    const auto numSlots =
+        static_cast<std::uint32_t>((maxFileSize - static_cast<juce::int64>(fileHeaderSize)) /
+                                   static_cast<juce::int64>(slotSize));
+    const auto fileSize =
+        static_cast<juce::int64>(fileHeaderSize) + static_cast<juce::int64>(numSlots * slotSize);
+
+    FileHeader expected{};
+    std::memcpy(expected.magic, cacheMagic, sizeof(cacheMagic));
+    expected.version     = cacheVersion;
+    expected.numChannels = static_cast<std::uint32_t>(m_numChannels);
+    expected.slotFrames  = static_cast<std::uint32_t>(m_maxBlockSize);
+    expected.numSlots    = numSlots;
+
+    // One file per layout, instances with the same block size share their results
+    auto file = m_directory.getChildFile("render-cache-" + juce::String(m_numChannels) + "x" +
+                                         juce::String(m_maxBlockSize) + ".bin");
+
+    // Recreate files written by a different version or with a different layout. A new file is
+    // sparse, its slots read as empty without a page being written.
+    auto matches = file.getSize() == fileSize;
+    if (matches)
+    {
+        FileHeader existing{};
+        juce::FileInputStream header(file);
+        matches = header.openedOk() &&
+                  header.read(&existing, sizeof(FileHeader)) == sizeof(FileHeader) &&
+                  std::memcmp(&existing, &expected, sizeof(FileHeader)) == 0;
+    }
+
+    if (!matches)
+    {
+        file.deleteFile();
+
+        juce::FileOutputStream stream(file);
+        if (!stream.openedOk())
+            return false;
+
+        stream.write(&expected, sizeof(FileHeader));
+        stream.setPosition(fileSize - 1);
+        stream.writeByte(0);
+        stream.flush();
+    }
+
+    auto mapped = std::make_unique<juce::MemoryMappedFile>(
+        file, juce::MemoryMappedFile::readWrite, false);
+    if (mapped->getData() == nullptr || static_cast<juce::int64>(mapped->getSize()) != fileSize)
+        return false;
+
+    // Another instance recreated the file with a different layout in the meantime
+    auto* data = static_cast<char*>(mapped->getData());
+    if (std::memcmp(data, &expected, sizeof(FileHeader)) != 0)
+        return false;
+
+    m_file     = std::move(mapped);
+    m_numSlots = numSlots;
+    m_slots.store(data + fileHeaderSize);
+    return true;
+}
+
+void RenderCache::writePending()
+{
+    while (m_pendingFifo.getNumReady() > 0)
+    {
+        auto scope = m_pendingFifo.read(1);
+        auto& block = m_pending[static_cast<size_t>(scope.startIndex1)];
+
+        // The link is only a prediction, a torn or stale one costs some extra processing
+        if (auto* previous = getSlot(block.previousKey); previous != nullptr)
+        {
+            auto* header = reinterpret_cast<SlotHeader*>(previous);
+            if (block.previousKey != 0 && header->key == block.previousKey)
+                header->nextKey = block.key;
+        }
+
+        auto* slot = getSlot(block.key);
+        if (slot == nullptr || block.numSamples == 0)
+            continue;
+
+        // Invalidate the slot while its samples are rewritten, a rewrite of the same key keeps
+        // its link
+        auto* header   = reinterpret_cast<SlotHeader*>(slot);
+        auto  keepLink = header->key == block.key;
+        header->key    = 0;
+        std::atomic_thread_fence(std::memory_order_release);
+
+        auto*         samples     = reinterpret_cast<float*>(slot + sizeof(SlotHeader));
+        std::uint64_t sumOfChecks = 0;
+        for (int ch = 0; ch < block.numChannels; ++ch)
+        {
+            auto* source = block.samples.data() + ch * m_maxBlockSize;
+            std::memcpy(samples + ch * m_maxBlockSize, source,
+                        sizeof(float) * static_cast<size_t>(block.numSamples));
+            sumOfChecks = combine(sumOfChecks, checksum(source, block.numSamples));
+        }
+
+        header->checksum    = sumOfChecks;
+        header->numSamples  = static_cast<std::uint32_t>(block.numSamples);
+        header->numChannels = static_cast<std::uint32_t>(block.numChannels);
+        header->flags       = block.flags;
+        if (!keepLink)
+            header->nextKey = 0;
+        std::atomic_thread_fence(std::memory_order_release);
+        header->key = block.key;
+    }
+}
+
+void RenderCache::stageAhead(std::uint64_t key)
+{
+    if (m_slots.load() == nullptr)
+        return;
+
+    // Each wake-up starts from the current block, so staging stays ahead of the lookups
+    std::array<SlotHeader, maxStageAhead> chain;
+    size_t                                chainLength = 0;
+    while (chainLength < chain.size() && key != 0)
+    {
+        auto& header = chain[chainLength];
+        std::memcpy(&header, getSlot(key), sizeof(SlotHeader));
+        if (header.key != key)
+            break;
+
+        ++chainLength;
+        key = header.nextKey;
+    }
+
+    // Blocks of the chain that are staged already, unless their slot or link changed since
+    std::array<bool, stagedBlocks>  needed{};
+    std::array<bool, maxStageAhead> staged{};
+    for (size_t i = 0; i < chainLength; ++i)
+    {
+        for (size_t entry = 0; entry < m_stagedKeys.size(); ++entry)
+        {
+            if (m_stagedKeys[entry].load() != chain[i].key)
+                continue;
+
+            auto* data    = m_staged.data() + entry * getSlotSize();
+            staged[i]     = std::memcmp(data, &chain[i], sizeof(SlotHeader)) == 0;
+            needed[entry] = staged[i];
+            break;
+        }
+    }
+
+    // The others replace entries the chain does not need, there are twice as many as it is long
+    for (size_t i = 0; i < chainLength; ++i)
+    {
+        if (staged[i])
+            continue;
+
+        while (needed[static_cast<size_t>(m_nextStaged)])
+            m_nextStaged = (m_nextStaged + 1) % stagedBlocks;
+
+        const auto entry = static_cast<size_t>(m_nextStaged);
+        needed[entry]    = true;
+
+        // Invalid while it is copied, a torn copy of a slot being rewritten fails the checksum
+        m_stagedKeys[entry].store(0);
+
+        auto* data = m_staged.data() + entry * getSlotSize();
+        std::memcpy(data, getSlot(chain[i].key), getSlotSize());
+        std::memcpy(data, &chain[i], sizeof(SlotHeader));
+
+        m_stagedKeys[entry].store(chain[i].key);
+    }
+}
+
+char* RenderCache::getStaged(std::uint64_t key)
+{
+    if (m_staged.empty())
+        return nullptr;
+
+    for (size_t entry = 0; entry < m_stagedKeys.size(); ++entry)
+        if (m_stagedKeys[entry].load(std::memory_order_acquire) == key)
+            return m_staged.data() + entry * getSlotSize();
+
+    return nullptr;
+}
+
+char* RenderCache::getSlot(std::uint64_t key) const
+{
+    auto* slots = m_slots.load();
+    if (slots == nullptr || m_numSlots == 0)
+        return nullptr;
+
+    return slots + static_cast<size_t>(key % m_numSlots) * getSlotSize();
+}
+
+size_t RenderCache::getSlotSize() const
+{
+    return sizeof(SlotHeader) +
+           sizeof(float) * static_cast<size_t>(m_numChannels) * static_cast<size_t>(m_maxBlockSize);
+}
+
+std::uint64_t RenderCache::checksum(const float* samples, int numSamples)
+{
+    return hash(samples, sizeof(float) * static_cast<size_t>(numSamples), 0);
+}
+
+std::uint64_t RenderCache::hash(const void* data, size_t numBytes, std::uint64_t seed)
+{
+    auto* bytes = static_cast<const std::uint8_t*>(data);
+
+    // Two independent lanes so consecutive multiplications can overlap
+    std::uint64_t lane0 = seed ^ prime0;
+    std::uint64_t lane1 = seed + static_cast<std::uint64_t>(numBytes);
+
+    size_t i = 0;
+    for (; i + 16 <= numBytes; i += 16)
+    {
+        std::uint64_t a, b;
+        std::memcpy(&a, bytes + i, sizeof(a));
+        std::memcpy(&b, bytes + i + 8, sizeof(b));
+
+        lane0 = (lane0 ^ a) * prime0;
+        lane0 ^= lane0 >> 29;
+        lane1 = (lane1 ^ b) * prime1;
+        lane1 ^= lane1 >> 31;
+    }
+
+    for (; i < numBytes; ++i)
+        lane0 = (lane0 ^ bytes[i]) * prime0;
+
+    return combine(lane0, lane1);
+}
+
+std::uint64_t RenderCache::combine(std::uint64_t a, std::uint64_t b)
+{
+    // murmur3 finaliser over a boost-style combination
+    auto h = a ^ (b + prime0 + (a << 6) + (a >> 2));
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ull;
+    h ^= h >> 33;
+    return h;
+}
+
+} // namespace aic::dsp
@@ -0,0 +1,257 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_core/juce_core.h>
+#include <vector>
+
+namespace aic::dsp
+{
+
+/**
+ * @brief Persistent cache of enhanced blocks, keyed by the input history and the parameters.
+ *
+ * The key of a block combines a hash of the parameters with the hashes of the current and the
+ * preceding input blocks, covering enough history that the model state is determined by it.
+ * Results live in a fixed-size, memory-mapped file, each key maps to exactly one slot so the file
+ * never grows past its size cap. The file is shared by all instances with the same block size.
+ *
+ * The file is opened, written and read by a background thread. A page of the mapped file may not
+ * be resident, so the audio thread never reads it: the background thread follows the links ahead
+ * of the current block and copies the slots into staged blocks in memory, which the audio thread
+ * looks up, and it queues new results. The first block of a replayed run is a miss, the blocks
+ * after it hit once they are staged. A checksum guards against slots that are being rewritten.
+ *
+ * Each slot also links to the block that followed it when it was last played. While the linked
+ * blocks ahead of a run of hits cover less than the history, the run is about to end and the
+ * model is fed the input of every further hit, so its state is current when the first miss
+ * arrives without replaying the history at once.
+ */
+class RenderCache : private juce::Thread
+{
+  public:
+    RenderCache();
+    ~RenderCache() override;
+
+    /**
+     * @brief Allocates the history and write queue and starts the background thread.
+     *
+     * The cache file itself is only created once the cache is enabled. Not real-time safe.
+     *
+     * @param directory Directory the cache files are stored in
+     * @param numChannels Maximum number of channels
+     * @param maxBlockSize Maximum number of samples per block, larger blocks are not cached
+     * @param historySamples Number of input samples a key covers
+     */
+    void prepare(const juce::File& directory, int numChannels, int maxBlockSize,
+                 int historySamples);
+
+    /**
+     * @brief Stops the background thread and unmaps the file. Not real-time safe.
+     */
+    void release();
+
+    /**
+     * @brief Enables or disables the cache.
+     *
+     * Wakes the background thread when the cache is switched on, it sleeps while disabled.
+     */
+    void setEnabled(bool shouldBeEnabled);
+
+    bool isEnabled() const
+    {
+        return m_enabled.load();
+    }
+
+    /**
+     * @brief Forgets the input history, e.g. after the model has been reinitialized.
+     */
+    void resetHistory();
+
+    /**
+     * @brief Hashes the input block and appends it to the history.
+     *
+     * Must be called for every block before it is processed.
+     *
+     * @return The key of the block, or 0 if the block can not be cached
+     */
+    std::uint64_t beginBlock(const float* const* input, int numChannels, int numSamples,
+                             std::uint64_t parameterHash);
+
+    /**
+     * @brief Copies a cached result into the output, if the background thread staged it.
+     *
+     * @param speechDetected Set to the voice activity the model reported for the cached block
+     * @return true on a cache hit, the model does not need to run for this block
+     */
+    bool lookup(std::uint64_t key, float* const* output, int numChannels, int numSamples,
+                bool& speechDetected);
+
+    /**
+     * @brief Queues a processed block for the background thread to write into the cache file.
+     */
+    void store(std::uint64_t key, const float* const* output, int numChannels, int numSamples,
+               bool speechDetected);
+
+    /**
+     * @brief Whether the run of hits the last lookup belongs to ends within the history.
+     *
+     * Follows the links of the staged blocks ahead, a few per call. Until they are known to cover
+     * the history the run is treated as ending.
+     */
+    bool isHitRunEnding();
+
+    /**
+     * @brief Feeds the most recent input skipped by cache hits through the model.
+     *
+     * Called after a hit whose run is ending to keep the model state current, and before a miss
+     * to catch up on what was skipped. The input is passed to render in chunks of at most the
+     * maximum block size, the rendered output is discarded. Skipped input beyond maxSamples is
+     * dropped, so a miss that was not anticipated costs at most maxSamples of extra processing.
+     */
+    template <typename Render> void prime(Render&& render, int maxSamples)
+    {
+        auto available   = juce::jmin(m_skippedEnd, static_cast<juce::int64>(m_historySamples));
+        auto numSamples  = juce::jmin(m_skippedSamples, maxSamples, static_cast<int>(available));
+        m_skippedSamples = 0;
+
+        auto position = m_skippedEnd - numSamples;
+        while (numSamples > 0)
+        {
+            auto chunk = juce::jmin(numSamples, m_maxBlockSize);
+            readHistory(position, chunk);
+            render(m_scratch.getArrayOfWritePointers(), m_scratch.getNumChannels(), chunk);
+            position += chunk;
+            numSamples -= chunk;
+        }
+    }
+
+    juce::int64 getNumHits() const
+    {
+        return m_hits.load();
+    }
+
+    juce::int64 getNumMisses() const
+    {
+        return m_misses.load();
+    }
+
+    static std::uint64_t hash(const void* data, size_t numBytes, std::uint64_t seed);
+
+    static std::uint64_t combine(std::uint64_t a, std::uint64_t b);
+
+  private:
+    struct SlotHeader
+    {
+        std::uint64_t key;
+        std::uint64_t checksum;
+        std::uint32_t numSamples;
+        std::uint32_t numChannels;
+        std::uint32_t flags;
+        std::uint64_t nextKey;
+    };
+
+    struct FileHeader
+    {
+        char          magic[8];
+        std::uint32_t version;
+        std::uint32_t numChannels;
+        std::uint32_t slotFrames;
+        std::uint32_t numSlots;
+    };
+
+    // A block with no samples only links its predecessor to it
+    struct PendingBlock
+    {
+        std::uint64_t      key;
+        std::uint64_t      previousKey;
+        int                numSamples;
+        int                numChannels;
+        std::uint32_t      flags;
+        std::vector<float> samples;
+    };
+
+    struct BlockHash
+    {
+        std::uint64_t hash;
+        int           numSamples;
+    };
+
+    static constexpr size_t        fileHeaderSize = 4096;
+    static constexpr juce::int64   maxFileSize    = 256 * 1024 * 1024;
+    static constexpr int           maxBlockHashes = 256;
+    static constexpr int           pendingBlocks  = 64;
+    static constexpr int           maxLinksPerHit = 8;
+    static constexpr int           stagedBlocks   = 128;
+    static constexpr int           maxStageAhead  = stagedBlocks / 2;
+    static constexpr std::uint32_t speechFlag     = 1;
+
+    void run() override;
+
+    bool openFile();
+    void writePending();
+    void queueLink(std::uint64_t previousKey, std::uint64_t key);
+
+    /**
+     * @brief Copies the slot of the key and the ones linked after it into the staged blocks.
+     */
+    void stageAhead(std::uint64_t key);
+
+    char* getSlot(std::uint64_t key) const;
+    char* getStaged(std::uint64_t key);
+
+    size_t getSlotSize() const;
+
+    static std::uint64_t checksum(const float* samples, int numSamples);
+
+    void readHistory(juce::int64 position, int numSamples);
+
+    juce::File m_directory;
+    int        m_numChannels{0};
+    int        m_maxBlockSize{0};
+    int        m_historySamples{0};
+
+    std::unique_ptr<juce::MemoryMappedFile> m_file;
+    std::atomic<char*>                      m_slots{nullptr};
+    std::uint32_t                           m_numSlots{0};
+
+    std::atomic<bool> m_enabled{false};
+    std::atomic<bool> m_failed{false};
+
+    // Slots copied from the file by the background thread, the only ones the audio thread reads.
+    // The keys are scanned by lookups, the key of the current block is where staging starts.
+    std::vector<char>                                     m_staged;
+    std::array<std::atomic<std::uint64_t>, stagedBlocks> m_stagedKeys{};
+    int                                                   m_nextStaged{0};
+    std::atomic<std::uint64_t>                            m_stageKey{0};
+
+    // write queue, filled on the audio thread and drained by the background thread
+    juce::AbstractFifo        m_pendingFifo{pendingBlocks};
+    std::vector<PendingBlock> m_pending;
+
+    // input history, used for the keys and to prime the model after cache hits
+    std::array<BlockHash, maxBlockHashes> m_blockHashes{};
+    int                                   m_numBlockHashes{0};
+    int                                   m_newestBlockHash{0};
+    juce::AudioBuffer<float>              m_history;
+    juce::AudioBuffer<float>              m_scratch;
+    juce::int64                           m_historyEnd{0};
+    juce::int64                           m_skippedEnd{0};
+    int                                   m_skippedSamples{0};
+
+    // links between consecutive blocks, used to see the end of a run of hits coming
+    std::uint64_t m_currentKey{0};
+    std::uint64_t m_previousKey{0};
+    std::uint64_t m_predictedKey{0};
+    std::uint64_t m_lookaheadNextKey{0};
+    int           m_lookaheadSamples{0};
+
+    std::atomic<juce::int64> m_hits{0};
+    std::atomic<juce::int64> m_misses{0};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RenderCache)
+};
+
+} // namespace aic::dsp
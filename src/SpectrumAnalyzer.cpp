@@ -0,0 +1,254 @@
+#include "SpectrumAnalyzer.h"
+
+#include "AicColours.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace aic
+{
+
+SpectrumAnalyzer::SharedThread::SharedThread() : juce::TimeSliceThread("aic spectrum analyzer")
+{
+    startThread(juce::Thread::Priority::low);
+}
+
+SpectrumAnalyzer::SharedThread::~SharedThread()
+{
+    stopThread(1000);
+}
+
+SpectrumAnalyzer::Signal::Signal()
+    : fifo(8 * fftSize), queue(8 * fftSize), history(fftSize), fftData(2 * fftSize),
+      levels(numPoints, minDecibels)
+{
+}
+
+void SpectrumAnalyzer::Signal::push(const float* const* channels, int numChannels,
+                                    int numSamples) noexcept
+{
+    if (numChannels <= 0)
+        return;
+
+    // Samples that do not fit are dropped, the analysis thread is behind anyway
+    const auto scope = fifo.write(numSamples);
+    const auto gain  = 1.0f / static_cast<float>(numChannels);
+
+    auto mixDown = [&](int start, int size, int offset)
+    {
+        if (size <= 0)
+            return;
+
+        auto* dest = queue.data() + start;
+        juce::FloatVectorOperations::copyWithMultiply(dest, channels[0] + offset, gain, size);
+        for (int ch = 1; ch < numChannels; ++ch)
+            juce::FloatVectorOperations::addWithMultiply(dest, channels[ch] + offset, gain, size);
+    };
+
+    mixDown(scope.startIndex1, scope.blockSize1, 0);
+    mixDown(scope.startIndex2, scope.blockSize2, scope.blockSize1);
+}
+
+void SpectrumAnalyzer::Signal::clear()
+{
+    fifo.reset();
+    std::fill(history.begin(), history.end(), 0.0f);
+    std::fill(levels.begin(), levels.end(), minDecibels);
+    historyPosition = 0;
+}
+
+bool SpectrumAnalyzer::Signal::pull()
+{
+    const auto scope = fifo.read(fifo.getNumReady());
+
+    scope.forEach(
+        [this](int index)
+        {
+            history[static_cast<size_t>(historyPosition)] = queue[static_cast<size_t>(index)];
+            historyPosition = (historyPosition + 1) % fftSize;
+        });
+
+    return scope.blockSize1 + scope.blockSize2 > 0;
+}
+
+void SpectrumAnalyzer::Signal::analyse(juce::dsp::FFT&                      fft,
+                                       juce::dsp::WindowingFunction<float>& window,
+                                       double                               sampleRate)
+{
+    // Oldest sample first
+    for (int i = 0; i < fftSize; ++i)
+        fftData[static_cast<size_t>(i)] =
+            history[static_cast<size_t>((historyPosition + i) % fftSize)];
+
+    window.multiplyWithWindowingTable(fftData.data(), static_cast<size_t>(fftSize));
+    fft.performFrequencyOnlyForwardTransform(fftData.data(), true);
+
+    // The window is normalised to unit gain, a full scale sine shows at 0 dB
+    const auto scale   = 2.0f / static_cast<float>(fftSize);
+    const auto nyquist = sampleRate / 2.0;
+
+    for (int point = 0; point < numPoints; ++point)
+    {
+        // Logarithmic frequency axis, interpolated between the neighbouring bins
+        auto frequency = minFrequency * std::pow(nyquist / minFrequency,
+                                                 static_cast<double>(point) / (numPoints - 1));
+        auto bin       = static_cast<float>(frequency / sampleRate * fftSize);
+        auto index     = juce::jlimit(0, fftSize / 2 - 1, static_cast<int>(bin));
+        auto fraction  = juce::jlimit(0.0f, 1.0f, bin - static_cast<float>(index));
+        auto magnitude = fftData[static_cast<size_t>(index)] * (1.0f - fraction) +
+                         fftData[static_cast<size_t>(index + 1)] * fraction;
+
+        auto  decibels = juce::Decibels::gainToDecibels(magnitude * scale, minDecibels);
+        auto& level    = levels[static_cast<size_t>(point)];
+
+        // Rises immediately, falls smoothly
+        level = decibels > level ? decibels : level + releasePerFrame * (decibels - level);
+    }
+}
+
+SpectrumAnalyzer::SpectrumAnalyzer()
+{
+    m_thread->addTimeSliceClient(this);
+}
+
+SpectrumAnalyzer::~SpectrumAnalyzer()
+{
+    // Waits until the thread is not using this client
+    m_thread->removeTimeSliceClient(this);
+}
+
+void SpectrumAnalyzer::prepare(double sampleRate)
+{
+    const juce::ScopedLock lock(m_analysisLock);
+    m_sampleRate = sampleRate;
+    m_input.clear();
+    m_output.clear();
+}
+
+void SpectrumAnalyzer::setActive(bool active)
+{
+    m_active.store(active);
+
+    if (active)
+        m_thread->moveToFrontOfQueue(this);
+}
+
+void SpectrumAnalyzer::pushInput(const float* const* channels, int numChannels,
+                                 int numSamples) noexcept
+{
+    if (m_active.load(std::memory_order_relaxed))
+        m_input.push(channels, numChannels, numSamples);
+}
+
+void SpectrumAnalyzer::pushOutput(const float* const* channels, int numChannels,
+                                  int numSamples) noexcept
+{
+    if (m_active.load(std::memory_order_relaxed))
+        m_output.push(channels, numChannels, numSamples);
+}
+
+void SpectrumAnalyzer::setImageSize(int width, int height)
+{
+    m_imageWidth.store(width);
+    m_imageHeight.store(height);
+}
+
+void SpectrumAnalyzer::drawImage(juce::Graphics& g, juce::Rectangle<float> area)
+{
+    const juce::SpinLock::ScopedLockType lock(m_imageLock);
+
+    if (m_image.isValid())
+        g.drawImage(m_image, area);
+}
+
+int SpectrumAnalyzer::useTimeSlice()
+{
+    // Polls rarely while no editor is open
+    if (!m_active.load())
+        return 200;
+
+    const juce::ScopedLock lock(m_analysisLock);
+
+    auto inputChanged  = m_input.pull();
+    auto outputChanged = m_output.pull();
+    if (!inputChanged && !outputChanged)
+        return frameIntervalMs;
+
+    m_input.analyse(m_fft, m_window, m_sampleRate);
+    m_output.analyse(m_fft, m_window, m_sampleRate);
+    renderImage();
+
+    return frameIntervalMs;
+}
+
+void SpectrumAnalyzer::renderImage()
+{
+    const auto width  = m_imageWidth.load();
+    const auto height = m_imageHeight.load();
+    if (width <= 0 || height <= 0)
+        return;
+
+    if (m_renderImage.getWidth() != width || m_renderImage.getHeight() != height)
+        m_renderImage =
+            juce::Image(juce::Image::ARGB, width, height, true, juce::SoftwareImageType());
+    else
+        m_renderImage.clear(m_renderImage.getBounds());
+
+    const auto w       = static_cast<float>(width);
+    const auto h       = static_cast<float>(height);
+    const auto nyquist = m_sampleRate / 2.0;
+
+    auto toX = [&](double frequency)
+    {
+        return static_cast<float>(std::log(frequency / minFrequency) /
+                                  std::log(nyquist / minFrequency)) *
+               w;
+    };
+
+    auto toPath = [&](const Signal& signal, juce::Path& path, bool closed)
+    {
+        path.clear();
+        for (int point = 0; point < numPoints; ++point)
+        {
+            auto x = w * static_cast<float>(point) / (numPoints - 1);
+            auto y = juce::jmap(signal.levels[static_cast<size_t>(point)], minDecibels, 0.0f, h,
+                                0.0f);
+
+            if (point == 0)
+                path.startNewSubPath(x, closed ? h : y);
+
+            path.lineTo(x, y);
+        }
+
+        if (closed)
+        {
+            path.lineTo(w, h);
+            path.closeSubPath();
+        }
+    };
+
+    juce::Graphics g(m_renderImage);
+
+    // Decades
+    g.setColour(aic::ui::BLACK_15);
+    for (double frequency : {100.0, 1000.0, 10000.0})
+        if (frequency < nyquist)
+            g.fillRect(toX(frequency), 0.0f, 1.0f, h);
+
+    toPath(m_input, m_inputPath, true);
+    g.setColour(aic::ui::BLACK_20);
+    g.fillPath(m_inputPath);
+
+    toPath(m_output, m_outputPath, false);
+    g.setColour(aic::ui::BLUE_50);
+    g.strokePath(m_outputPath, juce::PathStrokeType(juce::jmax(1.0f, h / 100.0f)));
+
+    {
+        const juce::SpinLock::ScopedLockType imageLock(m_imageLock);
+        std::swap(m_renderImage, m_image);
+    }
+
+    m_newImage.store(true);
+}
+
+} // namespace aic
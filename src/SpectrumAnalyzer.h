@@ -0,0 +1,139 @@
+#pragma once
+
+#include <atomic>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
+#include <juce_graphics/juce_graphics.h>
+#include <vector>
+
+namespace aic
+{
+
+/**
+ * @brief Spectrum of the input and the enhanced output, rendered into an image for the editor.
+ *
+ * The audio thread only mixes each signal down into a lock-free FIFO, and only while an editor
+ * shows the spectrum. The FFT, the smoothing and the drawing run on a low priority thread shared
+ * by all plugin instances in the process, so many open instances do not multiply the threads. The
+ * editor draws the most recent image.
+ */
+class SpectrumAnalyzer : private juce::TimeSliceClient
+{
+  public:
+    SpectrumAnalyzer();
+    ~SpectrumAnalyzer() override;
+
+    /**
+     * @brief Sets the sample rate and clears the history. Not real-time safe.
+     */
+    void prepare(double sampleRate);
+
+    /**
+     * @brief Starts or stops the analysis, called by the editor when it opens and closes.
+     */
+    void setActive(bool active);
+
+    /**
+     * @brief Queues a block of the input. Real-time safe, does nothing while inactive.
+     */
+    void pushInput(const float* const* channels, int numChannels, int numSamples) noexcept;
+
+    /**
+     * @brief Queues a block of the output. Real-time safe, does nothing while inactive.
+     */
+    void pushOutput(const float* const* channels, int numChannels, int numSamples) noexcept;
+
+    /**
+     * @brief Sets the size of the rendered image in physical pixels.
+     */
+    void setImageSize(int width, int height);
+
+    /**
+     * @brief Checks whether an image was rendered since the last call.
+     */
+    bool hasNewImage()
+    {
+        return m_newImage.exchange(false);
+    }
+
+    /**
+     * @brief Draws the most recently rendered image into the area. Called by the editor.
+     */
+    void drawImage(juce::Graphics& g, juce::Rectangle<float> area);
+
+  private:
+    static constexpr int    fftOrder        = 11;
+    static constexpr int    fftSize         = 1 << fftOrder;
+    static constexpr int    numPoints       = 256;
+    static constexpr int    frameIntervalMs = 33;
+    static constexpr float  minDecibels     = -90.0f;
+    static constexpr float  releasePerFrame = 0.2f;
+    static constexpr double minFrequency    = 20.0;
+
+    /**
+     * @brief FIFO, history and smoothed spectrum of one signal.
+     */
+    struct Signal
+    {
+        Signal();
+
+        void push(const float* const* channels, int numChannels, int numSamples) noexcept;
+        void clear();
+
+        /**
+         * @brief Moves the queued samples into the history.
+         *
+         * @return false if there were none
+         */
+        bool pull();
+
+        void analyse(juce::dsp::FFT& fft, juce::dsp::WindowingFunction<float>& window,
+                     double sampleRate);
+
+        juce::AbstractFifo fifo;
+        std::vector<float> queue;
+        std::vector<float> history;
+        int                historyPosition{0};
+        std::vector<float> fftData;
+        std::vector<float> levels;
+    };
+
+    int useTimeSlice() override;
+
+    void renderImage();
+
+    // One thread for all instances, created with the first one
+    struct SharedThread : public juce::TimeSliceThread
+    {
+        SharedThread();
+        ~SharedThread() override;
+    };
+
+    juce::SharedResourcePointer<SharedThread> m_thread;
+
+    std::atomic<bool> m_active{false};
+
+    // Held by the analysis thread while it works and by prepare()
+    juce::CriticalSection               m_analysisLock;
+    double                              m_sampleRate{48000.0};
+    juce::dsp::FFT                      m_fft{fftOrder};
+    juce::dsp::WindowingFunction<float> m_window{static_cast<size_t>(fftSize),
+                                                 juce::dsp::WindowingFunction<float>::hann};
+    Signal                              m_input;
+    Signal                              m_output;
+    juce::Image                         m_renderImage;
+    juce::Path                          m_inputPath;
+    juce::Path                          m_outputPath;
+
+    std::atomic<int> m_imageWidth{0};
+    std::atomic<int> m_imageHeight{0};
+
+    // The published image, swapped with the render image
+    juce::SpinLock    m_imageLock;
+    juce::Image       m_image;
+    std::atomic<bool> m_newImage{false};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectrumAnalyzer)
+};
+
+} // namespace aic
@@ -0,0 +1,55 @@
+#include "StageChain.h"
+
+namespace aic::dsp
+{
+
+void StageChain::add(Position position, Stage& stage)
+{
+    getStages(position).push_back(&stage);
+}
+
+void StageChain::prepare(double sampleRate, int numChannels)
+{
+    for (auto* stage : m_preModel)
+        stage->prepare(sampleRate, numChannels);
+
+    for (auto* stage : m_postModel)
+        stage->prepare(sampleRate, numChannels);
+}
+
+void StageChain::reset()
+{
+    for (auto* stage : m_preModel)
+        stage->reset();
+
+    for (auto* stage : m_postModel)
+        stage->reset();
+}
+
+void StageChain::process(Position position, float* const* channels, int numChannels,
+                         int numSamples) noexcept
+{
+    if (numChannels <= 0 || numSamples <= 0)
+        return;
+
+    for (auto* stage : getStages(position))
+    {
+        if (stage->isEnabled())
+            stage->process(channels, numChannels, numSamples);
+    }
+}
+
+int StageChain::getLatencySamples() const noexcept
+{
+    int latency = 0;
+
+    for (auto* stage : m_preModel)
+        latency += stage->isEnabled() ? stage->getLatencySamples() : 0;
+
+    for (auto* stage : m_postModel)
+        latency += stage->isEnabled() ? stage->getLatencySamples() : 0;
+
+    return latency;
+}
+
+} // namespace aic::dsp
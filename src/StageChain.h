@@ -0,0 +1,137 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <vector>
+
+namespace aic::dsp
+{
+
+/**
+ * @brief A processing step that runs in place on the planar buffer of the host.
+ *
+ * Stages are owned elsewhere and added to a StageChain, which skips them while disabled.
+ */
+class Stage
+{
+  public:
+    virtual ~Stage() = default;
+
+    /**
+     * @brief Allocates the state for at most two channels. Not real-time safe.
+     */
+    virtual void prepare(double sampleRate, int numChannels) = 0;
+
+    /**
+     * @brief Clears the state, also called when the stage is enabled again.
+     */
+    virtual void reset() = 0;
+
+    /**
+     * @brief Processes the channels in place. Real-time safe.
+     */
+    virtual void process(float* const* channels, int numChannels, int numSamples) noexcept = 0;
+
+    /**
+     * @brief The delay the stage adds while it is enabled.
+     */
+    virtual int getLatencySamples() const noexcept
+    {
+        return 0;
+    }
+
+    bool isEnabled() const noexcept
+    {
+        return m_enabled;
+    }
+
+    /**
+     * @brief Enables or disables the stage, called on the audio thread.
+     *
+     * A stage that is enabled again starts from a cleared state instead of the one it was left in.
+     */
+    void setEnabled(bool enabled) noexcept
+    {
+        if (enabled && !m_enabled)
+            reset();
+
+        m_enabled = enabled;
+    }
+
+  private:
+    bool m_enabled{false};
+};
+
+/**
+ * @brief A stage whose inner loops are compiled separately for mono and stereo.
+ *
+ * The derived class implements `template <int NumChannels> void processChannels(float* const*
+ * channels, int numSamples) noexcept`, the channel count is then a constant the compiler unrolls
+ * and vectorises the loops over. The virtual call and the dispatch happen once per block.
+ */
+template <typename Derived>
+class ChannelSpecialisedStage : public Stage
+{
+  public:
+    void process(float* const* channels, int numChannels, int numSamples) noexcept final
+    {
+        jassert(numChannels == 1 || numChannels == 2);
+
+        auto& stage = static_cast<Derived&>(*this);
+        if (numChannels == 1)
+            stage.template processChannels<1>(channels, numSamples);
+        else
+            stage.template processChannels<2>(channels, numSamples);
+    }
+};
+
+/**
+ * @brief Runs optional stages before and after the model on the buffer of the host.
+ *
+ * All stages process the host buffer in place, nothing is copied between them. A disabled stage
+ * costs a flag check per block.
+ */
+class StageChain
+{
+  public:
+    enum class Position
+    {
+        PreModel,
+        PostModel
+    };
+
+    StageChain() = default;
+
+    /**
+     * @brief Appends the stage to the stages at the position. Not real-time safe.
+     *
+     * The stage must outlive the chain.
+     */
+    void add(Position position, Stage& stage);
+
+    void prepare(double sampleRate, int numChannels);
+    void reset();
+
+    /**
+     * @brief Runs the enabled stages at the position in order. Real-time safe.
+     */
+    void process(Position position, float* const* channels, int numChannels,
+                 int numSamples) noexcept;
+
+    /**
+     * @brief The sum of the delays of the enabled stages.
+     */
+    int getLatencySamples() const noexcept;
+
+  private:
+    std::vector<Stage*>& getStages(Position position)
+    {
+        return position == Position::PreModel ? m_preModel : m_postModel;
+    }
+
+    std::vector<Stage*> m_preModel;
+    std::vector<Stage*> m_postModel;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StageChain)
+};
+
+} // namespace aic::dsp
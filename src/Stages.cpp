@@ -0,0 +1,327 @@
+#include "Stages.h"
+
+#include <cmath>
+
+namespace aic::dsp
+{
+
+//==============================================================================
+void HighPassStage::prepare(double sampleRate, int numChannels)
+{
+    juce::ignoreUnused(numChannels);
+
+    m_sampleRate = sampleRate;
+    updateCoefficients();
+    reset();
+}
+
+void HighPassStage::reset()
+{
+    m_state = {};
+}
+
+void HighPassStage::setCutoffFrequency(float frequency) noexcept
+{
+    if (frequency == m_cutoffFrequency)
+        return;
+
+    m_cutoffFrequency = frequency;
+    updateCoefficients();
+}
+
+void HighPassStage::updateCoefficients() noexcept
+{
+    // Bilinear transform of the analog prototype with Q = 1/sqrt(2)
+    auto frequency = juce::jlimit(1.0, m_sampleRate * 0.45, static_cast<double>(m_cutoffFrequency));
+    auto omega     = juce::MathConstants<double>::twoPi * frequency / m_sampleRate;
+    auto cosOmega  = std::cos(omega);
+    auto alpha     = std::sin(omega) / juce::MathConstants<double>::sqrt2;
+    auto a0        = 1.0 + alpha;
+
+    m_b0 = (1.0 + cosOmega) * 0.5 / a0;
+    m_b1 = -(1.0 + cosOmega) / a0;
+    m_b2 = m_b0;
+    m_a1 = -2.0 * cosOmega / a0;
+    m_a2 = (1.0 - alpha) / a0;
+}
+
+template <int NumChannels>
+void HighPassStage::processChannels(float* const* channels, int numSamples) noexcept
+{
+    for (int i = 0; i < numSamples; ++i)
+    {
+        for (int ch = 0; ch < NumChannels; ++ch)
+        {
+            auto& state = m_state[static_cast<size_t>(ch)];
+            auto  x     = static_cast<double>(channels[ch][i]);
+            auto  y     = m_b0 * x + state[0];
+
+            state[0]        = m_b1 * x - m_a1 * y + state[1];
+            state[1]        = m_b2 * x - m_a2 * y;
+            channels[ch][i] = static_cast<float>(y);
+        }
+    }
+}
+
+template void HighPassStage::processChannels<1>(float* const*, int) noexcept;
+template void HighPassStage::processChannels<2>(float* const*, int) noexcept;
+
+//==============================================================================
+void TrimStage::prepare(double sampleRate, int numChannels)
+{
+    juce::ignoreUnused(numChannels);
+
+    m_gain.reset(sampleRate, rampSeconds);
+    reset();
+}
+
+void TrimStage::reset()
+{
+    m_gain.setCurrentAndTargetValue(m_gain.getTargetValue());
+}
+
+void TrimStage::setGainDecibels(float gainDecibels) noexcept
+{
+    auto gain = juce::Decibels::decibelsToGain(gainDecibels);
+
+    // Enabled before the target changes, the reset on enabling keeps the smoother at unity where
+    // it was left, so the ramp starts from there
+    if (gain != 1.0f)
+        setEnabled(true);
+
+    m_gain.setTargetValue(gain);
+
+    // Disabled only once the ramp back has reached unity
+    if (gain == 1.0f && !m_gain.isSmoothing())
+        setEnabled(false);
+}
+
+template <int NumChannels>
+void TrimStage::processChannels(float* const* channels, int numSamples) noexcept
+{
+    if (!m_gain.isSmoothing())
+    {
+        for (int ch = 0; ch < NumChannels; ++ch)
+            juce::FloatVectorOperations::multiply(channels[ch], m_gain.getTargetValue(),
+                                                  numSamples);
+        return;
+    }
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        auto gain = m_gain.getNextValue();
+        for (int ch = 0; ch < NumChannels; ++ch)
+            channels[ch][i] *= gain;
+    }
+}
+
+template void TrimStage::processChannels<1>(float* const*, int) noexcept;
+template void TrimStage::processChannels<2>(float* const*, int) noexcept;
+
+//==============================================================================
+void NoiseGateStage::prepare(double sampleRate, int numChannels)
+{
+    juce::ignoreUnused(numChannels);
+
+    m_attackCoeff  = static_cast<float>(1.0 - std::exp(-1.0 / (attackSeconds * sampleRate)));
+    m_releaseCoeff = static_cast<float>(1.0 - std::exp(-1.0 / (releaseSeconds * sampleRate)));
+    m_holdSamples  = juce::roundToInt(holdSeconds * sampleRate);
+    reset();
+}
+
+void NoiseGateStage::reset()
+{
+    // Starts open, so the first word is not cut
+    m_holdRemaining = m_holdSamples;
+    m_gain          = 1.0f;
+}
+
+void NoiseGateStage::setThresholdDecibels(float thresholdDecibels) noexcept
+{
+    m_openThreshold  = juce::Decibels::decibelsToGain(thresholdDecibels);
+    m_closeThreshold = juce::Decibels::decibelsToGain(thresholdDecibels - hysteresisDecibels);
+}
+
+template <int NumChannels>
+void NoiseGateStage::processChannels(float* const* channels, int numSamples) noexcept
+{
+    for (int i = 0; i < numSamples; ++i)
+    {
+        float level = 0.0f;
+        for (int ch = 0; ch < NumChannels; ++ch)
+            level = juce::jmax(level, std::abs(channels[ch][i]));
+
+        // While open, the hold restarts at the lower close threshold
+        auto threshold = m_holdRemaining > 0 ? m_closeThreshold : m_openThreshold;
+        if (level > threshold)
+            m_holdRemaining = m_holdSamples;
+        else if (m_holdRemaining > 0)
+            --m_holdRemaining;
+
+        auto target = m_holdRemaining > 0 ? 1.0f : 0.0f;
+        m_gain += (target > m_gain ? m_attackCoeff : m_releaseCoeff) * (target - m_gain);
+
+        for (int ch = 0; ch < NumChannels; ++ch)
+            channels[ch][i] *= m_gain;
+    }
+}
+
+template void NoiseGateStage::processChannels<1>(float* const*, int) noexcept;
+template void NoiseGateStage::processChannels<2>(float* const*, int) noexcept;
+
+//==============================================================================
+void TruePeakLimiterStage::prepare(double sampleRate, int numChannels)
+{
+    juce::ignoreUnused(numChannels);
+
+    m_releaseCoeff = static_cast<float>(1.0 - std::exp(-1.0 / (releaseSeconds * sampleRate)));
+    m_lookahead    = juce::jmax(1, juce::roundToInt(lookaheadSeconds * sampleRate));
+
+    // A gain is held for one sample longer than it is averaged, so it covers the samples on both
+    // sides of an inter-sample peak
+    m_delaySamples = m_lookahead - 1 + interpolatorDelay;
+
+    // Hann windowed sinc with its zeros on the input samples, the phase with the centre tap is
+    // the input itself and left out
+    constexpr int centre     = interpolatorDelay * oversampling;
+    constexpr int filterSize = 2 * centre + 1;
+
+    for (int phase = 1; phase < oversampling; ++phase)
+    {
+        for (int tap = 0; tap < tapsPerPhase; ++tap)
+        {
+            auto index  = tap * oversampling + phase;
+            auto x      = juce::MathConstants<double>::pi * (index - centre) / oversampling;
+            auto sinc   = std::sin(x) / x;
+            auto phi    = juce::MathConstants<double>::twoPi * index / (filterSize - 1);
+            auto window = index < filterSize ? 0.5 - 0.5 * std::cos(phi) : 0.0;
+
+            m_phases[static_cast<size_t>(phase - 1)][static_cast<size_t>(tap)] =
+                static_cast<float>(sinc * window);
+        }
+    }
+
+    for (auto& delay : m_delay)
+        delay.assign(static_cast<size_t>(m_delaySamples), 0.0f);
+
+    m_holdGains.assign(static_cast<size_t>(m_lookahead + 1), 1.0f);
+    m_holdIndices.assign(static_cast<size_t>(m_lookahead + 1), 0);
+    m_average.assign(static_cast<size_t>(m_lookahead), 1.0f);
+
+    reset();
+}
+
+void TruePeakLimiterStage::reset()
+{
+    m_history         = {};
+    m_historyPosition = 0;
+
+    for (auto& delay : m_delay)
+        std::fill(delay.begin(), delay.end(), 0.0f);
+    m_delayPosition = 0;
+
+    m_holdFront   = 0;
+    m_holdSize    = 0;
+    m_sampleIndex = 0;
+    m_releaseGain = 1.0f;
+
+    std::fill(m_average.begin(), m_average.end(), 1.0f);
+    m_averageSum      = static_cast<double>(m_average.size());
+    m_averagePosition = 0;
+}
+
+void TruePeakLimiterStage::setCeilingDecibels(float ceilingDecibels) noexcept
+{
+    m_ceiling = juce::Decibels::decibelsToGain(ceilingDecibels);
+}
+
+float TruePeakLimiterStage::holdMinimum(float gain) noexcept
+{
+    const auto capacity = static_cast<int>(m_holdGains.size());
+
+    // Larger gains before the new one can never be the minimum again
+    while (m_holdSize > 0)
+    {
+        auto back = (m_holdFront + m_holdSize - 1) % capacity;
+        if (m_holdGains[static_cast<size_t>(back)] < gain)
+            break;
+        --m_holdSize;
+    }
+
+    auto back                                = (m_holdFront + m_holdSize) % capacity;
+    m_holdGains[static_cast<size_t>(back)]   = gain;
+    m_holdIndices[static_cast<size_t>(back)] = m_sampleIndex;
+    ++m_holdSize;
+
+    // Drops the gain that left the hold length
+    if (m_holdIndices[static_cast<size_t>(m_holdFront)] <= m_sampleIndex - capacity)
+    {
+        m_holdFront = (m_holdFront + 1) % capacity;
+        --m_holdSize;
+    }
+
+    ++m_sampleIndex;
+    return m_holdGains[static_cast<size_t>(m_holdFront)];
+}
+
+template <int NumChannels>
+void TruePeakLimiterStage::processChannels(float* const* channels, int numSamples) noexcept
+{
+    const auto averageLength = static_cast<int>(m_average.size());
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        m_historyPosition = m_historyPosition == 0 ? tapsPerPhase - 1 : m_historyPosition - 1;
+
+        // The highest of the centre sample and the interpolated samples after it
+        float peak = 0.0f;
+        for (int ch = 0; ch < NumChannels; ++ch)
+        {
+            auto& history = m_history[static_cast<size_t>(ch)];
+
+            history[static_cast<size_t>(m_historyPosition)]                = channels[ch][i];
+            history[static_cast<size_t>(m_historyPosition + tapsPerPhase)] = channels[ch][i];
+
+            const auto* window = history.data() + m_historyPosition;
+            peak               = juce::jmax(peak, std::abs(window[interpolatorDelay]));
+
+            for (const auto& coefficients : m_phases)
+            {
+                float sum = 0.0f;
+                for (int tap = 0; tap < tapsPerPhase; ++tap)
+                    sum += coefficients[static_cast<size_t>(tap)] * window[tap];
+                peak = juce::jmax(peak, std::abs(sum));
+            }
+        }
+
+        auto required = peak > m_ceiling ? m_ceiling / peak : 1.0f;
+        auto held     = holdMinimum(required);
+
+        // Gain reduction is taken at once, the moving average turns it into a smooth attack
+        m_releaseGain =
+            held < m_releaseGain ? held : m_releaseGain + m_releaseCoeff * (held - m_releaseGain);
+
+        auto& oldest = m_average[static_cast<size_t>(m_averagePosition)];
+        m_averageSum += static_cast<double>(m_releaseGain) - static_cast<double>(oldest);
+        oldest            = m_releaseGain;
+        m_averagePosition = m_averagePosition + 1 == averageLength ? 0 : m_averagePosition + 1;
+
+        auto gain = static_cast<float>(m_averageSum / averageLength);
+
+        for (int ch = 0; ch < NumChannels; ++ch)
+        {
+            auto& delay = m_delay[static_cast<size_t>(ch)];
+            auto  input = channels[ch][i];
+
+            channels[ch][i] = delay[static_cast<size_t>(m_delayPosition)] * gain;
+            delay[static_cast<size_t>(m_delayPosition)] = input;
+        }
+
+        m_delayPosition = m_delayPosition + 1 == m_delaySamples ? 0 : m_delayPosition + 1;
+    }
+}
+
+template void TruePeakLimiterStage::processChannels<1>(float* const*, int) noexcept;
+template void TruePeakLimiterStage::processChannels<2>(float* const*, int) noexcept;
+
+} // namespace aic::dsp
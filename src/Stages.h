@@ -0,0 +1,170 @@
+#pragma once
+
+#include "StageChain.h"
+
+#include <array>
+#include <cstdint>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <vector>
+
+namespace aic::dsp
+{
+
+/**
+ * @brief Removes DC and rumble with a second order Butterworth high-pass.
+ */
+class HighPassStage : public ChannelSpecialisedStage<HighPassStage>
+{
+  public:
+    void prepare(double sampleRate, int numChannels) override;
+    void reset() override;
+
+    /**
+     * @brief Sets the -3 dB frequency, the filter is only redesigned when it changes.
+     */
+    void setCutoffFrequency(float frequency) noexcept;
+
+    template <int NumChannels>
+    void processChannels(float* const* channels, int numSamples) noexcept;
+
+  private:
+    void updateCoefficients() noexcept;
+
+    double m_sampleRate{48000.0};
+    float  m_cutoffFrequency{80.0f};
+
+    // Normalised by a0, in double so low cutoffs stay stable
+    double m_b0{1.0};
+    double m_b1{0.0};
+    double m_b2{0.0};
+    double m_a1{0.0};
+    double m_a2{0.0};
+
+    // Transposed direct form II state of each channel
+    std::array<std::array<double, 2>, 2> m_state{};
+};
+
+/**
+ * @brief Scales the input by a gain in dB, ramped to avoid zipper noise.
+ *
+ * Enables itself while the gain is not unity or still ramps back to it, so an untouched trim
+ * costs nothing.
+ */
+class TrimStage : public ChannelSpecialisedStage<TrimStage>
+{
+  public:
+    void prepare(double sampleRate, int numChannels) override;
+    void reset() override;
+
+    void setGainDecibels(float gainDecibels) noexcept;
+
+    template <int NumChannels>
+    void processChannels(float* const* channels, int numSamples) noexcept;
+
+  private:
+    static constexpr double rampSeconds = 0.05;
+
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> m_gain{1.0f};
+};
+
+/**
+ * @brief Mutes the noise floor left between phrases.
+ *
+ * The gate opens as soon as a sample of any channel exceeds the threshold and closes after
+ * everything stayed 6 dB below it for the hold time. The channels are gated together.
+ */
+class NoiseGateStage : public ChannelSpecialisedStage<NoiseGateStage>
+{
+  public:
+    void prepare(double sampleRate, int numChannels) override;
+    void reset() override;
+
+    void setThresholdDecibels(float thresholdDecibels) noexcept;
+
+    template <int NumChannels>
+    void processChannels(float* const* channels, int numSamples) noexcept;
+
+  private:
+    static constexpr double attackSeconds      = 0.001;
+    static constexpr double holdSeconds        = 0.05;
+    static constexpr double releaseSeconds     = 0.1;
+    static constexpr float  hysteresisDecibels = 6.0f;
+
+    float m_openThreshold{0.001f};
+    float m_closeThreshold{0.0005f};
+    float m_attackCoeff{1.0f};
+    float m_releaseCoeff{1.0f};
+    int   m_holdSamples{0};
+
+    int   m_holdRemaining{0};
+    float m_gain{0.0f};
+};
+
+/**
+ * @brief Keeps the true peak of the output below a ceiling.
+ *
+ * The peaks between the samples are estimated by 4x oversampling with a windowed-sinc
+ * interpolator. The gain needed for each sample is held over the lookahead and smoothed with a
+ * moving average of the same length, so it is reached when the peak leaves the delay line, and
+ * released exponentially afterwards. The channels share the gain.
+ */
+class TruePeakLimiterStage : public ChannelSpecialisedStage<TruePeakLimiterStage>
+{
+  public:
+    void prepare(double sampleRate, int numChannels) override;
+    void reset() override;
+
+    int getLatencySamples() const noexcept override
+    {
+        return m_delaySamples;
+    }
+
+    void setCeilingDecibels(float ceilingDecibels) noexcept;
+
+    template <int NumChannels>
+    void processChannels(float* const* channels, int numSamples) noexcept;
+
+  private:
+    static constexpr double lookaheadSeconds = 0.0015;
+    static constexpr double releaseSeconds   = 0.1;
+    static constexpr int    oversampling     = 4;
+    static constexpr int    tapsPerPhase     = 13;
+
+    // The interpolated samples lie after the centre sample of the history
+    static constexpr int interpolatorDelay = tapsPerPhase / 2;
+
+    /**
+     * @brief Adds the gain of the newest sample and gets the minimum over the hold length.
+     */
+    float holdMinimum(float gain) noexcept;
+
+    float m_ceiling{1.0f};
+    float m_releaseCoeff{1.0f};
+    int   m_lookahead{1};
+    int   m_delaySamples{0};
+
+    // Coefficients of the phases between the samples, phase 0 is the centre sample itself
+    std::array<std::array<float, tapsPerPhase>, oversampling - 1> m_phases{};
+
+    // The last input samples of each channel, written twice so every window is contiguous
+    std::array<std::array<float, 2 * tapsPerPhase>, 2> m_history{};
+    int                                                m_historyPosition{0};
+
+    std::array<std::vector<float>, 2> m_delay;
+    int                               m_delayPosition{0};
+
+    // Monotonic queue of the gains, its front is the minimum over the hold length
+    std::vector<float>        m_holdGains;
+    std::vector<std::int64_t> m_holdIndices;
+    int                       m_holdFront{0};
+    int                       m_holdSize{0};
+    std::int64_t              m_sampleIndex{0};
+
+    float m_releaseGain{1.0f};
+
+    std::vector<float> m_average;
+    double             m_averageSum{0.0};
+    int                m_averagePosition{0};
+};
+
+} // namespace aic::dsp
@@ -0,0 +1,245 @@
+#include "StubBackend.h"
+
+#include <algorithm>
+#include <cmath>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <vector>
+
+namespace aic
+{
+
+namespace
+{
+
+/**
+ * @brief Sample rate in the name of the model type, 48 kHz for the full band models.
+ */
+uint32_t getModelSampleRate(aic::ModelType modelType)
+{
+    switch (modelType)
+    {
+    case aic::ModelType::Quail_L16:
+    case aic::ModelType::Quail_S16:
+        return 16000;
+    case aic::ModelType::Quail_L8:
+    case aic::ModelType::Quail_S8:
+        return 8000;
+    default:
+        return 48000;
+    }
+}
+
+/**
+ * @brief Output delay of the model type, the small models have the shortest lookahead.
+ */
+double getModelLatencyMs(aic::ModelType modelType)
+{
+    switch (modelType)
+    {
+    case aic::ModelType::Quail_XS:
+    case aic::ModelType::Quail_XXS:
+        return 10.0;
+    default:
+        return 30.0;
+    }
+}
+
+class StubEngine : public EnhancementEngine
+{
+  public:
+    StubEngine(const StubBackend::Settings& settings, aic::ModelType modelType)
+        : m_settings(settings),
+          m_optimalSampleRate(getModelSampleRate(modelType)),
+          m_latencyMs(settings.latencyMs.value_or(getModelLatencyMs(modelType)))
+    {
+    }
+
+    aic::ErrorCode initialize(uint32_t sampleRate, uint16_t numChannels, size_t numFrames,
+                              bool allowVariableFrames) override
+    {
+        juce::ignoreUnused(numFrames, allowVariableFrames);
+
+        const auto samplesPerMs = 0.001 * static_cast<double>(sampleRate);
+
+        m_sampleRate   = sampleRate;
+        m_delay        = static_cast<size_t>(juce::roundToInt(m_latencyMs * samplesPerMs));
+        m_periodFrames = juce::jmax(
+            static_cast<std::int64_t>(1),
+            static_cast<std::int64_t>(m_settings.vadPeriodMs * samplesPerMs));
+
+        m_delayLines.assign(numChannels, std::vector<float>(m_delay));
+        reset();
+
+        return aic::ErrorCode::Success;
+    }
+
+    aic::ErrorCode processPlanar(float* const* audio, uint16_t numChannels,
+                                 size_t numFrames) override
+    {
+        const auto startTicks = juce::Time::getHighResolutionTicks();
+        const auto frames     = static_cast<int>(numFrames);
+        numChannels = static_cast<uint16_t>(juce::jmin<size_t>(numChannels, m_delayLines.size()));
+
+        updateVad(audio, numChannels, frames);
+
+        // Attenuated by the enhancement level while there is no speech, like noise between words
+        auto gain = 1.0f;
+        if (!m_bypass)
+            gain = m_speech ? m_voiceGain : m_voiceGain * (1.0f - m_enhancementLevel);
+
+        for (uint16_t ch = 0; ch < numChannels; ++ch)
+        {
+            auto* samples = audio[ch];
+            auto& line    = m_delayLines[ch];
+            auto  index   = m_delayIndex;
+
+            for (int i = 0; i < frames; ++i)
+            {
+                auto input = samples[i];
+
+                if (m_delay > 0)
+                {
+                    samples[i]  = line[index] * gain;
+                    line[index] = input;
+                    index       = (index + 1) % m_delay;
+                }
+                else
+                {
+                    samples[i] = input * gain;
+                }
+            }
+        }
+
+        if (m_delay > 0)
+            m_delayIndex = (m_delayIndex + numFrames) % m_delay;
+
+        m_position += frames;
+
+        spend(startTicks, frames);
+        return aic::ErrorCode::Success;
+    }
+
+    void reset() override
+    {
+        for (auto& line : m_delayLines)
+            std::fill(line.begin(), line.end(), 0.0f);
+
+        m_delayIndex = 0;
+        m_position   = 0;
+        m_speech     = false;
+    }
+
+    void setParameter(aic::EnhancementParameter parameter, float value) override
+    {
+        if (parameter == aic::EnhancementParameter::Bypass)
+            m_bypass = value > 0.5f;
+        else if (parameter == aic::EnhancementParameter::EnhancementLevel)
+            m_enhancementLevel = juce::jlimit(0.0f, 1.0f, value);
+        else if (parameter == aic::EnhancementParameter::VoiceGain)
+            m_voiceGain = value;
+    }
+
+    size_t getOutputDelay() const override
+    {
+        return m_delay;
+    }
+
+    uint32_t getOptimalSampleRate() const override
+    {
+        return m_optimalSampleRate;
+    }
+
+    size_t getOptimalNumFrames(uint32_t sampleRate) const override
+    {
+        // 10 ms, like most of the models
+        return static_cast<size_t>(sampleRate / 100);
+    }
+
+    bool hasVad() const override
+    {
+        return m_settings.vadMode != StubBackend::VadMode::Off;
+    }
+
+    void setVadParameter(aic::VadParameter parameter, float value) override
+    {
+        juce::ignoreUnused(parameter, value);
+    }
+
+    bool isSpeechDetected() const override
+    {
+        return m_speech;
+    }
+
+  private:
+    void updateVad(const float* const* audio, int numChannels, int numFrames)
+    {
+        switch (m_settings.vadMode)
+        {
+        case StubBackend::VadMode::Off:
+            m_speech = false;
+            break;
+        case StubBackend::VadMode::Energy:
+        {
+            float sumOfSquares = 0.0f;
+            for (int ch = 0; ch < numChannels; ++ch)
+                for (int i = 0; i < numFrames; ++i)
+                    sumOfSquares += audio[ch][i] * audio[ch][i];
+
+            auto count = juce::jmax(1, numChannels * numFrames);
+            auto rms   = std::sqrt(sumOfSquares / static_cast<float>(count));
+            m_speech   = juce::Decibels::gainToDecibels(rms) > m_settings.vadThresholdDb;
+            break;
+        }
+        case StubBackend::VadMode::Alternating:
+            // Silence first, then speech, each for one period
+            m_speech = (m_position / m_periodFrames) % 2 == 1;
+            break;
+        }
+    }
+
+    /**
+     * @brief Busy waits until the configured share of the block duration has passed.
+     */
+    void spend(juce::int64 startTicks, int numFrames) const
+    {
+        if (m_settings.computeLoad <= 0.0 || m_sampleRate == 0)
+            return;
+
+        const auto ticksPerSecond =
+            static_cast<double>(juce::Time::getHighResolutionTicksPerSecond());
+        const auto seconds =
+            m_settings.computeLoad * numFrames / static_cast<double>(m_sampleRate);
+        const auto endTicks = startTicks + static_cast<juce::int64>(seconds * ticksPerSecond);
+
+        while (juce::Time::getHighResolutionTicks() < endTicks)
+        {
+        }
+    }
+
+    StubBackend::Settings m_settings;
+    const uint32_t        m_optimalSampleRate;
+    const double          m_latencyMs;
+
+    uint32_t                        m_sampleRate{48000};
+    size_t                          m_delay{0};
+    size_t                          m_delayIndex{0};
+    std::vector<std::vector<float>> m_delayLines;
+    std::int64_t                    m_position{0};
+    std::int64_t                    m_periodFrames{1};
+
+    bool  m_bypass{false};
+    float m_enhancementLevel{1.0f};
+    float m_voiceGain{1.0f};
+    bool  m_speech{false};
+};
+
+} // namespace
+
+std::pair<std::unique_ptr<EnhancementEngine>, aic::ErrorCode>
+StubBackend::create(aic::ModelType modelType, const std::string& licenseKey)
+{
+    juce::ignoreUnused(licenseKey);
+    return {std::make_unique<StubEngine>(m_settings, modelType), aic::ErrorCode::Success};
+}
+
+} // namespace aic
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "EnhancementBackend.h"
+
+#include <optional>
+
+namespace aic
+{
+
+/**
+ * @brief Deterministic stand-in for the SDK, needs no license and no network.
+ *
+ * The engines delay the input by a fixed latency, apply the voice gain and attenuate by the
+ * enhancement level while the VAD detects no speech. Like the model type they stand in for, they
+ * prefer its sample rate and by default have its delay. The same input always gives the same
+ * output. A configurable share of real time is spent busy waiting in every block, so benchmarks
+ * and stress tests can measure the buffering, resampling and scheduling of the plugin itself
+ * under a realistic load.
+ */
+class StubBackend : public EnhancementBackend
+{
+  public:
+    enum class VadMode
+    {
+        Off,
+        Energy,
+        Alternating
+    };
+
+    struct Settings
+    {
+        // Output delay, the delay of the model type if not set
+        std::optional<double> latencyMs;
+
+        double  computeLoad{0.0}; // Share of the block duration spent per block, 0.5 is half
+        VadMode vadMode{VadMode::Energy};
+        float   vadThresholdDb{-40.0f}; // Energy mode, block RMS of the input
+        double  vadPeriodMs{1000.0};    // Alternating mode, length of each speech and silence part
+    };
+
+    explicit StubBackend(const Settings& settings = {}) : m_settings(settings) {}
+
+    std::pair<std::unique_ptr<EnhancementEngine>, aic::ErrorCode>
+    create(aic::ModelType modelType, const std::string& licenseKey) override;
+
+    bool requiresLicense() const override
+    {
+        return false;
+    }
+
+    juce::String getName() const override
+    {
+        return "stub";
+    }
+
+  private:
+    Settings m_settings;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StubBackend)
+};
+
+} // namespace aic
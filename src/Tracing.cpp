@@ -0,0 +1,320 @@
+#include "Tracing.h"
+
+#include "Logging.h"
+
+#include <array>
+
+#if JUCE_LINUX || JUCE_MAC
+#include <pthread.h>
+#endif
+
+namespace aic::trace
+{
+
+struct Recorder::ThreadBuffer
+{
+    static constexpr std::uint32_t capacity = 1 << 14;
+
+    struct Event
+    {
+        juce::int64       ticks;
+        const char*       name;
+        double            value;
+        detail::EventType type;
+    };
+
+    enum class State
+    {
+        Free,
+        Claiming,
+        Claimed,
+        Released
+    };
+
+    std::vector<Event>         events = std::vector<Event>(capacity);
+    std::atomic<std::uint32_t> writeIndex{0};
+    std::atomic<std::uint32_t> readIndex{0};
+    std::atomic<std::uint32_t> numDropped{0};
+
+    // Written by the claiming thread before the state becomes Claimed
+    std::array<char, 64> threadName{};
+    int                  threadId{0};
+    std::atomic<State>   state{State::Free};
+
+    // Only used by the writer
+    bool nameWritten{false};
+};
+
+namespace
+{
+
+std::atomic<std::uint64_t> nextSession{1};
+
+/**
+ * @brief The buffer the calling thread claimed from the recorder of a session.
+ */
+struct ThreadSlot
+{
+    ~ThreadSlot()
+    {
+        if (buffer == nullptr)
+            return;
+
+        // A later session has buffers of its own, the recorder ignores the release then
+        detail::numRecording.fetch_add(1);
+        if (auto* recorder = detail::activeRecorder.load())
+            recorder->releaseThreadBuffer(session, buffer);
+        detail::numRecording.fetch_sub(1);
+    }
+
+    std::uint64_t           session{0};
+    Recorder::ThreadBuffer* buffer{nullptr};
+};
+
+thread_local ThreadSlot threadSlot;
+
+/**
+ * @brief Copies the native name of the calling thread, which neither locks nor allocates.
+ *
+ * JUCE names its threads natively when they start, Linux truncates the names to 15 characters.
+ * Threads stay unnamed on other platforms and are listed by their number.
+ */
+void copyCurrentThreadName(std::array<char, 64>& name) noexcept
+{
+    name.fill(0);
+
+#if JUCE_LINUX || JUCE_MAC
+    pthread_getname_np(pthread_self(), name.data(), name.size());
+    name.back() = 0;
+#endif
+}
+
+} // namespace
+
+void detail::record(EventType type, const char* name, double value) noexcept
+{
+    // Counted before the load, the destructor either waits for this call or it finds no recorder
+    numRecording.fetch_add(1);
+    if (auto* recorder = activeRecorder.load())
+        recorder->push(type, name, value);
+    numRecording.fetch_sub(1);
+}
+
+Recorder::Recorder() : juce::Thread("aic trace writer")
+{
+    auto path = juce::SystemStats::getEnvironmentVariable("AIC_TRACE", {});
+    if (path.isEmpty())
+        return;
+
+    auto file = juce::File::getCurrentWorkingDirectory().getChildFile(path);
+    file.deleteFile();
+
+    m_stream = std::make_unique<juce::FileOutputStream>(file);
+    if (!m_stream->openedOk())
+    {
+        aic::log::write(aic::log::Level::Warning, aic::log::Code::TraceFileFailed,
+                        file.getFullPathName());
+        m_stream.reset();
+        return;
+    }
+
+    // All buffers are allocated up front, threads claim them without allocating
+    for (int index = 0; index < maxThreads; ++index)
+        m_threadBuffers.push_back(std::make_unique<ThreadBuffer>());
+
+    m_session       = nextSession.fetch_add(1);
+    m_startTicks    = juce::Time::getHighResolutionTicks();
+    m_microsPerTick = 1.0e6 / static_cast<double>(juce::Time::getHighResolutionTicksPerSecond());
+
+    *m_stream << "{\"traceEvents\":[\n";
+
+    detail::activeRecorder.store(this, std::memory_order_release);
+    startThread(juce::Thread::Priority::low);
+}
+
+Recorder::~Recorder()
+{
+    if (m_stream == nullptr)
+        return;
+
+    auto* expected = this;
+    detail::activeRecorder.compare_exchange_strong(expected, nullptr);
+
+    // Threads that loaded the recorder before it was unpublished finish their event first
+    while (detail::numRecording.load() > 0)
+        juce::Thread::yield();
+
+    stopThread(1000);
+    flush();
+
+    *m_stream << "\n]}\n";
+    m_stream->flush();
+}
+
+void Recorder::push(detail::EventType type, const char* name, double value) noexcept
+{
+    auto* buffer = getThreadBuffer();
+    if (buffer == nullptr)
+        return;
+
+    auto write = buffer->writeIndex.load(std::memory_order_relaxed);
+    if (write - buffer->readIndex.load(std::memory_order_acquire) >= ThreadBuffer::capacity)
+    {
+        buffer->numDropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    buffer->events[write & (ThreadBuffer::capacity - 1)] = {juce::Time::getHighResolutionTicks(),
+                                                            name, value, type};
+    buffer->writeIndex.store(write + 1, std::memory_order_release);
+}
+
+Recorder::ThreadBuffer* Recorder::getThreadBuffer() noexcept
+{
+    if (threadSlot.session == m_session)
+        return threadSlot.buffer;
+
+    threadSlot.session = m_session;
+    threadSlot.buffer  = nullptr;
+
+    for (auto& candidate : m_threadBuffers)
+    {
+        auto expected = ThreadBuffer::State::Free;
+        if (!candidate->state.compare_exchange_strong(expected, ThreadBuffer::State::Claiming,
+                                                      std::memory_order_acquire))
+            continue;
+
+        // Usually claimed by the first event of the thread, which may be the audio thread
+        auto* buffer = candidate.get();
+        copyCurrentThreadName(buffer->threadName);
+
+        // A new track in the trace, even if the buffer recorded another thread before
+        buffer->threadId = m_nextThreadId.fetch_add(1);
+        buffer->state.store(ThreadBuffer::State::Claimed, std::memory_order_release);
+
+        threadSlot.buffer = buffer;
+        return buffer;
+    }
+
+    // Not recorded for the rest of the session
+    m_threadsDropped.fetch_add(1);
+    return nullptr;
+}
+
+void Recorder::releaseThreadBuffer(std::uint64_t session, ThreadBuffer* buffer) noexcept
+{
+    if (session == m_session)
+        buffer->state.store(ThreadBuffer::State::Released, std::memory_order_release);
+}
+
+void Recorder::run()
+{
+    while (!threadShouldExit())
+    {
+        wait(flushIntervalMs);
+        flush();
+    }
+}
+
+void Recorder::flush()
+{
+    for (auto& threadBuffer : m_threadBuffers)
+    {
+        auto& buffer = *threadBuffer;
+
+        // Released after the last event of the thread, which is written below
+        const auto state = buffer.state.load(std::memory_order_acquire);
+        if (state != ThreadBuffer::State::Claimed && state != ThreadBuffer::State::Released)
+            continue;
+
+        const auto tid = juce::String(buffer.threadId);
+
+        if (!buffer.nameWritten)
+        {
+            auto name = juce::String::fromUTF8(buffer.threadName.data());
+            if (name.isEmpty())
+                name = "thread " + tid;
+
+            writeEvent("{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" + tid +
+                       ",\"args\":{\"name\":" + juce::JSON::toString(name) + "}}");
+            buffer.nameWritten = true;
+        }
+
+        auto read  = buffer.readIndex.load(std::memory_order_relaxed);
+        auto write = buffer.writeIndex.load(std::memory_order_acquire);
+
+        for (; read != write; ++read)
+        {
+            const auto& event  = buffer.events[read & (ThreadBuffer::capacity - 1)];
+            const auto  ts     = getTimestamp(event.ticks);
+            const auto  common = "\"name\":\"" + juce::String(event.name) + "\",\"ts\":" + ts +
+                                ",\"pid\":1,\"tid\":" + tid;
+
+            switch (event.type)
+            {
+            case detail::EventType::Begin:
+                writeEvent("{\"ph\":\"B\"," + common + "}");
+                break;
+            case detail::EventType::End:
+                writeEvent("{\"ph\":\"E\"," + common + "}");
+                break;
+            case detail::EventType::Counter:
+                writeEvent("{\"ph\":\"C\"," + common + ",\"args\":{\"value\":" +
+                           juce::String(event.value) + "}}");
+                break;
+            case detail::EventType::Instant:
+                writeEvent("{\"ph\":\"i\",\"s\":\"t\"," + common + "}");
+                break;
+            }
+        }
+
+        buffer.readIndex.store(read, std::memory_order_release);
+
+        // Shown as a counter of the thread, so gaps in the trace can be told apart
+        if (auto dropped = buffer.numDropped.exchange(0))
+        {
+            writeEvent("{\"ph\":\"C\",\"name\":\"dropped trace events\",\"ts\":" +
+                       getTimestamp(juce::Time::getHighResolutionTicks()) +
+                       ",\"pid\":1,\"tid\":" + tid + ",\"args\":{\"value\":" +
+                       juce::String(dropped) + "}}");
+        }
+
+        // The thread has exited and everything it recorded is written, another one may claim it
+        if (state == ThreadBuffer::State::Released)
+        {
+            buffer.readIndex.store(0, std::memory_order_relaxed);
+            buffer.writeIndex.store(0, std::memory_order_relaxed);
+            buffer.numDropped.store(0, std::memory_order_relaxed);
+            buffer.nameWritten = false;
+            buffer.state.store(ThreadBuffer::State::Free, std::memory_order_release);
+        }
+    }
+
+    // More threads at once than buffers, they are missing from the trace
+    if (auto threadsDropped = m_threadsDropped.load(); threadsDropped != m_threadsDroppedWritten)
+    {
+        writeEvent("{\"ph\":\"C\",\"name\":\"threads dropped\",\"ts\":" +
+                   getTimestamp(juce::Time::getHighResolutionTicks()) +
+                   ",\"pid\":1,\"tid\":0,\"args\":{\"value\":" +
+                   juce::String(threadsDropped) + "}}");
+        m_threadsDroppedWritten = threadsDropped;
+    }
+
+    m_stream->flush();
+}
+
+juce::String Recorder::getTimestamp(juce::int64 ticks) const
+{
+    return juce::String(static_cast<double>(ticks - m_startTicks) * m_microsPerTick, 3);
+}
+
+void Recorder::writeEvent(const juce::String& json)
+{
+    if (!m_firstEvent)
+        *m_stream << ",\n";
+
+    m_firstEvent = false;
+    *m_stream << json;
+}
+
+} // namespace aic::trace
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <juce_core/juce_core.h>
+#include <memory>
+#include <vector>
+
+namespace aic::trace
+{
+
+class Recorder;
+
+namespace detail
+{
+enum class EventType : std::uint8_t
+{
+    Begin,
+    End,
+    Counter,
+    Instant
+};
+
+// Set while a recorder runs, everything else is a no-op
+inline std::atomic<Recorder*> activeRecorder{nullptr};
+
+// Threads using the active recorder, it is only destroyed once none of them can still be using it
+inline std::atomic<int> numRecording{0};
+
+void record(EventType type, const char* name, double value) noexcept;
+} // namespace detail
+
+/**
+ * @brief Whether events are recorded. A single relaxed load, checked before anything else.
+ */
+inline bool isEnabled() noexcept
+{
+    return detail::activeRecorder.load(std::memory_order_relaxed) != nullptr;
+}
+
+/**
+ * @brief Records a value over time, such as the latency. The name must be a string literal.
+ */
+inline void counter(const char* name, double value) noexcept
+{
+    if (isEnabled())
+        detail::record(detail::EventType::Counter, name, value);
+}
+
+/**
+ * @brief Records a moment, such as a model swap. The name must be a string literal.
+ */
+inline void instant(const char* name) noexcept
+{
+    if (isEnabled())
+        detail::record(detail::EventType::Instant, name, 0.0);
+}
+
+/**
+ * @brief Records the duration of a scope on the calling thread. The name must be a string literal.
+ *
+ * Real-time safe, the events go into a preallocated buffer of the thread.
+ */
+class ScopedSpan
+{
+  public:
+    explicit ScopedSpan(const char* name) noexcept : m_name(isEnabled() ? name : nullptr)
+    {
+        if (m_name != nullptr)
+            detail::record(detail::EventType::Begin, m_name, 0.0);
+    }
+
+    ~ScopedSpan()
+    {
+        // Also ends the span if recording stopped in between, the writer drops the event then
+        if (m_name != nullptr)
+            detail::record(detail::EventType::End, m_name, 0.0);
+    }
+
+  private:
+    const char* m_name;
+
+    JUCE_DECLARE_NON_COPYABLE(ScopedSpan)
+};
+
+/**
+ * @brief Writes the events of all threads to a Chrome trace file while it exists.
+ *
+ * Recording is enabled by setting the AIC_TRACE environment variable to the path of the file,
+ * which can be opened in Perfetto (ui.perfetto.dev) or chrome://tracing. Every thread records
+ * into its own lock-free buffer, a background thread writes them to the file. Held by every
+ * processor, so one file covers all instances of the process.
+ *
+ * The buffers are allocated up front. A thread hands its buffer back when it exits, so threads
+ * that come and go, like the workers of a pool, are recorded as long as no more than the
+ * maximum run at the same time. Threads beyond it are counted as dropped in the trace.
+ */
+class Recorder : private juce::Thread
+{
+  public:
+    Recorder();
+    ~Recorder() override;
+
+    /**
+     * @brief Adds the event to the buffer of the calling thread, dropped if it is full.
+     */
+    void push(detail::EventType type, const char* name, double value) noexcept;
+
+    struct ThreadBuffer;
+
+    /**
+     * @brief Hands the buffer of an exiting thread back, to be reused once it is written.
+     */
+    void releaseThreadBuffer(std::uint64_t session, ThreadBuffer* buffer) noexcept;
+
+  private:
+    static constexpr int maxThreads      = 32;
+    static constexpr int flushIntervalMs = 100;
+
+    ThreadBuffer* getThreadBuffer() noexcept;
+
+    void run() override;
+    void flush();
+    void writeEvent(const juce::String& json);
+    juce::String getTimestamp(juce::int64 ticks) const;
+
+    std::uint64_t                              m_session{0};
+    std::unique_ptr<juce::FileOutputStream>    m_stream;
+    std::vector<std::unique_ptr<ThreadBuffer>> m_threadBuffers;
+    std::atomic<int>                           m_nextThreadId{1};
+    std::atomic<int>                           m_threadsDropped{0};
+    int                                        m_threadsDroppedWritten{0};
+    juce::int64                                m_startTicks{0};
+    double                                     m_microsPerTick{0.0};
+    bool                                       m_firstEvent{true};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Recorder)
+};
+
+} // namespace aic::trace
@@ -0,0 +1,143 @@
+#include "VadEvents.h"
+
+namespace aic::vad
+{
+
+EventQueue::EventQueue(int capacity)
+    : m_fifo(capacity), m_events(static_cast<size_t>(capacity))
+{
+}
+
+bool EventQueue::push(const Event& event) noexcept
+{
+    const auto scope = m_fifo.write(1);
+    if (scope.blockSize1 == 0)
+    {
+        m_numDropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    m_events[static_cast<size_t>(scope.startIndex1)] = event;
+    return true;
+}
+
+int EventQueue::popAll(std::vector<Event>& events)
+{
+    const auto scope = m_fifo.read(m_fifo.getNumReady());
+
+    scope.forEach([this, &events](int index)
+                  { events.push_back(m_events[static_cast<size_t>(index)]); });
+
+    return scope.blockSize1 + scope.blockSize2;
+}
+
+std::vector<Segment> toSegments(const std::vector<Event>& events, std::int64_t numSamples)
+{
+    std::vector<Segment> segments;
+    Segment              current{0, 0, false};
+
+    for (const auto& event : events)
+    {
+        auto position = juce::jlimit(current.start, numSamples, event.samplePosition);
+        if (event.speech == current.speech)
+            continue;
+
+        // Changes within the same sample only keep the last state
+        if (position > current.start)
+        {
+            current.end = position;
+            segments.push_back(current);
+        }
+
+        current = {position, position, event.speech};
+    }
+
+    if (numSamples > current.start)
+    {
+        current.end = numSamples;
+        segments.push_back(current);
+    }
+
+    // Zero length segments in between can leave neighbours with the same state
+    std::vector<Segment> merged;
+    for (const auto& segment : segments)
+    {
+        if (!merged.empty() && merged.back().speech == segment.speech)
+            merged.back().end = segment.end;
+        else
+            merged.push_back(segment);
+    }
+
+    return merged;
+}
+
+std::vector<Segment> toSpeechRegions(const std::vector<Segment>& segments,
+                                     std::int64_t paddingSamples, std::int64_t numSamples)
+{
+    std::vector<Segment> regions;
+
+    for (const auto& segment : segments)
+    {
+        if (!segment.speech)
+            continue;
+
+        Segment region{juce::jmax(static_cast<std::int64_t>(0), segment.start - paddingSamples),
+                       juce::jmin(numSamples, segment.end + paddingSamples), true};
+
+        if (!regions.empty() && region.start <= regions.back().end)
+            regions.back().end = juce::jmax(regions.back().end, region.end);
+        else
+            regions.push_back(region);
+    }
+
+    return regions;
+}
+
+juce::String toJson(const std::vector<Segment>& segments, double sampleRate)
+{
+    juce::Array<juce::var> list;
+    std::int64_t           speechSamples = 0;
+    std::int64_t           numSamples    = 0;
+
+    for (const auto& segment : segments)
+    {
+        auto* object = new juce::DynamicObject();
+        object->setProperty("start", static_cast<double>(segment.start) / sampleRate);
+        object->setProperty("end", static_cast<double>(segment.end) / sampleRate);
+        object->setProperty("startSample", static_cast<juce::int64>(segment.start));
+        object->setProperty("endSample", static_cast<juce::int64>(segment.end));
+        object->setProperty("speech", segment.speech);
+        list.add(juce::var(object));
+
+        if (segment.speech)
+            speechSamples += segment.end - segment.start;
+
+        numSamples = juce::jmax(numSamples, segment.end);
+    }
+
+    auto* root = new juce::DynamicObject();
+    root->setProperty("sampleRate", sampleRate);
+    root->setProperty("duration", static_cast<double>(numSamples) / sampleRate);
+    root->setProperty("speechDuration", static_cast<double>(speechSamples) / sampleRate);
+    root->setProperty("segments", list);
+
+    return juce::JSON::toString(juce::var(root));
+}
+
+juce::String toCsv(const std::vector<Segment>& segments, double sampleRate)
+{
+    juce::String csv("start,end,start_sample,end_sample,speech\n");
+
+    for (const auto& segment : segments)
+    {
+        csv << juce::String(static_cast<double>(segment.start) / sampleRate, 6) << ","
+            << juce::String(static_cast<double>(segment.end) / sampleRate, 6) << ","
+            << juce::String(static_cast<juce::int64>(segment.start)) << ","
+            << juce::String(static_cast<juce::int64>(segment.end)) << ","
+            << (segment.speech ? "1" : "0") << "\n";
+    }
+
+    return csv;
+}
+
+} // namespace aic::vad
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <juce_core/juce_core.h>
+#include <vector>
+
+namespace aic::vad
+{
+
+/**
+ * @brief A change of the voice activity detection result.
+ *
+ * The position is in samples of the input stream since prepareToPlay or reset, at which the new
+ * state begins.
+ */
+struct Event
+{
+    std::int64_t samplePosition{0};
+    bool         speech{false};
+};
+
+/**
+ * @brief Single-producer single-consumer queue of VAD events.
+ *
+ * Pushing and popping are wait-free and never allocate, the audio thread pushes and one other
+ * thread pops. Events that do not fit are dropped and counted.
+ */
+class EventQueue
+{
+  public:
+    explicit EventQueue(int capacity = 4096);
+
+    /**
+     * @brief Adds an event. Real-time safe, only called by the producer.
+     *
+     * @return false if the queue was full and the event was dropped
+     */
+    bool push(const Event& event) noexcept;
+
+    /**
+     * @brief Appends all queued events to the vector. Only called by the consumer.
+     *
+     * @return The number of events appended
+     */
+    int popAll(std::vector<Event>& events);
+
+    /**
+     * @brief Gets the number of events dropped because the consumer fell behind.
+     */
+    int getNumDropped() const noexcept
+    {
+        return m_numDropped.load(std::memory_order_relaxed);
+    }
+
+  private:
+    juce::AbstractFifo m_fifo;
+    std::vector<Event> m_events;
+    std::atomic<int>   m_numDropped{0};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EventQueue)
+};
+
+/**
+ * @brief A region of the stream in which the VAD result does not change, [start, end) in samples.
+ */
+struct Segment
+{
+    std::int64_t start{0};
+    std::int64_t end{0};
+    bool         speech{false};
+};
+
+/**
+ * @brief Turns events into consecutive segments covering [0, numSamples).
+ *
+ * The stream starts without speech. Events past the end of the stream are ignored.
+ */
+std::vector<Segment> toSegments(const std::vector<Event>& events, std::int64_t numSamples);
+
+/**
+ * @brief Keeps only the speech segments, widened by the padding on both sides.
+ *
+ * Padded segments that touch or overlap are merged, so every sample is listed at most once.
+ */
+std::vector<Segment> toSpeechRegions(const std::vector<Segment>& segments,
+                                     std::int64_t paddingSamples, std::int64_t numSamples);
+
+/**
+ * @brief Formats segments as a JSON object with times in seconds and samples.
+ */
+juce::String toJson(const std::vector<Segment>& segments, double sampleRate);
+
+/**
+ * @brief Formats segments as CSV with a header row, one segment per row.
+ */
+juce::String toCsv(const std::vector<Segment>& segments, double sampleRate);
+
+} // namespace aic::vad
@@ -0,0 +1,359 @@
+#include "LevelMeter.h"
+#include "MemoryUtils.h"
+#include "PluginProcessor.h"
+#include "ToolHelpers.h"
+
+#include <algorithm>
+#include <iostream>
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <numeric>
+#include <vector>
+
+namespace
+{
+
+struct Options
+{
+    int    modelIndex{0};
+    double sampleRate{48000.0};
+    int    blockSize{480};
+    int    numBlocks{1000};
+    int    warmUpMs{250};
+    bool   silence{false};
+
+    aic::tools::BackendOptions backend;
+};
+
+Options parseOptions(const juce::ArgumentList& args)
+{
+    Options options;
+    options.modelIndex = aic::tools::getIntOption(args, "--model", options.modelIndex);
+    options.sampleRate = aic::tools::getIntOption(args, "--sample-rate", 48000);
+    options.blockSize  = aic::tools::getIntOption(args, "--block-size", options.blockSize);
+    options.numBlocks =
+        juce::jmax(20, aic::tools::getIntOption(args, "--blocks", options.numBlocks));
+    options.warmUpMs   = aic::tools::getIntOption(args, "--warmup-ms", options.warmUpMs);
+    options.silence    = args.containsOption("--silence");
+    options.backend    = aic::tools::parseBackendOptions(args);
+    return options;
+}
+
+juce::StringArray toArguments(const Options& options, int warmUpMs)
+{
+    juce::StringArray arguments;
+    arguments.add("--model=" + juce::String(options.modelIndex));
+    arguments.add("--sample-rate=" + juce::String(juce::roundToInt(options.sampleRate)));
+    arguments.add("--block-size=" + juce::String(options.blockSize));
+    arguments.add("--blocks=" + juce::String(options.numBlocks));
+    arguments.add("--warmup-ms=" + juce::String(warmUpMs));
+    if (options.silence)
+        arguments.add("--silence");
+    arguments.addArray(aic::tools::toArguments(options.backend));
+    return arguments;
+}
+
+/**
+ * @brief Times every processBlock call after prepareToPlay, in microseconds.
+ */
+std::vector<double> measureBlocks(const Options& options)
+{
+    AicDemoAudioProcessor processor(aic::tools::createBackend(options.backend));
+    processor.setWarmUpSettings({options.warmUpMs, !options.silence, false});
+    aic::tools::setModel(processor, options.modelIndex);
+    aic::tools::prepareProcessor(processor, options.sampleRate, options.blockSize);
+
+    juce::AudioBuffer<float> buffer(processor.getTotalNumInputChannels(), options.blockSize);
+    juce::MidiBuffer         midi;
+    juce::Random             random(1);
+
+    std::vector<double> micros;
+    micros.reserve(static_cast<size_t>(options.numBlocks));
+
+    for (int block = 0; block < options.numBlocks; ++block)
+    {
+        // Roughly -20 dBFS noise, generated outside of the measurement
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                buffer.setSample(ch, i, (random.nextFloat() * 2.0f - 1.0f) * 0.1f);
+
+        auto start = juce::Time::getHighResolutionTicks();
+        processor.processBlock(buffer, midi);
+        auto end = juce::Time::getHighResolutionTicks();
+
+        micros.push_back(juce::Time::highResolutionTicksToSeconds(end - start) * 1.0e6);
+    }
+
+    return micros;
+}
+
+double percentile(std::vector<double> values, double fraction)
+{
+    std::sort(values.begin(), values.end());
+    auto index = static_cast<size_t>(fraction * static_cast<double>(values.size() - 1));
+    return values[index];
+}
+
+double mean(const std::vector<double>& values)
+{
+    return std::accumulate(values.begin(), values.end(), 0.0) / static_cast<double>(values.size());
+}
+
+/**
+ * @brief Runs a measurement command in a fresh process, so no run benefits from a previous one.
+ *
+ * @return The numbers the command printed
+ */
+std::vector<double> runInChildProcess(const juce::String& measureCommand, const Options& options,
+                                      int warmUpMs)
+{
+    juce::StringArray command;
+    command.add(juce::File::getSpecialLocation(juce::File::currentExecutableFile)
+                    .getFullPathName());
+    command.add(measureCommand);
+    command.addArray(toArguments(options, warmUpMs));
+
+    juce::ChildProcess child;
+    if (!child.start(command))
+        juce::ConsoleApplication::fail("Failed to start " + command[0]);
+
+    auto output = child.readAllProcessOutput();
+    if (child.getExitCode() != 0)
+        juce::ConsoleApplication::fail(output.trim());
+
+    std::vector<double> values;
+    for (const auto& token : juce::StringArray::fromTokens(output, false))
+        if (token.isNotEmpty())
+            values.push_back(token.getDoubleValue());
+
+    return values;
+}
+
+std::vector<double> measureInChildProcess(const Options& options, int warmUpMs)
+{
+    auto micros = runInChildProcess("measure", options, warmUpMs);
+
+    if (micros.size() != static_cast<size_t>(options.numBlocks))
+        juce::ConsoleApplication::fail("Unexpected output of the measurement");
+
+    return micros;
+}
+
+void printRow(const juce::String& label, const std::vector<double>& micros)
+{
+    // The second half of the run is considered steady state
+    std::vector<double> steady(micros.begin() + static_cast<std::ptrdiff_t>(micros.size() / 2),
+                               micros.end());
+    std::vector<double> early(micros.begin(), micros.begin() + 10);
+
+    auto median = percentile(steady, 0.5);
+
+    std::cout << label.paddedRight(' ', 12) << juce::String(micros.front(), 1).paddedLeft(' ', 12)
+              << juce::String(mean(early), 1).paddedLeft(' ', 14)
+              << juce::String(median, 1).paddedLeft(' ', 14)
+              << juce::String(percentile(steady, 0.99), 1).paddedLeft(' ', 12)
+              << juce::String(micros.front() / median, 2).paddedLeft(' ', 14) << std::endl;
+}
+
+void runWarmUpBenchmark(const juce::ArgumentList& args)
+{
+    auto options = parseOptions(args);
+
+    auto models = AicDemoAudioProcessor::getModelChoices();
+    if (!juce::isPositiveAndBelow(options.modelIndex, models.size()))
+        juce::ConsoleApplication::fail("Invalid model index, available models: " +
+                                       models.joinIntoString(", "));
+
+    std::cout << models[options.modelIndex] << ", " << options.sampleRate << " Hz, "
+              << options.blockSize << " samples per block, " << options.numBlocks << " blocks"
+              << std::endl
+              << "times in microseconds, steady state is the second half of the run" << std::endl
+              << std::endl;
+
+    std::cout << juce::String("warm-up").paddedRight(' ', 12)
+              << juce::String("first").paddedLeft(' ', 12)
+              << juce::String("first 10 avg").paddedLeft(' ', 14)
+              << juce::String("steady med").paddedLeft(' ', 14)
+              << juce::String("steady p99").paddedLeft(' ', 12)
+              << juce::String("first/median").paddedLeft(' ', 14) << std::endl;
+
+    printRow("off", measureInChildProcess(options, 0));
+    printRow(juce::String(options.warmUpMs) + " ms",
+             measureInChildProcess(options, options.warmUpMs));
+}
+
+juce::String toMegabytes(double bytes)
+{
+    if (bytes < 0.0)
+        return "n/a";
+
+    return juce::String(bytes / (1024.0 * 1024.0), 1);
+}
+
+void runMemoryBenchmark(const juce::ArgumentList& args)
+{
+    auto options = parseOptions(args);
+    auto models  = AicDemoAudioProcessor::getModelChoices();
+
+    std::cout << options.sampleRate << " Hz, " << options.blockSize << " samples per block"
+              << std::endl
+              << "resident memory in MB, each model is measured in a fresh process" << std::endl
+              << std::endl;
+
+    std::cout << juce::String("model").paddedRight(' ', 12)
+              << juce::String("create").paddedLeft(' ', 10)
+              << juce::String("initialize").paddedLeft(' ', 12)
+              << juce::String("model").paddedLeft(' ', 10)
+              << juce::String("instance").paddedLeft(' ', 10)
+              << juce::String("process").paddedLeft(' ', 10) << std::endl;
+
+    for (int index = 0; index < models.size(); ++index)
+    {
+        if (args.containsOption("--model") && index != options.modelIndex)
+            continue;
+
+        auto modelOptions       = options;
+        modelOptions.modelIndex = index;
+
+        // create, initialize, process before, process after
+        auto values = runInChildProcess("measure-memory", modelOptions, options.warmUpMs);
+        if (values.size() != 4)
+            juce::ConsoleApplication::fail("Unexpected output of the measurement");
+
+        auto modelBytes    = values[0] < 0.0 || values[1] < 0.0 ? -1.0 : values[0] + values[1];
+        auto instanceBytes = values[2] < 0.0 ? -1.0 : values[3] - values[2];
+
+        std::cout << models[index].paddedRight(' ', 12)
+                  << toMegabytes(values[0]).paddedLeft(' ', 10)
+                  << toMegabytes(values[1]).paddedLeft(' ', 12)
+                  << toMegabytes(modelBytes).paddedLeft(' ', 10)
+                  << toMegabytes(instanceBytes).paddedLeft(' ', 10)
+                  << toMegabytes(values[3]).paddedLeft(' ', 10) << std::endl;
+    }
+
+    std::cout << std::endl
+              << "model: measured by the plugin around model creation, initialization and warm-up"
+              << std::endl
+              << "instance: growth of the process for one plugin instance, including its buffers"
+              << std::endl;
+}
+
+/**
+ * @brief Times the input and output metering of the processor against the duration of a block.
+ *
+ * Fails if the 99th percentile exceeds 1 % of the block duration.
+ */
+void runMeteringBenchmark(const juce::ArgumentList& args)
+{
+    constexpr int numChannels     = 2;
+    constexpr int blocksPerSample = 100;
+
+    auto options = parseOptions(args);
+
+    aic::dsp::LevelMeter inputMeter;
+    aic::dsp::LevelMeter outputMeter;
+    inputMeter.prepare(options.sampleRate);
+    outputMeter.prepare(options.sampleRate);
+
+    juce::AudioBuffer<float> buffer(numChannels, options.blockSize);
+    juce::Random             random(1);
+    for (int ch = 0; ch < numChannels; ++ch)
+        for (int i = 0; i < options.blockSize; ++i)
+            buffer.setSample(ch, i, (random.nextFloat() * 2.0f - 1.0f) * 0.1f);
+
+    // Single blocks are too short for the timer, every sample averages a batch of blocks
+    std::vector<double> micros;
+    micros.reserve(static_cast<size_t>(options.numBlocks));
+
+    for (int sample = 0; sample < options.numBlocks; ++sample)
+    {
+        auto start = juce::Time::getHighResolutionTicks();
+        for (int block = 0; block < blocksPerSample; ++block)
+        {
+            inputMeter.process(buffer.getArrayOfReadPointers(), numChannels, options.blockSize);
+            outputMeter.process(buffer.getArrayOfReadPointers(), numChannels, options.blockSize);
+        }
+        auto end = juce::Time::getHighResolutionTicks();
+
+        micros.push_back(juce::Time::highResolutionTicksToSeconds(end - start) * 1.0e6 /
+                         blocksPerSample);
+    }
+
+    auto blockMicros = options.blockSize / options.sampleRate * 1.0e6;
+    auto p99         = percentile(micros, 0.99);
+
+    std::cout << "metering of " << numChannels << " channels in and out, " << options.blockSize
+              << " samples per block at " << options.sampleRate << " Hz" << std::endl
+              << "median " << juce::String(percentile(micros, 0.5), 3) << " us, p99 "
+              << juce::String(p99, 3) << " us, " << juce::String(100.0 * p99 / blockMicros, 3)
+              << " % of the block duration" << std::endl;
+
+    if (p99 > 0.01 * blockMicros)
+        juce::ConsoleApplication::fail("Metering exceeds 1 % of the block duration");
+}
+
+void runMemoryMeasurement(const juce::ArgumentList& args)
+{
+    auto options       = parseOptions(args);
+    auto residentBytes = aic::memory::getResidentMemoryBytes();
+
+    AicDemoAudioProcessor processor(aic::tools::createBackend(options.backend));
+    processor.setWarmUpSettings({options.warmUpMs, !options.silence, false});
+    aic::tools::setModel(processor, options.modelIndex);
+    aic::tools::prepareProcessor(processor, options.sampleRate, options.blockSize);
+
+    auto usage = processor.getModelMemoryUsage();
+    std::cout << usage.createBytes << " " << usage.initializeBytes << " " << residentBytes << " "
+              << aic::memory::getResidentMemoryBytes() << std::endl;
+}
+
+void runMeasurement(const juce::ArgumentList& args)
+{
+    auto micros = measureBlocks(parseOptions(args));
+
+    juce::StringArray tokens;
+    for (auto value : micros)
+        tokens.add(juce::String(value, 3));
+
+    std::cout << tokens.joinIntoString(" ") << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::ConsoleApplication app;
+    app.addHelpCommand("--help|-h",
+                       "Usage: aic-benchmark <command> [options]\n"
+                       "All commands take --backend=stub to run without the SDK, see "
+                       "DEVELOPMENT.md",
+                       true);
+
+    app.addCommand({"warmup",
+                    "warmup [--model=<index>] [--sample-rate=<hz>] [--block-size=<samples>] "
+                    "[--blocks=<count>] [--warmup-ms=<ms>] [--silence]",
+                    "Compares the first blocks after prepareToPlay with and without warm-up",
+                    "Each configuration runs in a fresh process. --silence warms up with silence "
+                    "instead of noise.",
+                    runWarmUpBenchmark});
+
+    app.addCommand({"memory",
+                    "memory [--model=<index>] [--sample-rate=<hz>] [--block-size=<samples>]",
+                    "Measures the resident memory of each model",
+                    "Each model runs in a fresh process. Use the instance column to size machines "
+                    "for multiple streams.",
+                    runMemoryBenchmark});
+
+    app.addCommand({"metering",
+                    "metering [--sample-rate=<hz>] [--block-size=<samples>] [--blocks=<count>]",
+                    "Measures the cost of the level metering",
+                    "Fails if metering takes more than 1 % of the block duration.",
+                    runMeteringBenchmark});
+
+    // Used by the commands above to measure in a child process
+    app.addCommand({"measure", "", "", "", runMeasurement});
+    app.addCommand({"measure-memory", "", "", "", runMemoryMeasurement});
+
+    return app.findAndRunCommand(argc, argv);
+}
@@ -0,0 +1,874 @@
+#include "MemoryUtils.h"
+#include "PluginProcessor.h"
+#include "ToolHelpers.h"
+#include "VadEvents.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <limits>
+#include <vector>
+
+namespace
+{
+
+struct Options
+{
+    juce::File       corpus;
+    std::vector<int> models;
+    int              numWorkers{juce::SystemStats::getNumCpus()};
+    double           blockMs{10.0};
+    double           frameMs{20.0};
+    double           speechThresholdDb{-40.0};
+    juce::File       csvFile;
+    juce::File       jsonFile;
+
+    // The quality bar of the use case, the cheapest model meeting it is recommended
+    double minSiSdr{std::numeric_limits<double>::lowest()};
+    double minVadAgreement{0.0};
+    double maxDelayMs{std::numeric_limits<double>::max()};
+
+    aic::tools::BackendOptions backend;
+};
+
+double getDoubleOption(const juce::ArgumentList& args, const juce::String& option,
+                       double defaultValue)
+{
+    return args.containsOption(option) ? args.getValueForOption(option).getDoubleValue()
+                                       : defaultValue;
+}
+
+Options parseOptions(const juce::ArgumentList& args)
+{
+    Options options;
+
+    if (!args.containsOption("--corpus"))
+        juce::ConsoleApplication::fail("Missing --corpus=<directory>");
+
+    options.corpus     = args.getExistingFolderForOption("--corpus");
+    options.numWorkers = aic::tools::getIntOption(args, "--workers", options.numWorkers);
+    options.blockMs    = getDoubleOption(args, "--block-ms", options.blockMs);
+    options.frameMs    = getDoubleOption(args, "--frame-ms", options.frameMs);
+    options.speechThresholdDb =
+        getDoubleOption(args, "--speech-threshold-db", options.speechThresholdDb);
+    options.minSiSdr        = getDoubleOption(args, "--min-si-sdr", options.minSiSdr);
+    options.minVadAgreement = getDoubleOption(args, "--min-vad-agreement", 0.0);
+    options.maxDelayMs      = getDoubleOption(args, "--max-delay-ms", options.maxDelayMs);
+    options.backend         = aic::tools::parseBackendOptions(args);
+
+    if (args.containsOption("--csv"))
+        options.csvFile = args.getFileForOption("--csv");
+
+    if (args.containsOption("--json"))
+        options.jsonFile = args.getFileForOption("--json");
+
+    const auto numModels = AicDemoAudioProcessor::getModelChoices().size();
+    if (args.containsOption("--models"))
+    {
+        for (const auto& token :
+             juce::StringArray::fromTokens(args.getValueForOption("--models"), ",", ""))
+        {
+            auto index = token.trim().getIntValue();
+            if (!juce::isPositiveAndBelow(index, numModels))
+                juce::ConsoleApplication::fail("Invalid model index " + token);
+
+            options.models.push_back(index);
+        }
+    }
+    else
+    {
+        for (int index = 0; index < numModels; ++index)
+            options.models.push_back(index);
+    }
+
+    if (options.numWorkers < 1 || options.blockMs <= 0.0 || options.frameMs <= 0.0)
+        juce::ConsoleApplication::fail("Workers, block and frame length must be positive");
+
+    return options;
+}
+
+/**
+ * @brief A noisy file of the corpus and its clean reference of the same name.
+ */
+struct Pair
+{
+    juce::File noisy;
+    juce::File clean;
+};
+
+std::vector<Pair> findPairs(const juce::File& corpus)
+{
+    auto noisyDirectory = corpus.getChildFile("noisy");
+    auto cleanDirectory = corpus.getChildFile("clean");
+
+    auto files = noisyDirectory.findChildFiles(juce::File::findFiles, false,
+                                               "*.wav;*.flac;*.aif;*.aiff");
+    files.sort();
+
+    std::vector<Pair> pairs;
+    for (const auto& noisy : files)
+    {
+        auto clean = cleanDirectory.getChildFile(noisy.getFileName());
+        if (!clean.existsAsFile())
+            juce::ConsoleApplication::fail("No clean reference for " + noisy.getFullPathName());
+
+        pairs.push_back({noisy, clean});
+    }
+
+    if (pairs.empty())
+        juce::ConsoleApplication::fail("No audio files in " + noisyDirectory.getFullPathName());
+
+    return pairs;
+}
+
+/**
+ * @brief Reads a file mixed down to mono.
+ *
+ * @return An error message, empty on success
+ */
+juce::String readMono(const juce::File& file, std::vector<float>& samples, double& sampleRate)
+{
+    juce::AudioFormatManager formats;
+    formats.registerBasicFormats();
+
+    std::unique_ptr<juce::AudioFormatReader> reader(formats.createReaderFor(file));
+    if (reader == nullptr)
+        return "Cannot read " + file.getFullPathName();
+
+    const auto length      = static_cast<int>(reader->lengthInSamples);
+    const auto numChannels = static_cast<int>(reader->numChannels);
+
+    juce::AudioBuffer<float> buffer(numChannels, length);
+    reader->read(&buffer, 0, length, 0, true, true);
+
+    samples.assign(static_cast<size_t>(length), 0.0f);
+    for (int ch = 0; ch < numChannels; ++ch)
+        for (int i = 0; i < length; ++i)
+            samples[static_cast<size_t>(i)] += buffer.getSample(ch, i) / numChannels;
+
+    sampleRate = reader->sampleRate;
+    return {};
+}
+
+/**
+ * @brief Scale-invariant signal-to-distortion ratio of the estimate in dB.
+ */
+double computeSiSdr(const std::vector<float>& estimate, const std::vector<float>& reference)
+{
+    const auto length = static_cast<double>(reference.size());
+
+    double estimateMean  = 0.0;
+    double referenceMean = 0.0;
+    for (size_t i = 0; i < reference.size(); ++i)
+    {
+        estimateMean += estimate[i];
+        referenceMean += reference[i];
+    }
+
+    estimateMean /= length;
+    referenceMean /= length;
+
+    double dot            = 0.0;
+    double referencePower = 0.0;
+    for (size_t i = 0; i < reference.size(); ++i)
+    {
+        dot += (estimate[i] - estimateMean) * (reference[i] - referenceMean);
+        referencePower += (reference[i] - referenceMean) * (reference[i] - referenceMean);
+    }
+
+    // The part of the estimate explained by the reference, the rest is distortion
+    const auto scale       = referencePower > 0.0 ? dot / referencePower : 0.0;
+    double     targetPower = 0.0;
+    double     errorPower  = 0.0;
+    for (size_t i = 0; i < reference.size(); ++i)
+    {
+        auto target = scale * (reference[i] - referenceMean);
+        auto error  = (estimate[i] - estimateMean) - target;
+        targetPower += target * target;
+        errorPower += error * error;
+    }
+
+    constexpr double epsilon = 1.0e-12;
+    return 10.0 * std::log10((targetPower + epsilon) / (errorPower + epsilon));
+}
+
+/**
+ * @brief Marks the frames in which the clean reference has speech, by their energy.
+ */
+std::vector<bool> findSpeechFrames(const std::vector<float>& reference, int frameSize,
+                                   double thresholdDb)
+{
+    const auto numFrames = static_cast<int>(reference.size()) / frameSize;
+
+    std::vector<double> energies(static_cast<size_t>(numFrames), 0.0);
+    for (int frame = 0; frame < numFrames; ++frame)
+    {
+        for (int i = 0; i < frameSize; ++i)
+        {
+            auto sample = reference[static_cast<size_t>(frame * frameSize + i)];
+            energies[static_cast<size_t>(frame)] += sample * sample;
+        }
+    }
+
+    auto maxEnergy = energies.empty() ? 0.0 : *std::max_element(energies.begin(), energies.end());
+    auto threshold = maxEnergy * std::pow(10.0, thresholdDb / 10.0);
+
+    std::vector<bool> speech(static_cast<size_t>(numFrames));
+    for (size_t frame = 0; frame < speech.size(); ++frame)
+        speech[frame] = energies[frame] > threshold && energies[frame] > 0.0;
+
+    return speech;
+}
+
+/**
+ * @brief Mean SNR of the speech frames in dB, each limited to [-10, 35] dB as usual.
+ */
+double computeSegmentalSnr(const std::vector<float>& estimate, const std::vector<float>& reference,
+                           int frameSize, const std::vector<bool>& speechFrames)
+{
+    constexpr double epsilon = 1.0e-12;
+
+    double sum       = 0.0;
+    int    numFrames = 0;
+
+    for (size_t frame = 0; frame < speechFrames.size(); ++frame)
+    {
+        if (!speechFrames[frame])
+            continue;
+
+        double signalPower = 0.0;
+        double noisePower  = 0.0;
+        for (size_t i = frame * static_cast<size_t>(frameSize);
+             i < (frame + 1) * static_cast<size_t>(frameSize); ++i)
+        {
+            auto error = reference[i] - estimate[i];
+            signalPower += reference[i] * reference[i];
+            noisePower += error * error;
+        }
+
+        sum += juce::jlimit(-10.0, 35.0,
+                            10.0 * std::log10((signalPower + epsilon) / (noisePower + epsilon)));
+        ++numFrames;
+    }
+
+    return numFrames > 0 ? sum / numFrames : 0.0;
+}
+
+/**
+ * @brief Share of the frames in which the VAD of the model agrees with the reference.
+ */
+double computeVadAgreement(const std::vector<aic::vad::Event>& events, std::int64_t numSamples,
+                           int frameSize, const std::vector<bool>& speechFrames)
+{
+    if (speechFrames.empty())
+        return 0.0;
+
+    auto segments = aic::vad::toSegments(events, numSamples);
+
+    size_t segment  = 0;
+    int    numEqual = 0;
+    for (size_t frame = 0; frame < speechFrames.size(); ++frame)
+    {
+        // The result in the middle of the frame
+        auto position = static_cast<std::int64_t>(frame * static_cast<size_t>(frameSize) +
+                                                  static_cast<size_t>(frameSize / 2));
+        while (segment + 1 < segments.size() && segments[segment].end <= position)
+            ++segment;
+
+        auto speech = !segments.empty() && segments[segment].speech;
+        if (speech == speechFrames[frame])
+            ++numEqual;
+    }
+
+    return static_cast<double>(numEqual) / static_cast<double>(speechFrames.size());
+}
+
+/**
+ * @brief The measurements of one model on one file of the corpus.
+ */
+struct Result
+{
+    int          modelIndex{0};
+    juce::String file;
+    juce::String error;
+    double       seconds{0.0};
+    double       processingSeconds{0.0};
+    double       delayMs{0.0};
+    double       siSdr{0.0};
+    double       noisySiSdr{0.0};
+    double       segmentalSnr{0.0};
+    double       vadAgreement{0.0};
+};
+
+/**
+ * @brief The output of a model for a noisy file, aligned to the input.
+ */
+struct Rendering
+{
+    juce::String                 error;
+    std::vector<float>           enhanced;
+    std::vector<aic::vad::Event> vadEvents;
+    int                          latency{0};
+    double                       processingSeconds{0.0};
+};
+
+Rendering render(int modelIndex, const std::vector<float>& noisy, double sampleRate,
+                 const Options& options, const juce::ArgumentList& args)
+{
+    Rendering rendering;
+
+    AicDemoAudioProcessor processor(aic::tools::createBackend(options.backend));
+    aic::tools::setNumChannels(processor, 1);
+    aic::tools::applyParameterOptions(processor, args);
+    aic::tools::setModel(processor, modelIndex);
+    processor.setCollectingVadEvents(true);
+
+    const auto blockSize = juce::jmax(1, juce::roundToInt(sampleRate * options.blockMs / 1000.0));
+    rendering.error      = aic::tools::tryPrepareProcessor(processor, sampleRate, blockSize);
+    if (rendering.error.isNotEmpty())
+        return rendering;
+
+    // The output is shifted by the latency, pushed out with silence and aligned to the input
+    const auto length  = static_cast<int>(noisy.size());
+    const auto latency = processor.getLatencySamples();
+    const auto total   = length + latency;
+
+    auto&                    enhanced  = rendering.enhanced;
+    auto&                    vadEvents = rendering.vadEvents;
+    juce::AudioBuffer<float> buffer(1, blockSize);
+    juce::MidiBuffer         midi;
+    juce::int64              ticks = 0;
+
+    enhanced.assign(static_cast<size_t>(length), 0.0f);
+
+    for (int position = 0; position < total; position += blockSize)
+    {
+        const auto numSamples = juce::jmin(blockSize, total - position);
+        buffer.setSize(1, numSamples, false, false, true);
+
+        for (int i = 0; i < numSamples; ++i)
+            buffer.setSample(0, i,
+                             position + i < length ? noisy[static_cast<size_t>(position + i)]
+                                                   : 0.0f);
+
+        auto start = juce::Time::getHighResolutionTicks();
+        processor.processBlock(buffer, midi);
+        ticks += juce::Time::getHighResolutionTicks() - start;
+
+        // Positions are already compensated by the latency
+        processor.collectVadEvents(vadEvents);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            auto output = position + i - latency;
+            if (juce::isPositiveAndBelow(output, length))
+                enhanced[static_cast<size_t>(output)] = buffer.getSample(0, i);
+        }
+    }
+
+    processor.releaseResources();
+
+    rendering.latency           = latency;
+    rendering.processingSeconds = juce::Time::highResolutionTicksToSeconds(ticks);
+    return rendering;
+}
+
+/**
+ * @brief Measures the quality of a model on a file, the processing time is measured separately.
+ */
+Result runJob(int modelIndex, const Pair& pair, const Options& options,
+              const juce::ArgumentList& args)
+{
+    Result result;
+    result.modelIndex = modelIndex;
+    result.file       = pair.noisy.getFileName();
+
+    std::vector<float> noisy;
+    std::vector<float> clean;
+    double             sampleRate      = 0.0;
+    double             cleanSampleRate = 0.0;
+
+    result.error = readMono(pair.noisy, noisy, sampleRate);
+    if (result.error.isEmpty())
+        result.error = readMono(pair.clean, clean, cleanSampleRate);
+
+    if (result.error.isEmpty() && !juce::approximatelyEqual(sampleRate, cleanSampleRate))
+        result.error = "The sample rates of the noisy and the clean file differ";
+
+    if (result.error.isNotEmpty())
+        return result;
+
+    const auto length = static_cast<int>(juce::jmin(noisy.size(), clean.size()));
+    noisy.resize(static_cast<size_t>(length));
+    clean.resize(static_cast<size_t>(length));
+
+    auto rendering = render(modelIndex, noisy, sampleRate, options, args);
+    result.error   = rendering.error;
+    if (result.error.isNotEmpty())
+        return result;
+
+    const auto frameSize = juce::jmax(1, juce::roundToInt(sampleRate * options.frameMs / 1000.0));
+    const auto speechFrames = findSpeechFrames(clean, frameSize, options.speechThresholdDb);
+
+    result.seconds      = length / sampleRate;
+    result.delayMs      = rendering.latency * 1000.0 / sampleRate;
+    result.siSdr        = computeSiSdr(rendering.enhanced, clean);
+    result.noisySiSdr   = computeSiSdr(noisy, clean);
+    result.segmentalSnr = computeSegmentalSnr(rendering.enhanced, clean, frameSize, speechFrames);
+    result.vadAgreement =
+        computeVadAgreement(rendering.vadEvents, length, frameSize, speechFrames);
+    return result;
+}
+
+/**
+ * @brief Times a model on a file while nothing else of the comparison runs.
+ *
+ * The parallel jobs compete for the CPU and the processor threads, so the real-time factor is
+ * measured in a serial pass of its own and comparable to a single stream.
+ */
+void measureProcessingTime(Result& result, const Pair& pair, const Options& options,
+                           const juce::ArgumentList& args)
+{
+    std::vector<float> noisy;
+    double             sampleRate = 0.0;
+
+    if (auto error = readMono(pair.noisy, noisy, sampleRate); error.isNotEmpty())
+    {
+        result.error = error;
+        return;
+    }
+
+    // The same length as in the quality job
+    noisy.resize(static_cast<size_t>(juce::roundToInt(result.seconds * sampleRate)));
+
+    auto rendering = render(result.modelIndex, noisy, sampleRate, options, args);
+    if (rendering.error.isNotEmpty())
+        result.error = rendering.error;
+    else
+        result.processingSeconds = rendering.processingSeconds;
+}
+
+/**
+ * @brief The results of a model averaged over the corpus.
+ */
+struct Summary
+{
+    int    modelIndex{0};
+    int    numFiles{0};
+    int    numFailed{0};
+    double realTimeFactor{0.0};
+    double peakMemoryBytes{-1.0};
+    double delayMs{0.0};
+    double siSdr{0.0};
+    double siSdrImprovement{0.0};
+    double segmentalSnr{0.0};
+    double vadAgreement{0.0};
+    bool   pareto{false};
+
+    bool meets(const Options& options) const
+    {
+        return numFiles > 0 && siSdr >= options.minSiSdr &&
+               vadAgreement >= options.minVadAgreement && delayMs <= options.maxDelayMs;
+    }
+};
+
+std::vector<Summary> summarise(const std::vector<Result>& results, const Options& options)
+{
+    std::vector<Summary> summaries;
+
+    for (auto modelIndex : options.models)
+    {
+        Summary summary;
+        summary.modelIndex = modelIndex;
+
+        double seconds           = 0.0;
+        double processingSeconds = 0.0;
+
+        for (const auto& result : results)
+        {
+            if (result.modelIndex != modelIndex)
+                continue;
+
+            if (result.error.isNotEmpty())
+            {
+                ++summary.numFailed;
+                continue;
+            }
+
+            ++summary.numFiles;
+            seconds += result.seconds;
+            processingSeconds += result.processingSeconds;
+            summary.delayMs = juce::jmax(summary.delayMs, result.delayMs);
+            summary.siSdr += result.siSdr;
+            summary.siSdrImprovement += result.siSdr - result.noisySiSdr;
+            summary.segmentalSnr += result.segmentalSnr;
+            summary.vadAgreement += result.vadAgreement;
+        }
+
+        if (summary.numFiles > 0)
+        {
+            summary.realTimeFactor = seconds > 0.0 ? processingSeconds / seconds : 0.0;
+            summary.siSdr /= summary.numFiles;
+            summary.siSdrImprovement /= summary.numFiles;
+            summary.segmentalSnr /= summary.numFiles;
+            summary.vadAgreement /= summary.numFiles;
+        }
+
+        summaries.push_back(summary);
+    }
+
+    // Cost against quality: no other model is at least as cheap and as good, and better in one
+    for (auto& summary : summaries)
+    {
+        if (summary.numFiles == 0)
+            continue;
+
+        summary.pareto = std::none_of(
+            summaries.begin(), summaries.end(),
+            [&](const Summary& other)
+            {
+                return other.numFiles > 0 && other.realTimeFactor <= summary.realTimeFactor &&
+                       other.siSdr >= summary.siSdr &&
+                       (other.realTimeFactor < summary.realTimeFactor ||
+                        other.siSdr > summary.siSdr);
+            });
+    }
+
+    return summaries;
+}
+
+/**
+ * @brief The model of the lowest real-time factor meeting the quality bar, nullptr if none.
+ */
+const Summary* findCheapest(const std::vector<Summary>& summaries, const Options& options)
+{
+    const Summary* cheapest = nullptr;
+    for (const auto& summary : summaries)
+        if (summary.meets(options) &&
+            (cheapest == nullptr || summary.realTimeFactor < cheapest->realTimeFactor))
+            cheapest = &summary;
+
+    return cheapest;
+}
+
+/**
+ * @brief Measures the peak memory of a model in a fresh process, see runMemoryMeasurement().
+ *
+ * @return The growth of the peak resident memory in bytes, -1 if unknown
+ */
+double measurePeakMemory(int modelIndex, double sampleRate, int blockSize, const Options& options)
+{
+    juce::StringArray command;
+    command.add(juce::File::getSpecialLocation(juce::File::currentExecutableFile)
+                    .getFullPathName());
+    command.add("measure-memory");
+    command.add("--model=" + juce::String(modelIndex));
+    command.add("--sample-rate=" + juce::String(juce::roundToInt(sampleRate)));
+    command.add("--block-size=" + juce::String(blockSize));
+    command.addArray(aic::tools::toArguments(options.backend));
+
+    juce::ChildProcess child;
+    if (!child.start(command))
+        return -1.0;
+
+    auto output = child.readAllProcessOutput();
+    if (child.getExitCode() != 0)
+        return -1.0;
+
+    return output.trim().getDoubleValue();
+}
+
+juce::String toMegabytes(double bytes)
+{
+    if (bytes < 0.0)
+        return "n/a";
+
+    return juce::String(bytes / (1024.0 * 1024.0), 1);
+}
+
+void writeCsv(const juce::File& file, const std::vector<Result>& results)
+{
+    const auto models = AicDemoAudioProcessor::getModelChoices();
+
+    juce::String text = "model,file,duration_s,rtf,output_delay_ms,si_sdr_db,noisy_si_sdr_db,"
+                        "seg_snr_db,vad_agreement,error\n";
+
+    for (const auto& result : results)
+    {
+        juce::StringArray fields{
+            models[result.modelIndex],
+            result.file.quoted(),
+            juce::String(result.seconds, 3),
+            juce::String(result.seconds > 0.0 ? result.processingSeconds / result.seconds : 0.0,
+                         4),
+            juce::String(result.delayMs, 2),
+            juce::String(result.siSdr, 2),
+            juce::String(result.noisySiSdr, 2),
+            juce::String(result.segmentalSnr, 2),
+            juce::String(result.vadAgreement, 4),
+            result.error.quoted()};
+        text << fields.joinIntoString(",") << "\n";
+    }
+
+    if (!file.replaceWithText(text))
+        juce::ConsoleApplication::fail("Failed to write " + file.getFullPathName());
+}
+
+void writeJson(const juce::File& file, const std::vector<Result>& results,
+               const std::vector<Summary>& summaries, const Summary* cheapest)
+{
+    const auto models = AicDemoAudioProcessor::getModelChoices();
+
+    juce::Array<juce::var> fileResults;
+    for (const auto& result : results)
+    {
+        auto object = std::make_unique<juce::DynamicObject>();
+        object->setProperty("model", models[result.modelIndex]);
+        object->setProperty("file", result.file);
+        object->setProperty("duration_s", result.seconds);
+        object->setProperty("rtf", result.seconds > 0.0
+                                       ? result.processingSeconds / result.seconds
+                                       : 0.0);
+        object->setProperty("output_delay_ms", result.delayMs);
+        object->setProperty("si_sdr_db", result.siSdr);
+        object->setProperty("noisy_si_sdr_db", result.noisySiSdr);
+        object->setProperty("seg_snr_db", result.segmentalSnr);
+        object->setProperty("vad_agreement", result.vadAgreement);
+        if (result.error.isNotEmpty())
+            object->setProperty("error", result.error);
+
+        fileResults.add(juce::var(object.release()));
+    }
+
+    juce::Array<juce::var> modelSummaries;
+    for (const auto& summary : summaries)
+    {
+        auto object = std::make_unique<juce::DynamicObject>();
+        object->setProperty("model", models[summary.modelIndex]);
+        object->setProperty("files", summary.numFiles);
+        object->setProperty("failed", summary.numFailed);
+        object->setProperty("rtf", summary.realTimeFactor);
+        object->setProperty("peak_memory_bytes", summary.peakMemoryBytes);
+        object->setProperty("output_delay_ms", summary.delayMs);
+        object->setProperty("si_sdr_db", summary.siSdr);
+        object->setProperty("si_sdr_improvement_db", summary.siSdrImprovement);
+        object->setProperty("seg_snr_db", summary.segmentalSnr);
+        object->setProperty("vad_agreement", summary.vadAgreement);
+        object->setProperty("pareto", summary.pareto);
+
+        modelSummaries.add(juce::var(object.release()));
+    }
+
+    auto report = std::make_unique<juce::DynamicObject>();
+    report->setProperty("files", fileResults);
+    report->setProperty("models", modelSummaries);
+    report->setProperty("recommended",
+                        cheapest != nullptr ? juce::var(models[cheapest->modelIndex])
+                                            : juce::var());
+
+    if (!file.replaceWithText(juce::JSON::toString(juce::var(report.release()))))
+        juce::ConsoleApplication::fail("Failed to write " + file.getFullPathName());
+}
+
+void printSummary(const std::vector<Summary>& summaries, const Summary* cheapest)
+{
+    const auto models = AicDemoAudioProcessor::getModelChoices();
+
+    std::cout << std::endl
+              << juce::String("model").paddedRight(' ', 12)
+              << juce::String("rtf").paddedLeft(' ', 8)
+              << juce::String("peak MB").paddedLeft(' ', 10)
+              << juce::String("delay ms").paddedLeft(' ', 10)
+              << juce::String("SI-SDR").paddedLeft(' ', 9)
+              << juce::String("SI-SDRi").paddedLeft(' ', 9)
+              << juce::String("segSNR").paddedLeft(' ', 9)
+              << juce::String("VAD agr").paddedLeft(' ', 9)
+              << juce::String("pareto").paddedLeft(' ', 8) << std::endl;
+
+    for (const auto& summary : summaries)
+    {
+        std::cout << models[summary.modelIndex].paddedRight(' ', 12);
+
+        if (summary.numFiles == 0)
+        {
+            std::cout << "  all " << summary.numFailed << " files failed" << std::endl;
+            continue;
+        }
+
+        std::cout << juce::String(summary.realTimeFactor, 4).paddedLeft(' ', 8)
+                  << toMegabytes(summary.peakMemoryBytes).paddedLeft(' ', 10)
+                  << juce::String(summary.delayMs, 1).paddedLeft(' ', 10)
+                  << juce::String(summary.siSdr, 2).paddedLeft(' ', 9)
+                  << juce::String(summary.siSdrImprovement, 2).paddedLeft(' ', 9)
+                  << juce::String(summary.segmentalSnr, 2).paddedLeft(' ', 9)
+                  << juce::String(summary.vadAgreement * 100.0, 1).paddedLeft(' ', 8) << "%"
+                  << juce::String(summary.pareto ? "*" : "").paddedLeft(' ', 8) << std::endl;
+    }
+
+    std::cout << std::endl
+              << "rtf: processing time per second of audio, SI-SDR and segSNR in dB, SI-SDRi: "
+                 "improvement over the noisy input"
+              << std::endl
+              << "pareto: no other model has a lower real-time factor and a higher SI-SDR"
+              << std::endl
+              << std::endl;
+
+    if (cheapest != nullptr)
+        std::cout << "Cheapest model meeting the quality bar: " << models[cheapest->modelIndex]
+                  << std::endl;
+    else
+        std::cout << "No model meets the quality bar" << std::endl;
+}
+
+void runComparison(const juce::ArgumentList& args)
+{
+    auto options = parseOptions(args);
+    auto pairs   = findPairs(options.corpus);
+
+    // Memory is measured per model in a fresh process, before the parallel runs share this one
+    std::vector<double> peakMemoryBytes;
+    {
+        std::vector<float> samples;
+        double             sampleRate = 48000.0;
+        if (readMono(pairs.front().noisy, samples, sampleRate).isNotEmpty())
+            sampleRate = 48000.0;
+
+        auto blockSize = juce::jmax(1, juce::roundToInt(sampleRate * options.blockMs / 1000.0));
+        for (auto modelIndex : options.models)
+            peakMemoryBytes.push_back(
+                measurePeakMemory(modelIndex, sampleRate, blockSize, options));
+    }
+
+    // One job per model and file, each writes only its own result
+    std::vector<Result> results(options.models.size() * pairs.size());
+    {
+        juce::ThreadPool workers(juce::ThreadPoolOptions{}
+                                     .withThreadName("aic compare worker")
+                                     .withNumberOfThreads(options.numWorkers));
+
+        for (size_t model = 0; model < options.models.size(); ++model)
+            for (size_t pair = 0; pair < pairs.size(); ++pair)
+                workers.addJob(
+                    [&, model, pair]()
+                    {
+                        results[model * pairs.size() + pair] =
+                            runJob(options.models[model], pairs[pair], options, args);
+                    });
+
+        std::cout << options.models.size() << " models, " << pairs.size() << " files, "
+                  << options.numWorkers << " workers" << std::endl;
+
+        const auto numJobs = static_cast<int>(results.size());
+        for (int remaining = numJobs; remaining > 0; remaining = workers.getNumJobs())
+        {
+            std::cout << "\r" << numJobs - remaining << "/" << numJobs << " done" << std::flush;
+            juce::Thread::sleep(500);
+        }
+
+        std::cout << "\r" << numJobs << "/" << numJobs << " done" << std::endl;
+    }
+
+    // The processing time one job after the other, on this thread only
+    for (size_t model = 0; model < options.models.size(); ++model)
+    {
+        for (size_t pair = 0; pair < pairs.size(); ++pair)
+        {
+            auto& result = results[model * pairs.size() + pair];
+            if (result.error.isEmpty())
+                measureProcessingTime(result, pairs[pair], options, args);
+
+            std::cout << "\rTiming " << model * pairs.size() + pair + 1 << "/" << results.size()
+                      << std::flush;
+        }
+    }
+
+    std::cout << std::endl;
+
+    for (const auto& result : results)
+        if (result.error.isNotEmpty())
+            std::cerr << AicDemoAudioProcessor::getModelChoices()[result.modelIndex] << ", "
+                      << result.file << ": " << result.error << std::endl;
+
+    auto summaries = summarise(results, options);
+    for (size_t index = 0; index < summaries.size(); ++index)
+        summaries[index].peakMemoryBytes = peakMemoryBytes[index];
+
+    const auto* cheapest = findCheapest(summaries, options);
+
+    printSummary(summaries, cheapest);
+
+    if (options.csvFile != juce::File())
+        writeCsv(options.csvFile, results);
+
+    if (options.jsonFile != juce::File())
+        writeJson(options.jsonFile, results, summaries, cheapest);
+}
+
+/**
+ * @brief Prints the growth of the peak resident memory while a model processes 5 s of noise.
+ */
+void runMemoryMeasurement(const juce::ArgumentList& args)
+{
+    const auto modelIndex = aic::tools::getIntOption(args, "--model", 0);
+    const auto sampleRate = aic::tools::getIntOption(args, "--sample-rate", 48000);
+    const auto blockSize  = aic::tools::getIntOption(args, "--block-size", 480);
+
+    auto residentBytes = aic::memory::getResidentMemoryBytes();
+
+    AicDemoAudioProcessor processor(
+        aic::tools::createBackend(aic::tools::parseBackendOptions(args)));
+    aic::tools::setNumChannels(processor, 1);
+    aic::tools::setModel(processor, modelIndex);
+    aic::tools::prepareProcessor(processor, sampleRate, blockSize);
+
+    juce::AudioBuffer<float> buffer(1, blockSize);
+    juce::MidiBuffer         midi;
+    juce::Random             random(1);
+
+    for (int block = 0; block < 5 * sampleRate / blockSize; ++block)
+    {
+        for (int i = 0; i < blockSize; ++i)
+            buffer.setSample(0, i, (random.nextFloat() * 2.0f - 1.0f) * 0.1f);
+
+        processor.processBlock(buffer, midi);
+    }
+
+    auto peakBytes = aic::memory::getPeakResidentMemoryBytes();
+    std::cout << (residentBytes < 0 || peakBytes < 0 ? -1 : peakBytes - residentBytes)
+              << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::ConsoleApplication app;
+    app.addHelpCommand("--help|-h",
+                       "Usage: aic-compare --corpus=<directory> [options]\n"
+                       "Takes --backend=stub to run without the SDK, see DEVELOPMENT.md",
+                       true);
+
+    app.addDefaultCommand(
+        {"",
+         "--corpus=<directory> [--models=<index,...>] [--workers=<count>] [--block-ms=<ms>] "
+         "[--frame-ms=<ms>] [--speech-threshold-db=<dB>] [--csv=<file>] [--json=<file>] "
+         "[--min-si-sdr=<dB>] [--min-vad-agreement=<share>] [--max-delay-ms=<ms>] "
+         "[--<parameter id>=<value>]",
+         "Compares the models on a corpus of noisy and clean recordings",
+         "The corpus has the subfolders noisy and clean with files of the same names. Every "
+         "model processes every noisy file, one job per model and file on --workers threads. "
+         "The real-time factor is measured afterwards, one job after the other. "
+         "Reports the real-time factor, peak memory, output delay, SI-SDR, segmental SNR and the "
+         "agreement of the VAD with the speech frames of the clean file, and recommends the "
+         "model of the lowest real-time factor meeting the --min/--max options.",
+         runComparison});
+
+    // Used by the command above to measure in a child process
+    app.addCommand({"measure-memory", "", "", "", runMemoryMeasurement});
+
+    return app.findAndRunCommand(argc, argv);
+}
@@ -0,0 +1,452 @@
+#include "PluginProcessor.h"
+#include "ToolHelpers.h"
+#include "VadEvents.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+
+enum class SampleFormat
+{
+    Float32,
+    Int16
+};
+
+struct Options
+{
+    int          inputFd{STDIN_FILENO};
+    int          outputFd{STDOUT_FILENO};
+    double       sampleRate{48000.0};
+    int          numChannels{1};
+    int          chunkFrames{480};
+    SampleFormat format{SampleFormat::Float32};
+    bool         planar{false};
+    bool         compensateLatency{true};
+    juce::File   vadSegmentsFile;
+    bool         speechOnly{false};
+    int          speechPaddingMs{200};
+
+    int getBytesPerSample() const
+    {
+        return format == SampleFormat::Float32 ? 4 : 2;
+    }
+};
+
+Options parseOptions(const juce::ArgumentList& args)
+{
+    Options options;
+    options.inputFd     = aic::tools::getIntOption(args, "--input-fd", options.inputFd);
+    options.outputFd    = aic::tools::getIntOption(args, "--output-fd", options.outputFd);
+    options.sampleRate  = aic::tools::getIntOption(args, "--sample-rate", 48000);
+    options.numChannels = aic::tools::getIntOption(args, "--channels", options.numChannels);
+    options.planar      = args.containsOption("--planar");
+    options.speechOnly  = args.containsOption("--speech-only");
+    options.speechPaddingMs =
+        aic::tools::getIntOption(args, "--speech-padding-ms", options.speechPaddingMs);
+
+    if (args.containsOption("--vad-segments"))
+        options.vadSegmentsFile = args.getFileForOption("--vad-segments");
+
+    // Dropping the latency at the start would break the chunk framing of planar streams
+    options.compensateLatency =
+        !options.planar && !args.containsOption("--no-latency-compensation");
+
+    // 10 ms by default, the window length of the models
+    options.chunkFrames =
+        aic::tools::getIntOption(args, "--chunk", juce::roundToInt(options.sampleRate / 100.0));
+
+    auto format = args.containsOption("--format") ? args.getValueForOption("--format") : "f32";
+    if (format == "s16")
+        options.format = SampleFormat::Int16;
+    else if (format != "f32")
+        juce::ConsoleApplication::fail("Unsupported format " + format + ", use f32 or s16");
+
+    if (options.numChannels < 1 || options.numChannels > 2)
+        juce::ConsoleApplication::fail("Only mono and stereo streams are supported");
+
+    if (options.chunkFrames < 1)
+        juce::ConsoleApplication::fail("The chunk size must be at least one frame");
+
+    return options;
+}
+
+/**
+ * @brief Raises the capacity of a pipe, fewer and larger transfers between the stages.
+ */
+void enlargePipe(int fd)
+{
+#ifdef F_SETPIPE_SZ
+    // Fails for anything that is not a pipe, which is fine
+    fcntl(fd, F_SETPIPE_SZ, 1 << 20);
+#else
+    juce::ignoreUnused(fd);
+#endif
+}
+
+/**
+ * @brief Reads into the vectors until they are full or the input ends.
+ *
+ * @return The number of bytes read
+ */
+size_t readAll(int fd, std::vector<iovec> vectors)
+{
+    size_t total = 0;
+    auto*  next  = vectors.data();
+    auto   count = static_cast<int>(vectors.size());
+
+    while (count > 0)
+    {
+        auto result = readv(fd, next, count);
+        if (result < 0 && errno == EINTR)
+            continue;
+        if (result < 0)
+            juce::ConsoleApplication::fail(juce::String("Read failed: ") + std::strerror(errno));
+        if (result == 0)
+            break;
+
+        total += static_cast<size_t>(result);
+
+        // Skip the filled vectors and continue in the partially filled one
+        auto remaining = static_cast<size_t>(result);
+        while (count > 0 && remaining >= next->iov_len)
+        {
+            remaining -= next->iov_len;
+            ++next;
+            --count;
+        }
+        if (count > 0)
+        {
+            next->iov_base = static_cast<char*>(next->iov_base) + remaining;
+            next->iov_len -= remaining;
+        }
+    }
+
+    return total;
+}
+
+void writeAll(int fd, std::vector<iovec> vectors)
+{
+    auto* next  = vectors.data();
+    auto  count = static_cast<int>(vectors.size());
+
+    while (count > 0)
+    {
+        auto result = writev(fd, next, count);
+        if (result < 0 && errno == EINTR)
+            continue;
+        if (result < 0)
+            juce::ConsoleApplication::fail(juce::String("Write failed: ") + std::strerror(errno));
+
+        auto remaining = static_cast<size_t>(result);
+        while (count > 0 && remaining >= next->iov_len)
+        {
+            remaining -= next->iov_len;
+            ++next;
+            --count;
+        }
+        if (count > 0)
+        {
+            next->iov_base = static_cast<char*>(next->iov_base) + remaining;
+            next->iov_len -= remaining;
+        }
+    }
+}
+
+/**
+ * @brief Moves samples between the wire format and the processing buffer.
+ *
+ * Planar float streams are read and written in place through readv/writev, one vector per
+ * channel, everything else goes through a staging buffer.
+ */
+class StreamCodec
+{
+  public:
+    explicit StreamCodec(const Options& options)
+        : m_options(options),
+          m_staging(static_cast<size_t>(options.chunkFrames * options.numChannels *
+                                        options.getBytesPerSample()))
+    {
+    }
+
+    /**
+     * @brief Reads the next chunk into the buffer.
+     *
+     * @return The number of frames read, 0 at the end of the input
+     */
+    int read(juce::AudioBuffer<float>& buffer)
+    {
+        const auto numChannels    = m_options.numChannels;
+        const auto bytesPerSample = static_cast<size_t>(m_options.getBytesPerSample());
+        const auto chunkBytes     = static_cast<size_t>(m_options.chunkFrames) * bytesPerSample;
+
+        std::vector<iovec> vectors;
+        if (isZeroCopy())
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+                vectors.push_back({buffer.getWritePointer(ch), chunkBytes});
+        }
+        else
+        {
+            vectors.push_back({m_staging.data(), m_staging.size()});
+        }
+
+        auto numBytes      = readAll(m_options.inputFd, vectors);
+        auto bytesPerFrame = bytesPerSample * static_cast<size_t>(numChannels);
+        auto numFrames     = static_cast<int>(numBytes / bytesPerFrame);
+
+        if (numFrames == 0)
+            return 0;
+
+        if (m_options.planar && numFrames < m_options.chunkFrames)
+            regroupShortPlanarChunk(buffer, numFrames);
+        else if (!isZeroCopy())
+            decode(buffer, numFrames);
+
+        return numFrames;
+    }
+
+    /**
+     * @brief Writes the frames [startFrame, endFrame) of the buffer.
+     */
+    void write(const juce::AudioBuffer<float>& buffer, int startFrame, int endFrame)
+    {
+        const auto numFrames = endFrame - startFrame;
+        if (numFrames <= 0)
+            return;
+
+        const auto numChannels    = m_options.numChannels;
+        const auto bytesPerSample = static_cast<size_t>(m_options.getBytesPerSample());
+        const auto channelBytes   = static_cast<size_t>(numFrames) * bytesPerSample;
+
+        std::vector<iovec> vectors;
+        if (isZeroCopy())
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+                vectors.push_back(
+                    {const_cast<float*>(buffer.getReadPointer(ch, startFrame)), channelBytes});
+        }
+        else
+        {
+            encode(buffer, startFrame, numFrames);
+            vectors.push_back({m_staging.data(), channelBytes * static_cast<size_t>(numChannels)});
+        }
+
+        writeAll(m_options.outputFd, vectors);
+    }
+
+  private:
+    bool isZeroCopy() const
+    {
+        return m_options.planar && m_options.format == SampleFormat::Float32;
+    }
+
+    void decode(juce::AudioBuffer<float>& buffer, int numFrames)
+    {
+        const auto bytesPerSample = m_options.getBytesPerSample();
+
+        for (int ch = 0; ch < m_options.numChannels; ++ch)
+        {
+            // Planar 16 bit chunks hold one channel after the other, interleaved frames one
+            // sample of every channel after the other
+            auto* source = m_options.planar
+                               ? m_staging.data() + ch * m_options.chunkFrames * bytesPerSample
+                               : m_staging.data() + ch * bytesPerSample;
+            auto  stride =
+                m_options.planar ? bytesPerSample : bytesPerSample * m_options.numChannels;
+
+            if (m_options.format == SampleFormat::Int16)
+                juce::AudioDataConverters::convertInt16LEToFloat(source, buffer.getWritePointer(ch),
+                                                                 numFrames, stride);
+            else
+                juce::AudioDataConverters::convertFloat32LEToFloat(
+                    source, buffer.getWritePointer(ch), numFrames, stride);
+        }
+    }
+
+    void encode(const juce::AudioBuffer<float>& buffer, int startFrame, int numFrames)
+    {
+        const auto bytesPerSample = m_options.getBytesPerSample();
+
+        for (int ch = 0; ch < m_options.numChannels; ++ch)
+        {
+            // Planar output is written back to back without gaps, also for a short last chunk
+            auto* dest   = m_options.planar ? m_staging.data() + ch * numFrames * bytesPerSample
+                                            : m_staging.data() + ch * bytesPerSample;
+            auto  stride =
+                m_options.planar ? bytesPerSample : bytesPerSample * m_options.numChannels;
+
+            if (m_options.format == SampleFormat::Int16)
+                juce::AudioDataConverters::convertFloatToInt16LE(
+                    buffer.getReadPointer(ch, startFrame), dest, numFrames, stride);
+            else
+                juce::AudioDataConverters::convertFloatToFloat32LE(
+                    buffer.getReadPointer(ch, startFrame), dest, numFrames, stride);
+        }
+    }
+
+    /**
+     * @brief Sorts the channels of a final, shorter planar chunk.
+     *
+     * The read filled the chunk-sized channel slots back to back, so the channels of a shorter
+     * chunk straddle the slot boundaries. Only happens once at the end of a stream.
+     */
+    void regroupShortPlanarChunk(juce::AudioBuffer<float>& buffer, int numFrames)
+    {
+        const auto numChannels = m_options.numChannels;
+        const auto chunkFrames = m_options.chunkFrames;
+
+        // Gather the samples in stream order
+        std::vector<float> samples(static_cast<size_t>(numFrames * numChannels));
+        for (int i = 0; i < numFrames * numChannels; ++i)
+        {
+            auto& sample = samples[static_cast<size_t>(i)];
+            if (m_options.format == SampleFormat::Float32)
+                sample = buffer.getSample(i / chunkFrames, i % chunkFrames);
+            else
+                juce::AudioDataConverters::convertInt16LEToFloat(m_staging.data() + 2 * i, &sample,
+                                                                 1);
+        }
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            buffer.copyFrom(ch, 0, samples.data() + ch * numFrames, numFrames);
+    }
+
+    const Options&    m_options;
+    std::vector<char> m_staging;
+};
+
+/**
+ * @brief Writes the speech segments of the stream, as CSV for .csv files and JSON otherwise.
+ */
+void writeVadSegments(const Options& options, const std::vector<aic::vad::Event>& events,
+                      juce::int64 numFrames)
+{
+    auto segments = aic::vad::toSegments(events, numFrames);
+    if (options.speechOnly)
+    {
+        auto padding = juce::roundToInt(options.sampleRate * options.speechPaddingMs / 1000.0);
+        segments     = aic::vad::toSpeechRegions(segments, padding, numFrames);
+    }
+
+    auto text = options.vadSegmentsFile.hasFileExtension("csv")
+                    ? aic::vad::toCsv(segments, options.sampleRate)
+                    : aic::vad::toJson(segments, options.sampleRate);
+
+    if (!options.vadSegmentsFile.replaceWithText(text))
+        juce::ConsoleApplication::fail("Failed to write " +
+                                       options.vadSegmentsFile.getFullPathName());
+}
+
+void runPipe(const juce::ArgumentList& args)
+{
+    auto options = parseOptions(args);
+
+    enlargePipe(options.inputFd);
+    enlargePipe(options.outputFd);
+
+    AicDemoAudioProcessor processor(
+        aic::tools::createBackend(aic::tools::parseBackendOptions(args)));
+    if (!aic::tools::setNumChannels(processor, options.numChannels))
+        juce::ConsoleApplication::fail("Unsupported number of channels");
+
+    aic::tools::applyParameterOptions(processor, args);
+    processor.setCollectingVadEvents(true);
+    aic::tools::prepareProcessor(processor, options.sampleRate, options.chunkFrames);
+
+    // The output is shifted by the latency, drop it at the start and flush it at the end
+    const auto latency = options.compensateLatency ? processor.getLatencySamples() : 0;
+    auto       skip    = latency;
+    auto       flush   = latency;
+
+    // stdout carries the audio, status goes to stderr
+    auto modelIndex = static_cast<int>(processor.state.getRawParameterValue("model")->load());
+    std::cerr << "aic-pipe: " << AicDemoAudioProcessor::getModelChoices()[modelIndex] << ", "
+              << options.numChannels << " ch, " << options.sampleRate << " Hz, "
+              << options.chunkFrames << " frames per chunk, latency "
+              << processor.getLatencySamples() << " samples" << std::endl;
+
+    juce::AudioBuffer<float> buffer(options.numChannels, options.chunkFrames);
+    juce::MidiBuffer         midi;
+    StreamCodec              codec(options);
+
+    const bool                   recordVad = options.vadSegmentsFile != juce::File();
+    std::vector<aic::vad::Event> vadEvents;
+    juce::int64                  inputFrames = 0;
+
+    for (;;)
+    {
+        auto numFrames = codec.read(buffer);
+
+        if (numFrames == 0)
+        {
+            if (flush <= 0)
+                break;
+
+            // Push silence through the model until the delayed end of the input came out
+            numFrames = juce::jmin(flush, options.chunkFrames);
+            buffer.clear();
+            flush -= numFrames;
+        }
+        else
+        {
+            inputFrames += numFrames;
+        }
+
+        // Only the last chunk can be shorter, the buffer keeps its allocation
+        buffer.setSize(options.numChannels, numFrames, true, false, true);
+        processor.processBlock(buffer, midi);
+
+        // Drained every chunk, the queue of the processor holds a few thousand events
+        if (recordVad)
+            processor.collectVadEvents(vadEvents);
+
+        auto start = juce::jmin(skip, numFrames);
+        skip -= start;
+        codec.write(buffer, start, numFrames);
+
+        buffer.setSize(options.numChannels, options.chunkFrames, true, false, true);
+    }
+
+    processor.releaseResources();
+
+    if (recordVad)
+        writeVadSegments(options, vadEvents, inputFrames);
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::ConsoleApplication app;
+    app.addHelpCommand("--help|-h",
+                       "Usage: aic-pipe [options] < input.pcm > output.pcm\n"
+                       "Enhances raw PCM from stdin and writes it to stdout.",
+                       true);
+
+    app.addDefaultCommand(
+        {"",
+         "[--format=f32|s16] [--channels=1|2] [--sample-rate=<hz>] [--planar] "
+         "[--chunk=<frames>] [--input-fd=<fd>] [--output-fd=<fd>] [--no-latency-compensation] "
+         "[--vad-segments=<file>] [--speech-only] [--speech-padding-ms=<ms>] "
+         "[--backend=sdk|stub] [--<parameter id>=<value>...]",
+         "Enhances raw little-endian PCM",
+         "Interleaved by default. Planar streams carry one channel after the other per chunk. "
+         "Plugin parameters are set by their id, e.g. --model=2 --enhancement=0.8. Interleaved "
+         "output is shifted back by the plugin latency unless --no-latency-compensation is "
+         "given. --vad-segments writes the speech and non-speech segments of the input as JSON, "
+         "or CSV for .csv files, --speech-only keeps only speech padded by "
+         "--speech-padding-ms.",
+         runPipe});
+
+    return app.findAndRunCommand(argc, argv);
+}
@@ -0,0 +1,624 @@
+#include "PluginProcessor.h"
+#include "RealtimeSafety.h"
+#include "ToolHelpers.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <new>
+
+#if JUCE_LINUX && !AIC_HAS_REALTIME_SANITIZER
+#include <cstdarg>
+#include <cstdio>
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+#if !AIC_REALTIME_CHECKS
+#error "aic-rtcheck needs the plugin sources compiled with AIC_REALTIME_CHECKS=1"
+#endif
+
+namespace
+{
+
+constexpr int maxReportedViolations = 20;
+
+std::atomic<int>         violationCount{0};
+std::atomic<const char*> currentStep{"starting"};
+
+/**
+ * @brief Prints the call with the stack of the audio thread, called by the interceptors.
+ */
+void reportViolation(const char* call)
+{
+    // Printing allocates and writes, which must not be reported again
+    const aic::realtime::ScopedAllowance allowance("reporting a violation");
+
+    if (++violationCount > maxReportedViolations)
+        return;
+
+    std::cerr << "Real-time violation: " << call << " in processBlock while "
+              << currentStep.load() << std::endl
+              << juce::SystemStats::getStackBacktrace() << std::endl;
+}
+
+void checkCall(const char* call)
+{
+    if (aic::realtime::ScopedContext::isActive())
+        reportViolation(call);
+}
+
+#if !AIC_HAS_REALTIME_SANITIZER
+void* allocate(std::size_t size, const char* call)
+{
+    checkCall(call);
+
+    // Reported once, not again by the malloc interceptor
+    const aic::realtime::ScopedAllowance allowance("reported as operator new");
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void deallocate(void* pointer, const char* call)
+{
+    if (pointer == nullptr)
+        return;
+
+    checkCall(call);
+
+    const aic::realtime::ScopedAllowance allowance("reported as operator delete");
+    std::free(pointer);
+}
+#endif
+
+} // namespace
+
+//==============================================================================
+// With RealtimeSanitizer the sanitizer intercepts all of these itself
+#if !AIC_HAS_REALTIME_SANITIZER
+
+void* operator new(std::size_t size)
+{
+    if (auto* pointer = allocate(size, "operator new"))
+        return pointer;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    if (auto* pointer = allocate(size, "operator new[]"))
+        return pointer;
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept
+{
+    deallocate(pointer, "operator delete");
+}
+
+void operator delete[](void* pointer) noexcept
+{
+    deallocate(pointer, "operator delete[]");
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+    deallocate(pointer, "operator delete");
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept
+{
+    deallocate(pointer, "operator delete[]");
+}
+
+#endif
+
+//==============================================================================
+// The C library calls are only intercepted on Linux, by symbols of the executable that take
+// precedence over the ones of glibc
+#if JUCE_LINUX && !AIC_HAS_REALTIME_SANITIZER
+
+namespace
+{
+
+/**
+ * @brief The function of glibc a symbol of the executable replaces, looked up on first use.
+ */
+template <typename Function>
+Function* getNext(std::atomic<void*>& cache, const char* name)
+{
+    auto* function = cache.load(std::memory_order_relaxed);
+    if (function == nullptr)
+    {
+        function = dlsym(RTLD_NEXT, name);
+        cache.store(function, std::memory_order_relaxed);
+    }
+
+    return reinterpret_cast<Function*>(function);
+}
+
+std::atomic<void*> nextMutexLock{nullptr};
+std::atomic<void*> nextCondWait{nullptr};
+std::atomic<void*> nextCondTimedWait{nullptr};
+std::atomic<void*> nextRwlockRdlock{nullptr};
+std::atomic<void*> nextRwlockWrlock{nullptr};
+std::atomic<void*> nextSemWait{nullptr};
+std::atomic<void*> nextNanosleep{nullptr};
+std::atomic<void*> nextClockNanosleep{nullptr};
+std::atomic<void*> nextUsleep{nullptr};
+std::atomic<void*> nextOpen{nullptr};
+std::atomic<void*> nextClose{nullptr};
+std::atomic<void*> nextRead{nullptr};
+std::atomic<void*> nextWrite{nullptr};
+std::atomic<void*> nextFopen{nullptr};
+
+} // namespace
+
+extern "C"
+{
+    // The allocator of glibc, dlsym itself may allocate
+    void* __libc_malloc(size_t size);
+    void* __libc_calloc(size_t count, size_t size);
+    void* __libc_realloc(void* pointer, size_t size);
+    void  __libc_free(void* pointer);
+    void* __libc_memalign(size_t alignment, size_t size);
+
+    void* malloc(size_t size) __THROW
+    {
+        checkCall("malloc");
+        return __libc_malloc(size);
+    }
+
+    void* calloc(size_t count, size_t size) __THROW
+    {
+        checkCall("calloc");
+        return __libc_calloc(count, size);
+    }
+
+    void* realloc(void* pointer, size_t size) __THROW
+    {
+        checkCall("realloc");
+        return __libc_realloc(pointer, size);
+    }
+
+    void free(void* pointer) __THROW
+    {
+        if (pointer != nullptr)
+            checkCall("free");
+
+        __libc_free(pointer);
+    }
+
+    void* memalign(size_t alignment, size_t size) __THROW
+    {
+        checkCall("memalign");
+        return __libc_memalign(alignment, size);
+    }
+
+    void* aligned_alloc(size_t alignment, size_t size) __THROW
+    {
+        checkCall("aligned_alloc");
+        return __libc_memalign(alignment, size);
+    }
+
+    int posix_memalign(void** pointer, size_t alignment, size_t size) __THROW
+    {
+        checkCall("posix_memalign");
+
+        if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0)
+            return EINVAL;
+
+        auto* memory = __libc_memalign(alignment, size);
+        if (memory == nullptr)
+            return ENOMEM;
+
+        *pointer = memory;
+        return 0;
+    }
+
+    int pthread_mutex_lock(pthread_mutex_t* mutex) __THROWNL
+    {
+        checkCall("pthread_mutex_lock");
+        return getNext<int(pthread_mutex_t*)>(nextMutexLock, "pthread_mutex_lock")(mutex);
+    }
+
+    int pthread_cond_wait(pthread_cond_t* cond, pthread_mutex_t* mutex)
+    {
+        checkCall("pthread_cond_wait");
+        return getNext<int(pthread_cond_t*, pthread_mutex_t*)>(nextCondWait,
+                                                                 "pthread_cond_wait")(cond, mutex);
+    }
+
+    int pthread_cond_timedwait(pthread_cond_t* cond, pthread_mutex_t* mutex,
+                               const struct timespec* time)
+    {
+        checkCall("pthread_cond_timedwait");
+        return getNext<int(pthread_cond_t*, pthread_mutex_t*, const struct timespec*)>(
+            nextCondTimedWait, "pthread_cond_timedwait")(cond, mutex, time);
+    }
+
+    int pthread_rwlock_rdlock(pthread_rwlock_t* lock) __THROWNL
+    {
+        checkCall("pthread_rwlock_rdlock");
+        return getNext<int(pthread_rwlock_t*)>(nextRwlockRdlock, "pthread_rwlock_rdlock")(lock);
+    }
+
+    int pthread_rwlock_wrlock(pthread_rwlock_t* lock) __THROWNL
+    {
+        checkCall("pthread_rwlock_wrlock");
+        return getNext<int(pthread_rwlock_t*)>(nextRwlockWrlock, "pthread_rwlock_wrlock")(lock);
+    }
+
+    int sem_wait(sem_t* semaphore)
+    {
+        checkCall("sem_wait");
+        return getNext<int(sem_t*)>(nextSemWait, "sem_wait")(semaphore);
+    }
+
+    int nanosleep(const struct timespec* duration, struct timespec* remaining)
+    {
+        checkCall("nanosleep");
+        return getNext<int(const struct timespec*, struct timespec*)>(nextNanosleep, "nanosleep")(
+            duration, remaining);
+    }
+
+    int clock_nanosleep(clockid_t clock, int flags, const struct timespec* duration,
+                        struct timespec* remaining)
+    {
+        checkCall("clock_nanosleep");
+        return getNext<int(clockid_t, int, const struct timespec*, struct timespec*)>(
+            nextClockNanosleep, "clock_nanosleep")(clock, flags, duration, remaining);
+    }
+
+    int usleep(useconds_t microseconds)
+    {
+        checkCall("usleep");
+        return getNext<int(useconds_t)>(nextUsleep, "usleep")(microseconds);
+    }
+
+    int open(const char* path, int flags, ...)
+    {
+        checkCall("open");
+
+        mode_t mode = 0;
+        if ((flags & O_CREAT) != 0)
+        {
+            va_list args;
+            va_start(args, flags);
+            mode = static_cast<mode_t>(va_arg(args, int));
+            va_end(args);
+        }
+
+        return getNext<int(const char*, int, ...)>(nextOpen, "open")(path, flags, mode);
+    }
+
+    int close(int fd)
+    {
+        checkCall("close");
+        return getNext<int(int)>(nextClose, "close")(fd);
+    }
+
+    ssize_t read(int fd, void* data, size_t size)
+    {
+        checkCall("read");
+        return getNext<ssize_t(int, void*, size_t)>(nextRead, "read")(fd, data, size);
+    }
+
+    ssize_t write(int fd, const void* data, size_t size)
+    {
+        checkCall("write");
+        return getNext<ssize_t(int, const void*, size_t)>(nextWrite, "write")(fd, data, size);
+    }
+
+    FILE* fopen(const char* path, const char* mode)
+    {
+        checkCall("fopen");
+        return getNext<FILE*(const char*, const char*)>(nextFopen, "fopen")(path, mode);
+    }
+}
+
+#endif
+
+//==============================================================================
+namespace
+{
+
+struct Options
+{
+    double sampleRate{48000.0};
+    int    blockSize{480};
+    int    numChannels{2};
+    int    seed{1};
+
+    aic::tools::BackendOptions backend;
+};
+
+Options parseOptions(const juce::ArgumentList& args)
+{
+    Options options;
+    options.sampleRate  = aic::tools::getIntOption(args, "--sample-rate", 48000);
+    options.blockSize   = aic::tools::getIntOption(args, "--block-size", options.blockSize);
+    options.numChannels = aic::tools::getIntOption(args, "--channels", options.numChannels);
+    options.seed        = aic::tools::getIntOption(args, "--seed", options.seed);
+    options.backend     = aic::tools::parseBackendOptions(args);
+    return options;
+}
+
+/**
+ * @brief Calls processBlock with noise in real time, like the audio callback of a host.
+ */
+class AudioThread : public aic::tools::AudioThread
+{
+  public:
+    AudioThread(AicDemoAudioProcessor& processor, const Options& options)
+        : aic::tools::AudioThread("aic-rtcheck audio", processor, options.numChannels,
+                                  options.blockSize, true),
+          m_random(options.seed)
+    {
+    }
+
+    ~AudioThread() override
+    {
+        stopThread(1000);
+    }
+
+    /**
+     * @brief Repeats the noise every loopBlocks blocks, 0 plays new noise.
+     *
+     * Every other pass continues with new noise halfway, so runs of render cache hits end in
+     * misses.
+     */
+    void setLooping(int loopBlocks)
+    {
+        m_loopBlocks.store(loopBlocks);
+    }
+
+  private:
+    bool beginBlock(juce::AudioBuffer<float>& buffer) override
+    {
+        if (auto loopBlocks = m_loopBlocks.load(); loopBlocks > 0)
+        {
+            auto index   = m_loopBlock % loopBlocks;
+            auto changed = (m_loopBlock / loopBlocks) % 2 == 1 && index >= loopBlocks / 2;
+            m_random.setSeed(changed ? -1 - m_loopBlock : index);
+            ++m_loopBlock;
+        }
+        else
+        {
+            m_loopBlock = 0;
+        }
+
+        // Roughly -20 dBFS noise
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                buffer.setSample(ch, i, (m_random.nextFloat() * 2.0f - 1.0f) * 0.1f);
+
+        return true;
+    }
+
+    juce::Random     m_random;
+    juce::int64      m_loopBlock{0};
+    std::atomic<int> m_loopBlocks{0};
+};
+
+/**
+ * @brief Waits until the loader published a model for the current parameters.
+ */
+void waitForModel(AicDemoAudioProcessor& processor, const AudioThread& audio)
+{
+    const auto timeout = juce::Time::getMillisecondCounter() + 60000;
+    while (!processor.modelChanged())
+    {
+        if (juce::Time::getMillisecondCounter() > timeout)
+            juce::ConsoleApplication::fail("The model did not get ready in time");
+
+        juce::Thread::sleep(1);
+    }
+
+    // Adopted by the audio thread within a block, a few more run on it
+    audio.waitForBlocks(20);
+    processor.acknowledgeModelChanged();
+}
+
+void runStep(const char* step, const std::function<void()>& body)
+{
+    const auto violationsBefore = violationCount.load();
+
+    currentStep.store(step);
+    body();
+
+    auto violations = violationCount.load() - violationsBefore;
+    std::cout << juce::String(step).paddedRight(' ', 28)
+              << (violations == 0 ? juce::String("ok") : juce::String(violations) + " violations")
+              << std::endl;
+}
+
+/**
+ * @brief Switches models, changes parameters, toggles bypass and restores the state while the
+ * audio thread runs, failing if processBlock was not real-time safe.
+ */
+/**
+ * @brief Listens to the processor like a host, which counts the latency changes.
+ *
+ * JUCE only takes the listener lock of the processor when a listener is attached, without one the
+ * host notifications of processBlock would not be checked.
+ */
+class HostListener : public juce::AudioProcessorListener
+{
+  public:
+    void audioProcessorParameterChanged(juce::AudioProcessor* processor, int parameterIndex,
+                                        float newValue) override
+    {
+        juce::ignoreUnused(processor, parameterIndex, newValue);
+    }
+
+    void audioProcessorChanged(juce::AudioProcessor* processor,
+                               const ChangeDetails&  details) override
+    {
+        juce::ignoreUnused(processor);
+
+        if (details.latencyChanged)
+            ++m_numLatencyChanges;
+    }
+
+    int getNumLatencyChanges() const
+    {
+        return m_numLatencyChanges.load();
+    }
+
+  private:
+    std::atomic<int> m_numLatencyChanges{0};
+};
+
+void runSession(const juce::ArgumentList& args)
+{
+    auto options = parseOptions(args);
+
+    // Parameter lookups by ID neither allocate nor lock, the plugin reports them itself
+    aic::realtime::callHandler.store(&reportViolation);
+
+    AicDemoAudioProcessor processor(aic::tools::createBackend(options.backend));
+    if (!aic::tools::setNumChannels(processor, options.numChannels))
+        juce::ConsoleApplication::fail("Unsupported number of channels");
+
+    aic::tools::prepareProcessor(processor, options.sampleRate, options.blockSize);
+    processor.acknowledgeModelChanged();
+
+    juce::MemoryBlock initialState;
+    processor.getStateInformation(initialState);
+
+    HostListener host;
+    processor.addListener(&host);
+
+    std::cout << processor.getName() << ", " << options.sampleRate << " Hz, "
+              << options.blockSize << " samples per block, " << options.numChannels
+              << " channels" << std::endl
+              << std::endl;
+
+    AudioThread audio(processor, options);
+    audio.startThread(juce::Thread::Priority::highest);
+
+    juce::Random random(options.seed);
+
+    runStep("processing", [&] { audio.waitForBlocks(50); });
+
+    runStep("switching models",
+            [&]
+            {
+                auto models  = AicDemoAudioProcessor::getModelChoices();
+                auto current =
+                    static_cast<int>(processor.state.getRawParameterValue("model")->load());
+
+                // Every model once, ending with the one the session started with
+                for (int step = 1; step <= models.size(); ++step)
+                {
+                    auto index = (current + step) % models.size();
+                    if (index == current && step != models.size())
+                        continue;
+
+                    aic::tools::setModel(processor, index);
+                    waitForModel(processor, audio);
+                }
+            });
+
+    runStep("changing parameters",
+            [&]
+            {
+                for (int round = 0; round < 20; ++round)
+                {
+                    for (auto* parameter : processor.getParameters())
+                    {
+                        auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter);
+                        if (ranged == nullptr || ranged->paramID == "model" ||
+                            ranged->paramID == "vad_state")
+                            continue;
+
+                        ranged->setValueNotifyingHost(random.nextFloat());
+                    }
+
+                    audio.waitForBlocks(5);
+                }
+            });
+
+    runStep("toggling bypass",
+            [&]
+            {
+                for (int round = 0; round < 50; ++round)
+                {
+                    aic::tools::setParameter(processor, "bypass", static_cast<float>(round % 2));
+                    audio.waitForBlocks(1);
+                }
+            });
+
+    runStep("changing the latency",
+            [&]
+            {
+                for (int round = 0; round < 20; ++round)
+                {
+                    auto parameter = round % 2 == 0 ? "limiter" : "anticipative";
+                    aic::tools::setParameter(processor, parameter,
+                                             static_cast<float>((round / 2 + 1) % 2));
+                    audio.waitForBlocks(5);
+                }
+            });
+
+    runStep("render cache hits and misses",
+            [&]
+            {
+                aic::tools::setParameter(processor, "bypass", 0.0f);
+                aic::tools::setParameter(processor, "rendercache", 1.0f);
+                audio.setLooping(50);
+                audio.waitForBlocks(500);
+                audio.setLooping(0);
+                aic::tools::setParameter(processor, "rendercache", 0.0f);
+            });
+
+    runStep("restoring state",
+            [&]
+            {
+                for (int round = 0; round < 5; ++round)
+                {
+                    processor.setStateInformation(initialState.getData(),
+                                                  static_cast<int>(initialState.getSize()));
+                    audio.waitForBlocks(20);
+                }
+            });
+
+    audio.stopThread(1000);
+    processor.removeListener(&host);
+
+    std::cout << std::endl
+              << audio.getNumBlocks() << " blocks processed, " << host.getNumLatencyChanges()
+              << " latency changes reported" << std::endl;
+
+    if (violationCount.load() > 0)
+        juce::ConsoleApplication::fail(juce::String(violationCount.load()) +
+                                       " real-time violations in processBlock");
+
+    std::cout << "No real-time violations" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::ConsoleApplication app;
+    app.addHelpCommand("--help|-h",
+                       "Usage: aic-rtcheck [--sample-rate=<hz>] [--block-size=<samples>] "
+                       "[--channels=<1|2>] [--seed=<n>] [--backend=stub]\n"
+                       "Runs a scripted session and fails on allocations, locks and blocking "
+                       "system calls in processBlock, see DEVELOPMENT.md",
+                       true);
+    app.addDefaultCommand({"", "", "", "", runSession});
+
+    return app.findAndRunCommand(argc, argv);
+}
@@ -0,0 +1,1015 @@
+#include "PluginProcessor.h"
+#include "ToolHelpers.h"
+
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+
+volatile std::sig_atomic_t stopRequested = 0;
+
+struct Options
+{
+    juce::String socketPath{"/tmp/aic-server.sock"};
+    int          numWorkers{1};
+    int          maxQueueMs{200};
+    int          maxIdleProcessors{8};
+    int          statsIntervalSeconds{10};
+
+    // Header lines of the formats prepared before the first client, the default format if none
+    juce::StringArray prewarmHeaders{""};
+
+    aic::tools::BackendOptions backend;
+};
+
+Options parseOptions(const juce::ArgumentList& args)
+{
+    Options options;
+    if (args.containsOption("--socket"))
+        options.socketPath = args.getValueForOption("--socket");
+
+    options.numWorkers =
+        aic::tools::getIntOption(args, "--workers", juce::SystemStats::getNumCpus());
+    options.maxQueueMs = aic::tools::getIntOption(args, "--max-queue-ms", options.maxQueueMs);
+    options.maxIdleProcessors =
+        aic::tools::getIntOption(args, "--max-idle", options.maxIdleProcessors);
+    options.statsIntervalSeconds =
+        aic::tools::getIntOption(args, "--stats-interval", options.statsIntervalSeconds);
+
+    if (args.containsOption("--prewarm"))
+        options.prewarmHeaders =
+            juce::StringArray::fromTokens(args.getValueForOption("--prewarm"), ";", "");
+
+    if (options.numWorkers < 1)
+        juce::ConsoleApplication::fail("At least one worker is needed");
+
+    if (options.maxQueueMs < 1)
+        juce::ConsoleApplication::fail("The queue must hold at least one millisecond");
+
+    options.backend = aic::tools::parseBackendOptions(args);
+    return options;
+}
+
+/**
+ * @brief Audio format and plugin parameters a client asks for in its header line.
+ *
+ * The header is a single line of space separated key=value pairs, e.g.
+ * "sample-rate=16000 channels=1 format=s16 model=2 enhancement=0.8". Keys that are not part of
+ * the format are plugin parameter ids. The model and the band split decide which model instance
+ * the processor builds, they are part of the format.
+ */
+struct StreamFormat
+{
+    double                sampleRate{48000.0};
+    int                   numChannels{1};
+    int                   chunkFrames{480};
+    bool                  int16{false};
+    int                   modelIndex{0};
+    bool                  bandSplit{false};
+    juce::StringPairArray parameters;
+
+    int getBytesPerFrame() const
+    {
+        return (int16 ? 2 : 4) * numChannels;
+    }
+
+    /**
+     * @brief Streams with the same key can share a prepared processor.
+     *
+     * Covers everything the model instance is built for, a pooled processor never has to wait
+     * for the loader.
+     */
+    juce::String getPoolKey() const
+    {
+        return juce::String(modelIndex) + "/" + (bandSplit ? "split" : "full") + "/" +
+               juce::String(juce::roundToInt(sampleRate)) + "/" + juce::String(numChannels) +
+               "/" + juce::String(chunkFrames);
+    }
+};
+
+/**
+ * @return An error message, empty on success
+ */
+juce::String parseHeader(const juce::String& line, StreamFormat& format)
+{
+    bool chunkGiven = false;
+
+    for (const auto& token : juce::StringArray::fromTokens(line, " \t\r", ""))
+    {
+        if (token.isEmpty())
+            continue;
+
+        auto key   = token.upToFirstOccurrenceOf("=", false, false);
+        auto value = token.fromFirstOccurrenceOf("=", false, false);
+
+        if (key == "sample-rate")
+            format.sampleRate = value.getIntValue();
+        else if (key == "channels")
+            format.numChannels = value.getIntValue();
+        else if (key == "model")
+            format.modelIndex = value.getIntValue();
+        else if (key == "bandsplit")
+            format.bandSplit = value.getFloatValue() > 0.5f;
+        else if (key == "chunk")
+        {
+            format.chunkFrames = value.getIntValue();
+            chunkGiven         = true;
+        }
+        else if (key == "format")
+        {
+            if (value != "f32" && value != "s16")
+                return "unsupported format " + value + ", use f32 or s16";
+
+            format.int16 = value == "s16";
+        }
+        else
+        {
+            format.parameters.set(key, value);
+        }
+    }
+
+    // 10 ms by default, the window length of the models
+    if (!chunkGiven)
+        format.chunkFrames = juce::roundToInt(format.sampleRate / 100.0);
+
+    if (format.sampleRate < 8000.0 || format.sampleRate > 192000.0)
+        return "unsupported sample rate";
+
+    if (format.numChannels < 1 || format.numChannels > 2)
+        return "only mono and stereo streams are supported";
+
+    if (format.chunkFrames < 1 || format.chunkFrames > juce::roundToInt(format.sampleRate))
+        return "the chunk must be between one frame and one second";
+
+    if (!juce::isPositiveAndBelow(format.modelIndex,
+                                  AicDemoAudioProcessor::getModelChoices().size()))
+        return "invalid model index";
+
+    return {};
+}
+
+/**
+ * @brief Bytes waiting to be processed or sent, appended at the back and consumed at the front.
+ */
+class ByteQueue
+{
+  public:
+    size_t size() const
+    {
+        return m_data.size() - m_readPosition;
+    }
+
+    const char* data() const
+    {
+        return m_data.data() + m_readPosition;
+    }
+
+    void append(const char* bytes, size_t numBytes)
+    {
+        m_data.insert(m_data.end(), bytes, bytes + numBytes);
+    }
+
+    void consume(size_t numBytes)
+    {
+        m_readPosition += numBytes;
+
+        // Compact once the consumed part dominates, appends stay amortised constant
+        if (m_readPosition == m_data.size())
+        {
+            m_data.clear();
+            m_readPosition = 0;
+        }
+        else if (m_readPosition > m_data.size() / 2)
+        {
+            m_data.erase(m_data.begin(),
+                         m_data.begin() + static_cast<std::ptrdiff_t>(m_readPosition));
+            m_readPosition = 0;
+        }
+    }
+
+  private:
+    std::vector<char> m_data;
+    size_t            m_readPosition{0};
+};
+
+/**
+ * @brief Keeps the prepared processors of finished streams.
+ *
+ * New streams with the same model and audio settings skip license validation, model creation,
+ * initialization and warm-up, which dominate the cost of short streams.
+ */
+class ProcessorPool
+{
+  public:
+    struct Acquired
+    {
+        std::unique_ptr<AicDemoAudioProcessor> processor;
+        bool                                   reused{false};
+        juce::String                           error;
+    };
+
+    ProcessorPool(int maxIdle, const aic::tools::BackendOptions& backend)
+        : m_maxIdle(maxIdle), m_backend(backend)
+    {
+    }
+
+    /**
+     * @brief Returns an idle processor for the format or prepares a new one.
+     *
+     * Blocks while preparing, only called by the workers.
+     */
+    Acquired acquire(const StreamFormat& format)
+    {
+        Acquired result;
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            auto& idle = m_idle[format.getPoolKey()];
+            if (!idle.empty())
+            {
+                result.processor = std::move(idle.back());
+                result.reused    = true;
+                idle.pop_back();
+                --m_numIdle;
+                return result;
+            }
+        }
+
+        result.processor =
+            std::make_unique<AicDemoAudioProcessor>(aic::tools::createBackend(m_backend));
+        if (!aic::tools::setNumChannels(*result.processor, format.numChannels))
+            result.error = "unsupported number of channels";
+        else
+        {
+            aic::tools::setModel(*result.processor, format.modelIndex);
+            aic::tools::setParameter(*result.processor, "bandsplit",
+                                     format.bandSplit ? 1.0f : 0.0f);
+            result.error = aic::tools::tryPrepareProcessor(*result.processor, format.sampleRate,
+                                                           format.chunkFrames);
+        }
+
+        if (result.error.isNotEmpty())
+            result.processor.reset();
+
+        return result;
+    }
+
+    /**
+     * @brief Prepares a processor per format and keeps it idle, before the first client.
+     *
+     * The first stream of each format does not wait for its model to be built, and the license
+     * is checked once up front instead of failing every stream.
+     *
+     * @return An error message, empty on success
+     */
+    juce::String prewarm(const std::vector<StreamFormat>& formats)
+    {
+        for (const auto& format : formats)
+        {
+            auto acquired = acquire(format);
+            if (acquired.error.isNotEmpty())
+                return acquired.error;
+
+            release(format, std::move(acquired.processor));
+        }
+
+        return {};
+    }
+
+    /**
+     * @brief Takes the processor of a finished stream back and resets it for the next one.
+     */
+    void release(const StreamFormat& format, std::unique_ptr<AicDemoAudioProcessor> processor)
+    {
+        if (processor == nullptr)
+            return;
+
+        processor->reset();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        // A full pool destroys the processor with the argument, after the lock is released
+        if (m_numIdle >= m_maxIdle)
+            return;
+
+        m_idle[format.getPoolKey()].push_back(std::move(processor));
+        ++m_numIdle;
+    }
+
+  private:
+    const int                        m_maxIdle;
+    const aic::tools::BackendOptions m_backend;
+
+    std::mutex                                                                  m_mutex;
+    std::map<juce::String, std::vector<std::unique_ptr<AicDemoAudioProcessor>>> m_idle;
+    int                                                                         m_numIdle{0};
+};
+
+/**
+ * @brief One client connection and the audio queued for and from it.
+ */
+struct Stream
+{
+    enum class State
+    {
+        Header,
+        Setup,
+        Running,
+        Failed
+    };
+
+    int                id{0};
+    int                fd{-1};
+    std::atomic<State> state{State::Header};
+    std::string        header;
+    StreamFormat       format;
+    size_t             queueCapacityBytes{0};
+    int                latencySamples{0};
+
+    // Set while a worker job owns the processor and the buffers below
+    std::atomic<bool>                      scheduled{false};
+    std::unique_ptr<AicDemoAudioProcessor> processor;
+    juce::AudioBuffer<float>               buffer;
+    juce::MidiBuffer                       midi;
+    std::vector<char>                      chunk;
+
+    // Guards everything below, shared between the I/O thread and the workers
+    std::mutex  lock;
+    ByteQueue   input;
+    ByteQueue   output;
+    bool        inputClosed{false};
+    bool        disconnected{false};
+    juce::int64 framesProcessed{0};
+    double      processingSeconds{0.0};
+    size_t      maxQueuedBytes{0};
+
+    size_t getChunkBytes() const
+    {
+        return static_cast<size_t>(format.chunkFrames * format.getBytesPerFrame());
+    }
+
+    /**
+     * @brief Whether a full chunk, or the rest of a closed input, waits. Needs the lock.
+     */
+    bool hasChunk() const
+    {
+        return input.size() >= getChunkBytes() ||
+               (inputClosed && input.size() >= static_cast<size_t>(format.getBytesPerFrame()));
+    }
+};
+
+/**
+ * @brief Serves many concurrent streams from one process over a Unix domain socket.
+ *
+ * The I/O thread moves bytes between the sockets and the per-stream queues and never processes
+ * audio. Chunks are processed by a fixed pool of workers, one job per chunk, so streams take turns
+ * in the order their audio arrived. A stream is processed by at most one worker at a time.
+ *
+ * Input beyond the queue capacity is not read from the socket, which pushes back on clients that
+ * send faster than real time and bounds the latency a stream can build up inside the server.
+ */
+class Server
+{
+  public:
+    explicit Server(const Options& options)
+        : m_options(options), m_pool(options.maxIdleProcessors, options.backend),
+          m_workers(juce::ThreadPoolOptions{}
+                        .withThreadName("aic server worker")
+                        .withNumberOfThreads(options.numWorkers))
+    {
+        if (pipe(m_wakePipe) != 0)
+            juce::ConsoleApplication::fail(juce::String("pipe failed: ") + std::strerror(errno));
+
+        setNonBlocking(m_wakePipe[0]);
+        setNonBlocking(m_wakePipe[1]);
+
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+
+        auto path = options.socketPath.toStdString();
+        if (path.size() >= sizeof(address.sun_path))
+            juce::ConsoleApplication::fail("The socket path is too long");
+
+        std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+        // A socket file left behind by a previous server
+        unlink(path.c_str());
+
+        m_listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (m_listenFd < 0 ||
+            bind(m_listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+            listen(m_listenFd, SOMAXCONN) != 0)
+            juce::ConsoleApplication::fail("Failed to listen on " + options.socketPath + ": " +
+                                           std::strerror(errno));
+
+        setNonBlocking(m_listenFd);
+    }
+
+    ~Server()
+    {
+        // Jobs reference the streams and the pool
+        m_workers.removeAllJobs(true, 60000);
+
+        for (auto& stream : m_streams)
+            close(stream->fd);
+
+        close(m_listenFd);
+        close(m_wakePipe[0]);
+        close(m_wakePipe[1]);
+        unlink(m_options.socketPath.toRawUTF8());
+    }
+
+    /**
+     * @brief Serves clients until SIGINT or SIGTERM.
+     */
+    void run()
+    {
+        prewarm();
+
+        std::cerr << "aic-server: listening on " << m_options.socketPath << ", "
+                  << m_options.numWorkers << " workers" << std::endl;
+
+        const auto statsIntervalMs =
+            static_cast<juce::uint32>(juce::jmax(0, m_options.statsIntervalSeconds) * 1000);
+
+        std::vector<pollfd> fds;
+        auto                nextStats = juce::Time::getMillisecondCounter() + statsIntervalMs;
+
+        while (stopRequested == 0)
+        {
+            fds.clear();
+            fds.push_back({m_listenFd, POLLIN, 0});
+            fds.push_back({m_wakePipe[0], POLLIN, 0});
+            for (auto& stream : m_streams)
+                fds.push_back(getPollRequest(*stream));
+
+            if (poll(fds.data(), static_cast<nfds_t>(fds.size()), 1000) < 0 && errno != EINTR)
+                juce::ConsoleApplication::fail(juce::String("poll failed: ") +
+                                               std::strerror(errno));
+
+            if ((fds[1].revents & POLLIN) != 0)
+                drainWakePipe();
+
+            for (size_t i = 0; i < m_streams.size(); ++i)
+            {
+                auto events = fds[i + 2].revents;
+
+                if ((events & POLLIN) != 0)
+                    readFromClient(m_streams[i]);
+                else if ((events & (POLLHUP | POLLERR)) != 0)
+                    disconnect(*m_streams[i]);
+
+                if ((events & POLLOUT) != 0)
+                    writeToClient(*m_streams[i]);
+            }
+
+            if ((fds[0].revents & POLLIN) != 0)
+                acceptClients();
+
+            removeFinishedStreams();
+
+            if (m_options.statsIntervalSeconds > 0 &&
+                juce::Time::getMillisecondCounter() >= nextStats)
+            {
+                for (auto& stream : m_streams)
+                    if (stream->state.load() == Stream::State::Running)
+                        printStats(*stream, false);
+
+                nextStats = juce::Time::getMillisecondCounter() + statsIntervalMs;
+            }
+        }
+
+        std::cerr << "aic-server: shutting down" << std::endl;
+    }
+
+  private:
+    /**
+     * @brief Prepares the processors of the --prewarm formats, fails if the license is invalid.
+     */
+    void prewarm()
+    {
+        std::vector<StreamFormat> formats;
+        for (const auto& header : m_options.prewarmHeaders)
+        {
+            StreamFormat format;
+            auto         error = parseHeader(header, format);
+            if (error.isNotEmpty())
+                juce::ConsoleApplication::fail("Invalid --prewarm format \"" + header +
+                                               "\": " + error);
+
+            formats.push_back(format);
+        }
+
+        auto error = m_pool.prewarm(formats);
+        if (error.isNotEmpty())
+            juce::ConsoleApplication::fail("Failed to prepare a processor: " + error);
+
+        if (static_cast<int>(formats.size()) > m_options.maxIdleProcessors)
+            std::cerr << "aic-server: only " << m_options.maxIdleProcessors
+                      << " prepared processors are kept, see --max-idle" << std::endl;
+    }
+
+    static void setNonBlocking(int fd)
+    {
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    }
+
+    pollfd getPollRequest(Stream& stream)
+    {
+        std::lock_guard<std::mutex> lock(stream.lock);
+
+        // Negative descriptors are ignored, a hung up socket would report POLLHUP forever
+        if (stream.disconnected)
+            return {-1, 0, 0};
+
+        short events = 0;
+        if (!stream.inputClosed && (stream.state.load() == Stream::State::Header ||
+                                    stream.input.size() < stream.queueCapacityBytes))
+            events |= POLLIN;
+
+        if (stream.output.size() > 0)
+            events |= POLLOUT;
+
+        return {stream.fd, events, 0};
+    }
+
+    void acceptClients()
+    {
+        for (;;)
+        {
+            auto fd = accept(m_listenFd, nullptr, nullptr);
+            if (fd < 0)
+                return;
+
+            setNonBlocking(fd);
+
+            auto stream = std::make_shared<Stream>();
+            stream->id  = m_nextStreamId++;
+            stream->fd  = fd;
+            m_streams.push_back(stream);
+        }
+    }
+
+    void readFromClient(const std::shared_ptr<Stream>& stream)
+    {
+        char   bytes[1 << 16];
+        size_t capacity = sizeof(bytes);
+
+        if (stream->state.load() != Stream::State::Header)
+        {
+            std::lock_guard<std::mutex> lock(stream->lock);
+            if (stream->input.size() >= stream->queueCapacityBytes)
+                return;
+
+            capacity = juce::jmin(capacity, stream->queueCapacityBytes - stream->input.size());
+        }
+
+        auto result = read(stream->fd, bytes, capacity);
+        if (result < 0)
+        {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+                disconnect(*stream);
+
+            return;
+        }
+
+        if (result == 0)
+        {
+            std::lock_guard<std::mutex> lock(stream->lock);
+            stream->inputClosed = true;
+
+            // A client that hangs up before its header is complete gets nothing back
+            if (stream->state.load() == Stream::State::Header)
+                stream->state = Stream::State::Failed;
+        }
+        else if (stream->state.load() == Stream::State::Header)
+        {
+            receiveHeader(stream, bytes, static_cast<size_t>(result));
+            return;
+        }
+        else
+        {
+            std::lock_guard<std::mutex> lock(stream->lock);
+            stream->input.append(bytes, static_cast<size_t>(result));
+            stream->maxQueuedBytes = juce::jmax(stream->maxQueuedBytes, stream->input.size());
+        }
+
+        schedule(stream);
+    }
+
+    void receiveHeader(const std::shared_ptr<Stream>& stream, const char* bytes, size_t numBytes)
+    {
+        stream->header.append(bytes, numBytes);
+
+        auto end = stream->header.find('\n');
+        if (end == std::string::npos)
+        {
+            if (stream->header.size() > 4096)
+                failStream(*stream, "the header line is too long");
+
+            return;
+        }
+
+        auto error = parseHeader(juce::String(stream->header.substr(0, end)), stream->format);
+        if (error.isNotEmpty())
+        {
+            failStream(*stream, error);
+            return;
+        }
+
+        const auto& format = stream->format;
+        auto queueFrames = juce::roundToInt(format.sampleRate * m_options.maxQueueMs / 1000.0);
+
+        // Room for at least two chunks, one being filled while the other one waits
+        stream->queueCapacityBytes =
+            static_cast<size_t>(juce::jmax(queueFrames, 2 * format.chunkFrames) *
+                                format.getBytesPerFrame());
+
+        {
+            // Audio that came in the same read as the header
+            std::lock_guard<std::mutex> lock(stream->lock);
+            stream->input.append(stream->header.data() + end + 1, stream->header.size() - end - 1);
+        }
+
+        stream->header.clear();
+        stream->state     = Stream::State::Setup;
+        stream->scheduled = true;
+        m_workers.addJob([this, stream] { setUpStream(stream); });
+    }
+
+    void failStream(Stream& stream, const juce::String& error)
+    {
+        std::cerr << "aic-server: stream " << stream.id << " failed: " << error << std::endl;
+
+        auto line = "error " + error.toStdString() + "\n";
+
+        std::lock_guard<std::mutex> lock(stream.lock);
+        stream.output.append(line.data(), line.size());
+        stream.state = Stream::State::Failed;
+    }
+
+    void disconnect(Stream& stream)
+    {
+        std::lock_guard<std::mutex> lock(stream.lock);
+        stream.disconnected = true;
+    }
+
+    /**
+     * @brief Runs on a worker, prepares or reuses a processor for the format of the stream.
+     */
+    void setUpStream(const std::shared_ptr<Stream>& stream)
+    {
+        auto acquired = m_pool.acquire(stream->format);
+
+        if (acquired.processor != nullptr)
+            acquired.error = applyParameters(*acquired.processor, stream->format.parameters);
+
+        if (acquired.error.isNotEmpty())
+        {
+            m_pool.release(stream->format, std::move(acquired.processor));
+            failStream(*stream, acquired.error);
+            stream->scheduled = false;
+            wake();
+            return;
+        }
+
+        const auto& format = stream->format;
+
+        // The stages and the anticipation take effect on the audio thread, an empty block brings
+        // the reported latency up to date with the parameters of the stream
+        juce::AudioBuffer<float> empty(format.numChannels, 0);
+        acquired.processor->processBlock(empty, stream->midi);
+
+        stream->latencySamples = acquired.processor->getLatencySamples();
+
+        std::cerr << "aic-server: stream " << stream->id << ": "
+                  << AicDemoAudioProcessor::getModelChoices()[format.modelIndex] << ", "
+                  << format.numChannels << " ch, " << format.sampleRate << " Hz, "
+                  << format.chunkFrames << " frames per chunk, "
+                  << (acquired.reused ? "pooled" : "new") << " processor" << std::endl;
+
+        stream->processor = std::move(acquired.processor);
+        stream->buffer.setSize(format.numChannels, format.chunkFrames);
+        stream->chunk.resize(stream->getChunkBytes());
+
+        {
+            auto line = "ok latency=" + std::to_string(stream->latencySamples) +
+                        " chunk=" + std::to_string(format.chunkFrames) + "\n";
+
+            std::lock_guard<std::mutex> lock(stream->lock);
+            stream->output.append(line.data(), line.size());
+        }
+
+        stream->state = Stream::State::Running;
+        continueStream(stream);
+    }
+
+    /**
+     * @brief Resets the parameters a previous stream may have changed, then applies the requested
+     * ones. The model and the band split are part of the pool key and already set.
+     *
+     * @return An error message, empty on success
+     */
+    static juce::String applyParameters(AicDemoAudioProcessor&       processor,
+                                        const juce::StringPairArray& parameters)
+    {
+        for (auto* parameter : processor.getParameters())
+        {
+            auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter);
+            if (ranged != nullptr && ranged->paramID != "model" && ranged->paramID != "bandsplit")
+                ranged->setValueNotifyingHost(ranged->getDefaultValue());
+        }
+
+        for (const auto& key : parameters.getAllKeys())
+            if (!aic::tools::setParameter(processor, key, parameters[key].getFloatValue()))
+                return "unknown parameter " + key;
+
+        return {};
+    }
+
+    /**
+     * @brief Hands a stream with a waiting chunk to the workers, unless a worker already has it.
+     */
+    void schedule(const std::shared_ptr<Stream>& stream)
+    {
+        if (stream->state.load() != Stream::State::Running)
+            return;
+
+        {
+            std::lock_guard<std::mutex> lock(stream->lock);
+            if (!stream->hasChunk())
+                return;
+        }
+
+        if (!stream->scheduled.exchange(true))
+            m_workers.addJob([this, stream] { runStreamJob(stream); });
+    }
+
+    void runStreamJob(const std::shared_ptr<Stream>& stream)
+    {
+        processChunk(*stream);
+        continueStream(stream);
+    }
+
+    /**
+     * @brief Queues the next chunk of a stream behind the chunks of all other streams, or gives up
+     * the stream if there is nothing to do.
+     */
+    void continueStream(const std::shared_ptr<Stream>& stream)
+    {
+        wake();
+
+        auto chunkWaiting = [&stream]
+        {
+            std::lock_guard<std::mutex> lock(stream->lock);
+            return stream->hasChunk();
+        };
+
+        if (chunkWaiting())
+        {
+            m_workers.addJob([this, stream] { runStreamJob(stream); });
+            return;
+        }
+
+        stream->scheduled = false;
+
+        // Input that arrived in between was not scheduled by the I/O thread, the flag was set
+        if (chunkWaiting() && !stream->scheduled.exchange(true))
+            m_workers.addJob([this, stream] { runStreamJob(stream); });
+    }
+
+    void processChunk(Stream& stream)
+    {
+        const auto& format         = stream.format;
+        const auto  bytesPerFrame  = static_cast<size_t>(format.getBytesPerFrame());
+        const auto  bytesPerSample = format.int16 ? 2 : 4;
+        auto&       buffer         = stream.buffer;
+        size_t      numBytes       = 0;
+
+        {
+            std::lock_guard<std::mutex> lock(stream.lock);
+            numBytes = juce::jmin(stream.input.size(), stream.chunk.size());
+            numBytes -= numBytes % bytesPerFrame;
+            std::memcpy(stream.chunk.data(), stream.input.data(), numBytes);
+            stream.input.consume(numBytes);
+        }
+
+        auto numFrames = static_cast<int>(numBytes / bytesPerFrame);
+        if (numFrames == 0)
+            return;
+
+        // Only the last chunk can be shorter, the buffer keeps its allocation
+        buffer.setSize(format.numChannels, numFrames, true, false, true);
+
+        for (int ch = 0; ch < format.numChannels; ++ch)
+        {
+            auto* source = stream.chunk.data() + ch * bytesPerSample;
+            auto  stride = static_cast<int>(bytesPerFrame);
+
+            if (format.int16)
+                juce::AudioDataConverters::convertInt16LEToFloat(source, buffer.getWritePointer(ch),
+                                                                 numFrames, stride);
+            else
+                juce::AudioDataConverters::convertFloat32LEToFloat(
+                    source, buffer.getWritePointer(ch), numFrames, stride);
+        }
+
+        auto start = juce::Time::getHighResolutionTicks();
+        stream.processor->processBlock(buffer, stream.midi);
+        auto end = juce::Time::getHighResolutionTicks();
+
+        for (int ch = 0; ch < format.numChannels; ++ch)
+        {
+            auto* dest   = stream.chunk.data() + ch * bytesPerSample;
+            auto  stride = static_cast<int>(bytesPerFrame);
+
+            if (format.int16)
+                juce::AudioDataConverters::convertFloatToInt16LE(buffer.getReadPointer(ch), dest,
+                                                                 numFrames, stride);
+            else
+                juce::AudioDataConverters::convertFloatToFloat32LE(buffer.getReadPointer(ch),
+                                                                   dest, numFrames, stride);
+        }
+
+        buffer.setSize(format.numChannels, format.chunkFrames, true, false, true);
+
+        std::lock_guard<std::mutex> lock(stream.lock);
+        stream.output.append(stream.chunk.data(), numBytes);
+        stream.framesProcessed += numFrames;
+        stream.processingSeconds += juce::Time::highResolutionTicksToSeconds(end - start);
+    }
+
+    void writeToClient(Stream& stream)
+    {
+        std::lock_guard<std::mutex> lock(stream.lock);
+
+        auto result = write(stream.fd, stream.output.data(), stream.output.size());
+        if (result > 0)
+            stream.output.consume(static_cast<size_t>(result));
+        else if (result < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+            stream.disconnected = true;
+    }
+
+    bool isFinished(Stream& stream)
+    {
+        if (stream.scheduled.load())
+            return false;
+
+        std::lock_guard<std::mutex> lock(stream.lock);
+
+        if (stream.disconnected)
+            return true;
+
+        switch (stream.state.load())
+        {
+            case Stream::State::Failed:
+                return stream.output.size() == 0;
+            case Stream::State::Running:
+                return stream.inputClosed && !stream.hasChunk() && stream.output.size() == 0;
+            case Stream::State::Header:
+            case Stream::State::Setup:
+                break;
+        }
+
+        return false;
+    }
+
+    void removeFinishedStreams()
+    {
+        for (auto it = m_streams.begin(); it != m_streams.end();)
+        {
+            auto stream = *it;
+            if (!isFinished(*stream))
+            {
+                ++it;
+                continue;
+            }
+
+            if (stream->state.load() == Stream::State::Running)
+                printStats(*stream, true);
+
+            if (stream->processor != nullptr)
+            {
+
+                // Resetting or destroying the processor takes a while, keep it off the I/O thread
+                m_workers.addJob([this, stream]
+                                 { m_pool.release(stream->format, std::move(stream->processor)); });
+            }
+
+            close(stream->fd);
+            it = m_streams.erase(it);
+        }
+    }
+
+    /**
+     * @brief Reports the real-time factor, queue depth and latency of a stream.
+     *
+     * The latency is what a client experiences: the plugin latency plus the audio that waits in
+     * the server, in front of the model and behind it.
+     */
+    void printStats(Stream& stream, bool closed)
+    {
+        const auto& format     = stream.format;
+        auto        frameBytes = static_cast<double>(format.getBytesPerFrame());
+        auto        toMs       = [&format](double frames)
+        { return frames * 1000.0 / format.sampleRate; };
+
+        std::lock_guard<std::mutex> lock(stream.lock);
+
+        auto audioSeconds = static_cast<double>(stream.framesProcessed) / format.sampleRate;
+        auto rtf          = audioSeconds > 0.0 ? stream.processingSeconds / audioSeconds : 0.0;
+        auto queuedFrames = static_cast<double>(stream.input.size()) / frameBytes;
+        auto sendFrames   = static_cast<double>(stream.output.size()) / frameBytes;
+        auto latencyMs    = toMs(stream.latencySamples + queuedFrames + sendFrames);
+
+        std::cerr << "aic-server: stream " << stream.id << (closed ? " closed" : "") << ": "
+                  << juce::String(audioSeconds, 1) << " s audio, rtf "
+                  << juce::String(rtf, 3) << ", queue "
+                  << juce::String(queuedFrames / format.chunkFrames, 1) << " chunks (max "
+                  << juce::String(toMs(static_cast<double>(stream.maxQueuedBytes) / frameBytes), 0)
+                  << " ms), latency " << juce::String(latencyMs, 1) << " ms" << std::endl;
+    }
+
+    void wake()
+    {
+        // A full pipe already wakes the I/O thread
+        char byte = 0;
+        juce::ignoreUnused(write(m_wakePipe[1], &byte, 1));
+    }
+
+    void drainWakePipe()
+    {
+        char bytes[256];
+        while (read(m_wakePipe[0], bytes, sizeof(bytes)) > 0)
+        {
+        }
+    }
+
+    const Options m_options;
+    int           m_listenFd{-1};
+    int           m_wakePipe[2]{-1, -1};
+
+    // Declared before the workers, which use them until they are stopped
+    ProcessorPool                        m_pool;
+    std::vector<std::shared_ptr<Stream>> m_streams;
+    int                                  m_nextStreamId{1};
+
+    juce::ThreadPool m_workers;
+};
+
+void runServer(const juce::ArgumentList& args)
+{
+    auto options = parseOptions(args);
+
+    // Clients that vanish must not kill the server, their writes fail with EPIPE instead
+    std::signal(SIGPIPE, SIG_IGN);
+    std::signal(SIGINT, [](int) { stopRequested = 1; });
+    std::signal(SIGTERM, [](int) { stopRequested = 1; });
+
+    Server server(options);
+    server.run();
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::ConsoleApplication app;
+    app.addHelpCommand("--help|-h",
+                       "Usage: aic-server [options]\n"
+                       "Enhances many concurrent PCM streams of local clients.",
+                       true);
+
+    app.addDefaultCommand(
+        {"",
+         "[--socket=<path>] [--workers=<count>] [--max-queue-ms=<ms>] [--max-idle=<count>] "
+         "[--stats-interval=<seconds>] [--prewarm=<header>;...] [--backend=sdk|stub]",
+         "Serves streams over a Unix domain socket",
+         "A client sends one header line of key=value pairs, e.g. \"sample-rate=16000 "
+         "channels=1 format=s16 model=2 enhancement=0.8\", followed by interleaved little-endian "
+         "PCM. The server answers \"ok latency=<samples> chunk=<frames>\" or \"error <message>\" "
+         "and streams back the enhanced audio, not shifted by the latency. Closing the sending "
+         "side flushes the last chunk. Processors of finished streams are pooled for new streams "
+         "with the same model, band split and audio settings. The formats given by --prewarm, "
+         "separated by semicolons, are prepared at startup, the default format otherwise.",
+         runServer});
+
+    return app.findAndRunCommand(argc, argv);
+}
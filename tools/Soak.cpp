@@ -0,0 +1,955 @@
+#include "PluginProcessor.h"
+#include "ToolHelpers.h"
+#include "VadEvents.h"
+
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <vector>
+
+namespace
+{
+
+constexpr int    maxChannels     = 2;
+constexpr int    maxBlockSize    = 4096;
+constexpr double sineFrequency   = 997.0;
+constexpr float  sineAmplitude   = 0.25f;
+constexpr int    progressEveryMs = 10000;
+constexpr double cacheLoopSeconds = 0.5;
+constexpr int    cacheWriteMs     = 200;
+
+const std::array<double, 7> sampleRates{16000.0, 22050.0, 32000.0, 44100.0,
+                                        48000.0, 88200.0, 96000.0};
+const std::array<int, 9>    blockSizes{32, 64, 128, 256, 441, 480, 512, 1024, 2048};
+
+struct Options
+{
+    int    durationSeconds{60};
+    int    seed{1};
+    int    modelIndex{0};
+    bool   realtime{false};
+    int    settleMs{300};
+    double discontinuityThreshold{0.05};
+    double cacheSeamThresholdDb{-40.0};
+    double offlineSeamThresholdDb{-40.0};
+
+    aic::tools::BackendOptions backend;
+};
+
+Options parseOptions(const juce::ArgumentList& args)
+{
+    Options options;
+    options.durationSeconds = aic::tools::getIntOption(args, "--duration", 60);
+    options.seed            = aic::tools::getIntOption(args, "--seed", options.seed);
+    options.modelIndex      = aic::tools::getIntOption(args, "--model", options.modelIndex);
+    options.realtime        = args.containsOption("--realtime");
+    options.settleMs        = aic::tools::getIntOption(args, "--settle-ms", options.settleMs);
+    options.backend         = aic::tools::parseBackendOptions(args);
+
+    if (args.containsOption("--discontinuity-threshold"))
+        options.discontinuityThreshold =
+            args.getValueForOption("--discontinuity-threshold").getDoubleValue();
+
+    if (args.containsOption("--cache-seam-threshold"))
+        options.cacheSeamThresholdDb =
+            args.getValueForOption("--cache-seam-threshold").getDoubleValue();
+
+    if (args.containsOption("--offline-seam-threshold"))
+        options.offlineSeamThresholdDb =
+            args.getValueForOption("--offline-seam-threshold").getDoubleValue();
+
+    return options;
+}
+
+/**
+ * @brief Distribution of positive values in logarithmic buckets, 20 per decade.
+ *
+ * Fixed size, so hours of blocks can be recorded without allocating.
+ */
+class LogHistogram
+{
+  public:
+    explicit LogHistogram(double minValue) : m_minValue(minValue) {}
+
+    void add(double value)
+    {
+        auto bucket = value <= m_minValue
+                          ? 0
+                          : static_cast<int>(std::log10(value / m_minValue) * bucketsPerDecade);
+        ++m_counts[static_cast<size_t>(juce::jlimit(0, numBuckets - 1, bucket))];
+        ++m_total;
+        m_max = juce::jmax(m_max, value);
+    }
+
+    /**
+     * @return The upper bound of the bucket the percentile falls into
+     */
+    double getPercentile(double fraction) const
+    {
+        const auto target =
+            static_cast<juce::int64>(std::ceil(fraction * static_cast<double>(m_total)));
+
+        juce::int64 count = 0;
+        for (size_t bucket = 0; bucket < m_counts.size(); ++bucket)
+        {
+            count += m_counts[bucket];
+            if (count >= target && count > 0)
+                return juce::jmin(m_max, m_minValue * std::pow(10.0, (bucket + 1.0) /
+                                                                         bucketsPerDecade));
+        }
+
+        return m_max;
+    }
+
+    double getMax() const
+    {
+        return m_max;
+    }
+
+  private:
+    static constexpr int bucketsPerDecade = 20;
+    static constexpr int numBuckets       = 10 * bucketsPerDecade;
+
+    double                              m_minValue;
+    std::array<juce::int64, numBuckets> m_counts{};
+    juce::int64                         m_total{0};
+    double                              m_max{0.0};
+};
+
+/**
+ * @brief The audio settings of the host, changed by the control thread while the audio is paused.
+ */
+struct HostConfig
+{
+    double sampleRate{48000.0};
+    int    blockSize{480};
+    int    numChannels{2};
+};
+
+/**
+ * @brief Calls processBlock like the audio callback of a host and checks every output sample.
+ *
+ * Block sizes vary randomly between 0 and twice the prepared size. The input is a sine, a linear
+ * processor keeps it a sine with some gain and delay, so the residual of the sine recurrence
+ * y[n] - 2 cos(w) y[n-1] + y[n-2] is zero except where the output jumps.
+ */
+class AudioThread : public aic::tools::AudioThread
+{
+  public:
+    AudioThread(AicDemoAudioProcessor& processor, const Options& options, const HostConfig& config)
+        : aic::tools::AudioThread("aic-soak audio", processor, maxChannels, maxBlockSize,
+                                  options.realtime),
+          m_options(options),
+          m_config(config),
+          m_random(options.seed)
+    {
+        startStream();
+    }
+
+    ~AudioThread() override
+    {
+        stopThread(1000);
+    }
+
+    /**
+     * @brief Stops calling processBlock, returns when the current block is finished.
+     */
+    void pause()
+    {
+        m_pauseRequested.store(true);
+        while (!m_paused.load() && isThreadRunning())
+            juce::Thread::sleep(1);
+    }
+
+    /**
+     * @brief Continues with new host settings, the processor has been prepared for them.
+     */
+    void resume(const HostConfig& config)
+    {
+        m_config = config;
+        m_pauseRequested.store(false);
+        while (m_paused.load() && isThreadRunning())
+            juce::Thread::sleep(1);
+    }
+
+    void requestResets(int count)
+    {
+        m_resetsRequested.fetch_add(count);
+    }
+
+    /**
+     * @brief Repeats the input every loopSamples in blocks of the prepared size, 0 plays the sine.
+     *
+     * Every other pass changes its second half, so runs of render cache hits end in misses.
+     */
+    void setLooping(int loopSamples)
+    {
+        m_loopSamples.store(loopSamples);
+    }
+
+    /**
+     * @brief Enables the discontinuity check, only while nothing changes the processing.
+     */
+    void setCheckingContinuity(bool shouldCheck)
+    {
+        m_checkContinuity.store(shouldCheck);
+    }
+
+    juce::int64 getNumDeadlineMisses() const
+    {
+        return m_deadlineMisses.load();
+    }
+
+    juce::int64 getNumNonFinite() const
+    {
+        return m_nonFinite.load();
+    }
+
+    juce::int64 getNumDiscontinuities() const
+    {
+        return m_discontinuities.load();
+    }
+
+    juce::int64 getNumResets() const
+    {
+        return m_numResets.load();
+    }
+
+    /**
+     * @brief Time per block in microseconds, read after the thread has stopped.
+     */
+    const LogHistogram& getBlockMicros() const
+    {
+        return m_blockMicros;
+    }
+
+    /**
+     * @brief Time per block relative to its duration, read after the thread has stopped.
+     */
+    const LogHistogram& getBlockLoad() const
+    {
+        return m_blockLoad;
+    }
+
+  private:
+    bool beginBlock(juce::AudioBuffer<float>& buffer) override
+    {
+        if (m_pauseRequested.load())
+        {
+            m_paused.store(true);
+            while (m_pauseRequested.load() && !threadShouldExit())
+                juce::Thread::sleep(1);
+
+            startStream();
+            m_paused.store(false);
+            return false;
+        }
+
+        for (auto resets = m_resetsRequested.exchange(0); resets > 0; --resets)
+        {
+            m_processor.reset();
+            ++m_numResets;
+        }
+
+        auto loopSamples = m_loopSamples.load();
+        auto numSamples  = loopSamples > 0 ? m_config.blockSize : nextBlockSize();
+        buffer.setSize(m_config.numChannels, numSamples, false, false, true);
+
+        if (loopSamples > 0)
+            fillLoop(buffer, loopSamples);
+        else
+            fillSine(buffer);
+
+        return true;
+    }
+
+    void endBlock(const juce::AudioBuffer<float>& buffer, double seconds) override
+    {
+        recordTiming(seconds, buffer.getNumSamples());
+        checkOutput(buffer);
+    }
+
+    void startStream()
+    {
+        m_phase         = 0.0;
+        m_phaseDelta    = juce::MathConstants<double>::twoPi * sineFrequency / m_config.sampleRate;
+        m_recurrence    = static_cast<float>(2.0 * std::cos(m_phaseDelta));
+        m_historyLength = 0;
+    }
+
+    /**
+     * @brief Empty and single sample blocks, the prepared size and random sizes up to twice it.
+     */
+    int nextBlockSize()
+    {
+        auto choice = m_random.nextInt(100);
+        if (choice < 5)
+            return 0;
+        if (choice < 10)
+            return 1;
+        if (choice < 40)
+            return m_config.blockSize;
+        if (choice < 80)
+            return 1 + m_random.nextInt(m_config.blockSize);
+
+        return juce::jmin(maxBlockSize, 1 + m_random.nextInt(2 * m_config.blockSize));
+    }
+
+    void fillSine(juce::AudioBuffer<float>& buffer)
+    {
+        for (int i = 0; i < buffer.getNumSamples(); ++i)
+        {
+            auto sample = sineAmplitude * static_cast<float>(std::sin(m_phase));
+            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                buffer.setSample(ch, i, sample);
+
+            m_phase = std::fmod(m_phase + m_phaseDelta, juce::MathConstants<double>::twoPi);
+        }
+    }
+
+    void fillLoop(juce::AudioBuffer<float>& buffer, int loopSamples)
+    {
+        if (loopSamples != m_activeLoopSamples)
+        {
+            m_activeLoopSamples = loopSamples;
+            m_loopPosition      = 0;
+            m_loopPass          = 0;
+        }
+
+        for (int i = 0; i < buffer.getNumSamples(); ++i)
+        {
+            // A phase offset per pass, the changed halves are never in the cache
+            auto changed = m_loopPass % 2 == 1 && m_loopPosition >= loopSamples / 2;
+            auto phase   = m_phaseDelta * m_loopPosition + (changed ? 0.5 * m_loopPass : 0.0);
+            auto sample  = sineAmplitude * static_cast<float>(std::sin(phase));
+            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                buffer.setSample(ch, i, sample);
+
+            if (++m_loopPosition == loopSamples)
+            {
+                m_loopPosition = 0;
+                ++m_loopPass;
+            }
+        }
+    }
+
+    void recordTiming(double seconds, int numSamples)
+    {
+        m_blockMicros.add(seconds * 1.0e6);
+
+        if (numSamples == 0)
+            return;
+
+        auto load = seconds * m_config.sampleRate / numSamples;
+        m_blockLoad.add(load);
+
+        if (load > 1.0)
+            ++m_deadlineMisses;
+    }
+
+    void checkOutput(const juce::AudioBuffer<float>& buffer)
+    {
+        const auto checkContinuity = m_checkContinuity.load();
+        bool       foundNonFinite  = false;
+        bool       foundJump       = false;
+
+        for (int i = 0; i < buffer.getNumSamples(); ++i)
+        {
+            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            {
+                auto  sample  = buffer.getSample(ch, i);
+                auto& history = m_history[static_cast<size_t>(ch)];
+
+                if (!std::isfinite(sample))
+                {
+                    foundNonFinite = true;
+                    continue;
+                }
+
+                if (checkContinuity && m_historyLength >= 2)
+                {
+                    auto residual = sample - m_recurrence * history[0] + history[1];
+                    if (std::abs(residual) > m_options.discontinuityThreshold)
+                        foundJump = true;
+                }
+
+                history[1] = history[0];
+                history[0] = sample;
+            }
+
+            m_historyLength = juce::jmin(2, m_historyLength + 1);
+        }
+
+        // Counted per block, one glitch usually spans several samples
+        if (foundNonFinite)
+            ++m_nonFinite;
+
+        if (foundJump)
+            ++m_discontinuities;
+    }
+
+    const Options m_options;
+    HostConfig    m_config;
+    juce::Random  m_random;
+
+    double                                        m_phase{0.0};
+    double                                        m_phaseDelta{0.0};
+    float                                         m_recurrence{2.0f};
+    std::array<std::array<float, 2>, maxChannels> m_history{};
+    int                                           m_historyLength{0};
+
+    int m_activeLoopSamples{0};
+    int m_loopPosition{0};
+    int m_loopPass{0};
+
+    LogHistogram m_blockMicros{0.1};
+    LogHistogram m_blockLoad{1.0e-5};
+
+    std::atomic<bool>        m_pauseRequested{false};
+    std::atomic<bool>        m_paused{false};
+    std::atomic<int>         m_resetsRequested{0};
+    std::atomic<bool>        m_checkContinuity{false};
+    std::atomic<int>         m_loopSamples{0};
+    std::atomic<juce::int64> m_deadlineMisses{0};
+    std::atomic<juce::int64> m_nonFinite{0};
+    std::atomic<juce::int64> m_discontinuities{0};
+    std::atomic<juce::int64> m_numResets{0};
+};
+
+/**
+ * @brief Polls the processor like an open editor, as fast as it can.
+ */
+class EditorThread : public juce::Thread
+{
+  public:
+    explicit EditorThread(AicDemoAudioProcessor& processor)
+        : juce::Thread("aic-soak editor"), m_processor(processor)
+    {
+    }
+
+    ~EditorThread() override
+    {
+        stopThread(1000);
+    }
+
+    juce::int64 getNumPolls() const
+    {
+        return m_numPolls.load();
+    }
+
+  private:
+    void run() override
+    {
+        std::vector<aic::vad::Event> events;
+        events.reserve(1024);
+
+        while (!threadShouldExit())
+        {
+            auto modelInfo = m_processor.getModelInfo();
+            auto speech    = m_processor.isSpeechDetected();
+            auto levels    = m_processor.getMeterLevels();
+            auto position  = m_processor.getVadPosition();
+            juce::ignoreUnused(modelInfo, speech, levels, position);
+
+            if (m_processor.modelChanged())
+                m_processor.acknowledgeModelChanged();
+
+            events.clear();
+            m_processor.collectEditorVadEvents(events);
+            m_processor.getSpectrumAnalyzer().hasNewImage();
+
+            ++m_numPolls;
+            juce::Thread::yield();
+        }
+    }
+
+    AicDemoAudioProcessor&   m_processor;
+    std::atomic<juce::int64> m_numPolls{0};
+};
+
+/**
+ * @brief Drives the processor through random phases of host activity until the time is up.
+ */
+class Soak
+{
+  public:
+    explicit Soak(const Options& options)
+        : m_options(options),
+          m_processor(aic::tools::createBackend(options.backend)),
+          m_random(options.seed)
+    {
+    }
+
+    void run()
+    {
+        aic::tools::setModel(m_processor, m_options.modelIndex);
+        aic::tools::prepareProcessor(m_processor, m_config.sampleRate, m_config.blockSize);
+        m_processor.getSpectrumAnalyzer().setActive(true);
+
+        captureStates();
+        checkRenderCacheSeam();
+        checkOfflineSeam();
+
+        AudioThread  audio(m_processor, m_options, m_config);
+        EditorThread editor(m_processor);
+        audio.startThread(juce::Thread::Priority::highest);
+        editor.startThread();
+
+        const auto startMs    = juce::Time::getMillisecondCounter();
+        const auto durationMs = static_cast<juce::uint32>(m_options.durationSeconds) * 1000;
+        const auto endMs      = startMs + durationMs;
+        auto       progressMs = startMs + progressEveryMs;
+
+        while (juce::Time::getMillisecondCounter() < endMs)
+        {
+            runPhase(audio);
+
+            if (juce::Time::getMillisecondCounter() >= progressMs)
+            {
+                printCounters(audio, editor, juce::Time::getMillisecondCounter() - startMs);
+                progressMs += progressEveryMs;
+            }
+        }
+
+        audio.stopThread(1000);
+        editor.stopThread(1000);
+        m_processor.getSpectrumAnalyzer().setActive(false);
+
+        printSummary(audio, editor);
+
+        if (audio.getNumNonFinite() > 0 || audio.getNumDiscontinuities() > 0)
+            juce::ConsoleApplication::fail("Invalid output, see the summary above");
+
+        if (m_cacheSeamHits > 0 && m_cacheSeamDb > m_options.cacheSeamThresholdDb)
+            juce::ConsoleApplication::fail("The model is out of step after render cache hits, "
+                                           "see the summary above");
+
+        if (m_offlineSeamMeasured && (m_offlineSeamDb > m_options.offlineSeamThresholdDb ||
+                                      m_offlineVadMismatches > 0))
+            juce::ConsoleApplication::fail("The offline bounce differs from the realtime render, "
+                                           "see the summary above");
+    }
+
+  private:
+    enum class Phase
+    {
+        Steady,
+        ParameterStorm,
+        RestoreState,
+        ResetStorm,
+        CacheLoop,
+        Prepare
+    };
+
+    /**
+     * @brief Saves a few random states to restore during playback.
+     */
+    void captureStates()
+    {
+        juce::MemoryBlock initial;
+        m_processor.getStateInformation(initial);
+
+        for (int index = 0; index < 4; ++index)
+        {
+            randomizeParameters();
+
+            juce::MemoryBlock state;
+            m_processor.getStateInformation(state);
+            m_states.push_back(state);
+        }
+
+        m_processor.setStateInformation(initial.getData(), static_cast<int>(initial.getSize()));
+        m_states.push_back(initial);
+    }
+
+    /**
+     * @brief Checks that the model is back in step when a run of render cache hits ends.
+     *
+     * A tone is rendered twice with the cache, the second time it is served from the cache and
+     * followed by a second tone that misses. The misses are compared with an uncached render of
+     * the same input, they only match if the history the model is fed while the run of hits ends
+     * determines its state.
+     */
+    void checkRenderCacheSeam()
+    {
+        const auto blockSize = m_config.blockSize;
+        const auto runBlocks =
+            juce::roundToInt(cacheLoopSeconds * m_config.sampleRate / blockSize);
+
+        juce::AudioBuffer<float> buffer(m_config.numChannels, blockSize);
+        juce::MidiBuffer         midi;
+
+        auto render = [&](int numBlocks, std::vector<float>* output)
+        {
+            m_processor.reset();
+
+            for (int block = 0; block < numBlocks; ++block)
+            {
+                auto frequency = block < runBlocks ? sineFrequency : 0.5 * sineFrequency;
+                for (int i = 0; i < blockSize; ++i)
+                {
+                    auto position = static_cast<double>(block * blockSize + i);
+                    auto sample   = sineAmplitude * static_cast<float>(std::sin(
+                                      juce::MathConstants<double>::twoPi * frequency * position /
+                                      m_config.sampleRate));
+                    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                        buffer.setSample(ch, i, sample);
+                }
+
+                m_processor.processBlock(buffer, midi);
+
+                if (output != nullptr && block >= runBlocks)
+                    output->insert(output->end(), buffer.getReadPointer(0),
+                                   buffer.getReadPointer(0) + blockSize);
+
+                // The background thread writes the results and stages the hits a few blocks
+                // at a time
+                juce::Thread::sleep(1);
+            }
+        };
+
+        auto* parameter = m_processor.state.getRawParameterValue("rendercache");
+        auto  previous  = parameter->load();
+
+        std::vector<float> reference;
+        std::vector<float> cached;
+
+        aic::tools::setParameter(m_processor, "rendercache", 0.0f);
+        render(2 * runBlocks, &reference);
+
+        // The cache file is opened in the background once the cache is enabled
+        aic::tools::setParameter(m_processor, "rendercache", 1.0f);
+        render(1, nullptr);
+        juce::Thread::sleep(cacheWriteMs);
+        render(runBlocks, nullptr);
+        juce::Thread::sleep(cacheWriteMs);
+
+        auto hits = m_processor.getRenderCache().getNumHits();
+        render(2 * runBlocks, &cached);
+        m_cacheSeamHits = m_processor.getRenderCache().getNumHits() - hits;
+
+        aic::tools::setParameter(m_processor, "rendercache", previous);
+
+        auto maxDifference = 0.0f;
+        for (size_t i = 0; i < reference.size(); ++i)
+            maxDifference = juce::jmax(maxDifference, std::abs(cached[i] - reference[i]));
+
+        m_cacheSeamDb = juce::Decibels::gainToDecibels(maxDifference / sineAmplitude, -200.0f);
+    }
+
+    /**
+     * @brief Checks that an offline bounce matches the realtime render of the same input.
+     *
+     * The offline renderer renders the segments of a chunk in parallel, each lane with a model
+     * primed with the input before its segment. A tone whose enhancement steps down halfway is
+     * rendered in both modes over two chunks and compared after the latency of each. The output
+     * only matches if the segments join seamlessly and the step applies to the same samples, the
+     * VAD changes only if they are reported for the same audio.
+     */
+    void checkOfflineSeam()
+    {
+        const auto blockSize = m_config.blockSize;
+
+        juce::AudioBuffer<float> buffer(m_config.numChannels, blockSize);
+        juce::MidiBuffer         midi;
+
+        auto render = [&](int numSamples, std::vector<float>& output,
+                          std::vector<aic::vad::Event>& vadEvents)
+        {
+            m_processor.reset();
+
+            const auto latency = m_processor.getLatencySamples();
+            output.assign(static_cast<size_t>(numSamples), 0.0f);
+            vadEvents.clear();
+
+            for (int position = 0; position < numSamples + latency; position += blockSize)
+            {
+                aic::tools::setParameter(m_processor, "enhancement",
+                                         position < numSamples / 2 ? 1.0f : 0.5f);
+
+                for (int i = 0; i < blockSize; ++i)
+                {
+                    auto sample = position + i < numSamples
+                                      ? sineAmplitude *
+                                            static_cast<float>(std::sin(
+                                                juce::MathConstants<double>::twoPi *
+                                                sineFrequency * (position + i) /
+                                                m_config.sampleRate))
+                                      : 0.0f;
+                    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                        buffer.setSample(ch, i, sample);
+                }
+
+                m_processor.processBlock(buffer, midi);
+                m_processor.collectVadEvents(vadEvents);
+
+                for (int i = 0; i < blockSize; ++i)
+                {
+                    auto aligned = position + i - latency;
+                    if (juce::isPositiveAndBelow(aligned, numSamples))
+                        output[static_cast<size_t>(aligned)] = buffer.getSample(0, i);
+                }
+            }
+        };
+
+        auto* parameter = m_processor.state.getRawParameterValue("enhancement");
+        auto  previous  = parameter->load();
+
+        // The lanes are only built when the host renders offline while preparing
+        m_processor.setNonRealtime(true);
+        m_processor.setCollectingVadEvents(true);
+        aic::tools::prepareProcessor(m_processor, m_config.sampleRate, blockSize);
+        m_offlineSeamMeasured = m_processor.isRenderingOffline();
+
+        if (m_offlineSeamMeasured)
+        {
+            // Two chunks, so the seams between the lanes and between the chunks are covered
+            const auto numSamples = 2 * m_processor.getLatencySamples();
+
+            std::vector<float>           offline;
+            std::vector<float>           reference;
+            std::vector<aic::vad::Event> offlineEvents;
+            std::vector<aic::vad::Event> referenceEvents;
+            render(numSamples, offline, offlineEvents);
+
+            // Switched per block, without preparing again
+            m_processor.setNonRealtime(false);
+            render(numSamples, reference, referenceEvents);
+
+            auto maxDifference = 0.0f;
+            for (size_t i = 0; i < reference.size(); ++i)
+                maxDifference = juce::jmax(maxDifference, std::abs(offline[i] - reference[i]));
+
+            m_offlineSeamDb =
+                juce::Decibels::gainToDecibels(maxDifference / sineAmplitude, -200.0f);
+
+            // The lanes split the model blocks differently, the VAD may decide a block apart
+            const auto tolerance = 2 * blockSize;
+            m_offlineVadMismatches =
+                static_cast<int>(std::abs(static_cast<std::ptrdiff_t>(offlineEvents.size()) -
+                                          static_cast<std::ptrdiff_t>(referenceEvents.size())));
+            for (size_t i = 0; i < juce::jmin(offlineEvents.size(), referenceEvents.size()); ++i)
+                if (offlineEvents[i].speech != referenceEvents[i].speech ||
+                    std::abs(offlineEvents[i].samplePosition - referenceEvents[i].samplePosition) >
+                        tolerance)
+                    ++m_offlineVadMismatches;
+        }
+
+        // Back to the regular path for the soak, which does not collect the VAD changes
+        m_processor.setCollectingVadEvents(false);
+        m_processor.setNonRealtime(false);
+        aic::tools::setParameter(m_processor, "enhancement", previous);
+        aic::tools::prepareProcessor(m_processor, m_config.sampleRate, blockSize);
+    }
+
+    void randomizeParameters()
+    {
+        for (auto* parameter : m_processor.getParameters())
+        {
+            auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter);
+            if (ranged != nullptr && ranged->paramID != "vad_state")
+                ranged->setValueNotifyingHost(m_random.nextFloat());
+        }
+    }
+
+    void runPhase(AudioThread& audio)
+    {
+        auto choice = m_random.nextInt(100);
+        auto phase  = choice < 30   ? Phase::Steady
+                      : choice < 55 ? Phase::ParameterStorm
+                      : choice < 70 ? Phase::RestoreState
+                      : choice < 85 ? Phase::ResetStorm
+                      : choice < 92 ? Phase::CacheLoop
+                                    : Phase::Prepare;
+
+        switch (phase)
+        {
+        case Phase::Steady:
+        {
+            // Models, latency and the VAD settle before the output has to be continuous
+            juce::Thread::sleep(m_options.settleMs);
+            audio.setCheckingContinuity(true);
+            juce::Thread::sleep(200 + m_random.nextInt(800));
+            audio.setCheckingContinuity(false);
+            break;
+        }
+        case Phase::ParameterStorm:
+        {
+            const auto parameters = m_processor.getParameters();
+            const auto endMs = juce::Time::getMillisecondCounter() + 100 + m_random.nextInt(400);
+
+            while (juce::Time::getMillisecondCounter() < endMs)
+            {
+                auto* parameter = parameters[m_random.nextInt(parameters.size())];
+                auto* ranged    = dynamic_cast<juce::RangedAudioParameter*>(parameter);
+                if (ranged != nullptr && ranged->paramID != "vad_state")
+                    ranged->setValueNotifyingHost(m_random.nextFloat());
+
+                juce::Thread::sleep(m_random.nextInt(3));
+            }
+            break;
+        }
+        case Phase::RestoreState:
+        {
+            for (int count = 1 + m_random.nextInt(10); --count >= 0;)
+            {
+                const auto& state = m_states[static_cast<size_t>(
+                    m_random.nextInt(static_cast<int>(m_states.size())))];
+                m_processor.setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+                juce::Thread::sleep(m_random.nextInt(20));
+            }
+            break;
+        }
+        case Phase::ResetStorm:
+        {
+            for (int count = 1 + m_random.nextInt(5); --count >= 0;)
+            {
+                audio.requestResets(1 + m_random.nextInt(100));
+                juce::Thread::sleep(m_random.nextInt(10));
+            }
+            break;
+        }
+        case Phase::CacheLoop:
+        {
+            // Catching up at the end of a run of hits must not cost a deadline
+            auto* parameter = m_processor.state.getRawParameterValue("rendercache");
+            auto  previous  = parameter->load();
+            auto  blocks    = juce::jmax(
+                1, juce::roundToInt(cacheLoopSeconds * m_config.sampleRate / m_config.blockSize));
+
+            aic::tools::setParameter(m_processor, "rendercache", 1.0f);
+            audio.setLooping(blocks * m_config.blockSize);
+            juce::Thread::sleep(2000 + m_random.nextInt(2000));
+            audio.setLooping(0);
+            aic::tools::setParameter(m_processor, "rendercache", previous);
+            break;
+        }
+        case Phase::Prepare:
+        {
+            // Hosts stop the audio, change the layout and prepare again
+            audio.pause();
+
+            HostConfig config;
+            config.sampleRate  = sampleRates[static_cast<size_t>(
+                m_random.nextInt(static_cast<int>(sampleRates.size())))];
+            config.blockSize   = blockSizes[static_cast<size_t>(
+                m_random.nextInt(static_cast<int>(blockSizes.size())))];
+            config.numChannels = 1 + m_random.nextInt(maxChannels);
+
+            m_processor.releaseResources();
+            if (!aic::tools::setNumChannels(m_processor, config.numChannels))
+                config.numChannels = m_processor.getTotalNumInputChannels();
+
+            m_processor.setRateAndBufferSizeDetails(config.sampleRate, config.blockSize);
+            m_processor.prepareToPlay(config.sampleRate, config.blockSize);
+
+            m_config = config;
+            audio.resume(config);
+            ++m_numPrepares;
+            break;
+        }
+        }
+    }
+
+    void printCounters(const AudioThread& audio, const EditorThread& editor,
+                       juce::uint32 elapsedMs) const
+    {
+        std::cerr << juce::String(elapsedMs / 1000) << " s: " << audio.getNumBlocks()
+                  << " blocks, " << audio.getNumDeadlineMisses() << " deadline misses, "
+                  << audio.getNumNonFinite() << " NaN/Inf, " << audio.getNumDiscontinuities()
+                  << " discontinuities, " << editor.getNumPolls() << " editor polls"
+                  << std::endl;
+    }
+
+    void printSummary(const AudioThread& audio, const EditorThread& editor) const
+    {
+        const auto& micros = audio.getBlockMicros();
+        const auto& load   = audio.getBlockLoad();
+
+        std::cout << audio.getNumBlocks() << " blocks, " << m_numPrepares << " prepares, "
+                  << audio.getNumResets() << " resets, " << editor.getNumPolls()
+                  << " editor polls" << std::endl
+                  << std::endl
+                  << "time per block in microseconds" << std::endl
+                  << "  median " << juce::String(micros.getPercentile(0.5), 1) << ", p99 "
+                  << juce::String(micros.getPercentile(0.99), 1) << ", p99.9 "
+                  << juce::String(micros.getPercentile(0.999), 1) << ", max "
+                  << juce::String(micros.getMax(), 1) << std::endl
+                  << "time per block in % of its duration" << std::endl
+                  << "  median " << juce::String(100.0 * load.getPercentile(0.5), 2) << ", p99 "
+                  << juce::String(100.0 * load.getPercentile(0.99), 2) << ", p99.9 "
+                  << juce::String(100.0 * load.getPercentile(0.999), 2) << ", max "
+                  << juce::String(100.0 * load.getMax(), 2) << std::endl
+                  << std::endl
+                  << "deadline misses     " << audio.getNumDeadlineMisses() << std::endl
+                  << "blocks with NaN/Inf " << audio.getNumNonFinite() << std::endl
+                  << "discontinuities     " << audio.getNumDiscontinuities() << std::endl;
+
+        if (m_cacheSeamHits > 0)
+            std::cout << "render cache seam   " << juce::String(m_cacheSeamDb, 1) << " dB after "
+                      << m_cacheSeamHits << " hits" << std::endl;
+        else
+            std::cout << "render cache seam   not measured, no cache hits" << std::endl;
+
+        if (m_offlineSeamMeasured)
+            std::cout << "offline seam        " << juce::String(m_offlineSeamDb, 1) << " dB, "
+                      << m_offlineVadMismatches << " VAD changes differ" << std::endl;
+        else
+            std::cout << "offline seam        not measured, no offline lanes" << std::endl;
+    }
+
+    const Options         m_options;
+    AicDemoAudioProcessor m_processor;
+    juce::Random          m_random;
+    HostConfig            m_config;
+
+    std::vector<juce::MemoryBlock> m_states;
+    int                            m_numPrepares{0};
+
+    juce::int64 m_cacheSeamHits{0};
+    float       m_cacheSeamDb{-200.0f};
+
+    bool  m_offlineSeamMeasured{false};
+    float m_offlineSeamDb{-200.0f};
+    int   m_offlineVadMismatches{0};
+};
+
+void runSoak(const juce::ArgumentList& args)
+{
+    auto options = parseOptions(args);
+
+    auto models = AicDemoAudioProcessor::getModelChoices();
+    if (!juce::isPositiveAndBelow(options.modelIndex, models.size()))
+        juce::ConsoleApplication::fail("Invalid model index, available models: " +
+                                       models.joinIntoString(", "));
+
+    std::cout << "soak for " << options.durationSeconds << " s, seed " << options.seed
+              << (options.realtime ? ", paced in real time" : "") << std::endl;
+
+    Soak soak(options);
+    soak.run();
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::ConsoleApplication app;
+    app.addHelpCommand("--help|-h",
+                       "Usage: aic-soak [--duration=<seconds>] [--seed=<n>] [--model=<index>] "
+                       "[--realtime] [--settle-ms=<ms>] [--discontinuity-threshold=<value>] "
+                       "[--cache-seam-threshold=<dB>] [--offline-seam-threshold=<dB>] "
+                       "[--backend=stub]\n"
+                       "Drives the processor like a host with random block sizes, audio settings, "
+                       "resets, parameter and state changes, see DEVELOPMENT.md",
+                       true);
+    app.addDefaultCommand({"", "", "", "", runSoak});
+
+    return app.findAndRunCommand(argc, argv);
+}
@@ -0,0 +1,299 @@
+#pragma once
+
+#include "PluginProcessor.h"
+#include "StubBackend.h"
+
+#include <atomic>
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_core/juce_core.h>
+
+namespace aic::tools
+{
+
+/**
+ * @brief Selects the model by its index in the model list.
+ */
+inline void setModel(AicDemoAudioProcessor& processor, int modelIndex)
+{
+    auto* parameter = processor.state.getParameter("model");
+    parameter->setValueNotifyingHost(parameter->convertTo0to1(static_cast<float>(modelIndex)));
+}
+
+/**
+ * @brief Switches the processor to a mono or stereo layout.
+ *
+ * @return false if the number of channels is not supported
+ */
+inline bool setNumChannels(AicDemoAudioProcessor& processor, int numChannels)
+{
+    juce::AudioProcessor::BusesLayout layout;
+    layout.inputBuses.add(juce::AudioChannelSet::canonicalChannelSet(numChannels));
+    layout.outputBuses.add(juce::AudioChannelSet::canonicalChannelSet(numChannels));
+    return processor.setBusesLayout(layout);
+}
+
+/**
+ * @brief Sets a plugin parameter by its id, in the units of the parameter.
+ *
+ * @return false if there is no such parameter
+ */
+inline bool setParameter(AicDemoAudioProcessor& processor, const juce::String& parameterID,
+                         float value)
+{
+    auto* parameter = processor.state.getParameter(parameterID);
+    if (parameter == nullptr)
+        return false;
+
+    parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+    return true;
+}
+
+/**
+ * @brief Sets every plugin parameter given as --<parameter id>=<value>, e.g. --enhancement=0.8.
+ *
+ * Values are in the units of the parameter, choices are given by their index.
+ */
+inline void applyParameterOptions(AicDemoAudioProcessor& processor, const juce::ArgumentList& args)
+{
+    for (auto* parameter : processor.getParameters())
+    {
+        auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter);
+        if (ranged != nullptr && args.containsOption("--" + ranged->paramID))
+            setParameter(processor, ranged->paramID,
+                         args.getValueForOption("--" + ranged->paramID).getFloatValue());
+    }
+}
+
+/**
+ * @brief Prepares the processor like a host would and waits until the model is published.
+ *
+ * @return An error message, empty on success
+ */
+inline juce::String tryPrepareProcessor(AicDemoAudioProcessor& processor, double sampleRate,
+                                        int blockSize)
+{
+    if (!processor.isLicenseValid())
+        return "No valid license key found at " + processor.getExpectedLicensePath();
+
+    processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+    processor.prepareToPlay(sampleRate, blockSize);
+
+    const auto timeout = juce::Time::getMillisecondCounter() + 60000;
+    while (!processor.isModelReady())
+    {
+        // The stored key is only checked when the loader creates the model with it
+        if (!processor.isLicenseValid())
+            return "The license key at " + processor.getExpectedLicensePath() + " is not valid";
+
+        if (juce::Time::getMillisecondCounter() > timeout)
+            return "The model did not get ready in time";
+
+        juce::Thread::sleep(1);
+    }
+
+    return {};
+}
+
+/**
+ * @brief Prepares the processor, failing the console application on errors.
+ */
+inline void prepareProcessor(AicDemoAudioProcessor& processor, double sampleRate, int blockSize)
+{
+    auto error = tryPrepareProcessor(processor, sampleRate, blockSize);
+    if (error.isNotEmpty())
+        juce::ConsoleApplication::fail(error);
+}
+
+/**
+ * @brief Reads an integer option in the form --name=value.
+ */
+inline int getIntOption(const juce::ArgumentList& args, const juce::String& option,
+                        int defaultValue)
+{
+    return args.containsOption(option) ? args.getValueForOption(option).getIntValue()
+                                       : defaultValue;
+}
+
+/**
+ * @brief The backend the processors of a tool run, the SDK by default.
+ */
+struct BackendOptions
+{
+    bool                       stub{false};
+    aic::StubBackend::Settings stubSettings;
+};
+
+/**
+ * @brief Reads --backend=sdk|stub and the settings of the stub, --stub-latency-ms=<ms>,
+ * --stub-load=<share of real time> and --stub-vad=off|energy|alternating.
+ */
+inline BackendOptions parseBackendOptions(const juce::ArgumentList& args)
+{
+    BackendOptions options;
+    options.stub =
+        args.containsOption("--backend") && args.getValueForOption("--backend") == "stub";
+
+    auto& settings = options.stubSettings;
+    if (args.containsOption("--stub-latency-ms"))
+        settings.latencyMs = args.getValueForOption("--stub-latency-ms").getDoubleValue();
+
+    if (args.containsOption("--stub-load"))
+        settings.computeLoad = args.getValueForOption("--stub-load").getDoubleValue();
+
+    if (args.containsOption("--stub-vad"))
+    {
+        auto mode = args.getValueForOption("--stub-vad");
+        if (mode == "off")
+            settings.vadMode = aic::StubBackend::VadMode::Off;
+        else if (mode == "alternating")
+            settings.vadMode = aic::StubBackend::VadMode::Alternating;
+        else if (mode == "energy")
+            settings.vadMode = aic::StubBackend::VadMode::Energy;
+        else
+            juce::ConsoleApplication::fail("Unknown stub VAD mode: " + mode);
+    }
+
+    return options;
+}
+
+/**
+ * @brief The options as arguments, for tools that run measurements in child processes.
+ */
+inline juce::StringArray toArguments(const BackendOptions& options)
+{
+    juce::StringArray arguments;
+    if (!options.stub)
+        return arguments;
+
+    const auto& settings = options.stubSettings;
+    arguments.add("--backend=stub");
+    if (settings.latencyMs.has_value())
+        arguments.add("--stub-latency-ms=" + juce::String(*settings.latencyMs));
+    arguments.add("--stub-load=" + juce::String(settings.computeLoad));
+
+    switch (settings.vadMode)
+    {
+    case aic::StubBackend::VadMode::Off:
+        arguments.add("--stub-vad=off");
+        break;
+    case aic::StubBackend::VadMode::Energy:
+        arguments.add("--stub-vad=energy");
+        break;
+    case aic::StubBackend::VadMode::Alternating:
+        arguments.add("--stub-vad=alternating");
+        break;
+    }
+
+    return arguments;
+}
+
+inline std::unique_ptr<aic::EnhancementBackend> createBackend(const BackendOptions& options)
+{
+    if (options.stub)
+        return std::make_unique<aic::StubBackend>(options.stubSettings);
+
+    // The SDK, unless the AIC_BACKEND environment variable selects the stub
+    return aic::createDefaultBackend();
+}
+
+/**
+ * @brief Calls processBlock on its own thread, like the audio callback of a host.
+ *
+ * Subclasses fill the input of every block and check its output. Blocks may have any size up to
+ * the maximum, they are paced in real time at the sample rate the processor was prepared with if
+ * the thread is paced, and follow each other right away otherwise. Subclasses stop the thread in
+ * their destructor, before their part is destroyed.
+ */
+class AudioThread : public juce::Thread
+{
+  public:
+    AudioThread(const juce::String& threadName, AicDemoAudioProcessor& processor, int maxChannels,
+                int maxBlockSize, bool paced)
+        : juce::Thread(threadName),
+          m_processor(processor),
+          m_maxChannels(maxChannels),
+          m_maxBlockSize(maxBlockSize),
+          m_paced(paced)
+    {
+    }
+
+    juce::int64 getNumBlocks() const
+    {
+        return m_numBlocks.load();
+    }
+
+    /**
+     * @brief Waits until the given number of blocks has been processed.
+     */
+    void waitForBlocks(int numBlocks) const
+    {
+        const auto target = getNumBlocks() + numBlocks;
+        while (getNumBlocks() < target && isThreadRunning())
+            juce::Thread::sleep(1);
+    }
+
+  protected:
+    /**
+     * @brief Sets the size of the block and fills its input, on the audio thread.
+     *
+     * The buffer keeps its size from the previous block unless it is changed, without reallocating
+     * up to the maximum.
+     *
+     * @return false to skip the block, the pacing starts over with the next one
+     */
+    virtual bool beginBlock(juce::AudioBuffer<float>& buffer) = 0;
+
+    /**
+     * @brief Checks the output of the block, on the audio thread.
+     *
+     * @param seconds The time processBlock took
+     */
+    virtual void endBlock(const juce::AudioBuffer<float>& buffer, double seconds)
+    {
+        juce::ignoreUnused(buffer, seconds);
+    }
+
+    AicDemoAudioProcessor& m_processor;
+
+  private:
+    void run() override
+    {
+        // Everything the loop needs is allocated up front, like in a host
+        juce::AudioBuffer<float> buffer(m_maxChannels, m_maxBlockSize);
+        juce::MidiBuffer         midi;
+
+        auto nextMs = juce::Time::getMillisecondCounterHiRes();
+
+        while (!threadShouldExit())
+        {
+            if (!beginBlock(buffer))
+            {
+                nextMs = juce::Time::getMillisecondCounterHiRes();
+                continue;
+            }
+
+            auto start = juce::Time::getHighResolutionTicks();
+            m_processor.processBlock(buffer, midi);
+            auto end = juce::Time::getHighResolutionTicks();
+
+            endBlock(buffer, juce::Time::highResolutionTicksToSeconds(end - start));
+            ++m_numBlocks;
+
+            // Paced like an audio device, so the background threads of the plugin run alongside
+            if (m_paced)
+            {
+                nextMs += 1000.0 * buffer.getNumSamples() / m_processor.getSampleRate();
+                auto waitMs = nextMs - juce::Time::getMillisecondCounterHiRes();
+                if (waitMs >= 1.0)
+                    juce::Thread::sleep(static_cast<int>(waitMs));
+            }
+        }
+    }
+
+    const int                m_maxChannels;
+    const int                m_maxBlockSize;
+    const bool               m_paced;
+    std::atomic<juce::int64> m_numBlocks{0};
+};
+
+} // namespace aic::tools